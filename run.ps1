@@ -7,7 +7,9 @@ param(
     [switch]$CSV,
     [string]$Output = "",
     [switch]$Help,
-    [switch]$Force
+    [switch]$Force,
+    [switch]$Perf,
+    [string]$Baseline = "perf\baseline.json"
 )
 
 Write-Host "🚀 NSE MTBT Decoder - Build & Run" -ForegroundColor Green
@@ -43,7 +45,7 @@ if ($needsBuild) {
     }
     
     # Build the project
-    $buildCommand = "g++ -std=c++17 -Wall -Wextra -O2 -I src src/main.cpp src/MessageTypes.cpp src/Decoder.cpp src/FeedSimulator.cpp src/Utils.cpp -o build/NSE_MTBT_Decoder"
+    $buildCommand = "g++ -std=c++17 -Wall -Wextra -O2 -pthread -I src src/main.cpp src/MessageTypes.cpp src/Decoder.cpp src/FeedSimulator.cpp src/Utils.cpp src/Checkpoint.cpp src/CaptureFile.cpp src/CaptureIndex.cpp src/MergeReplay.cpp src/StreamDemux.cpp src/AsyncReader.cpp src/TraceLogger.cpp src/EventTracer.cpp src/ShardDispatcher.cpp src/SubscriptionFilter.cpp src/InstrumentLimits.cpp src/ArenaResource.cpp src/StatsExport.cpp src/TradeRing.cpp src/TcpPublisher.cpp src/TcpSubscriber.cpp src/Benchmarks.cpp src/BarAggregator.cpp src/IndexEngine.cpp src/TradeHistory.cpp src/QuantileSketch.cpp src/Conflator.cpp src/PerfHarness.cpp -o build/NSE_MTBT_Decoder"
     
     Write-Host "Command: $buildCommand" -ForegroundColor Gray
     Invoke-Expression $buildCommand
@@ -58,6 +60,17 @@ if ($needsBuild) {
     Write-Host "✅ Executable is up to date, skipping build." -ForegroundColor Green
 }
 
+# Perf harness: fixed-seed scenarios compared against the stored baseline
+if ($Perf) {
+    Write-Host "📏 Running performance harness..." -ForegroundColor Yellow
+    & ".\build\NSE_MTBT_Decoder.exe" --perf perf_results.json --perf-baseline $Baseline
+    if ($LASTEXITCODE -eq 2) {
+        Write-Host "❌ Performance regression against $Baseline" -ForegroundColor Red
+        exit 2
+    }
+    exit $LASTEXITCODE
+}
+
 # Build command arguments
 $args = @("--count", $Count)
 if ($Debug) { $args += "--debug" }
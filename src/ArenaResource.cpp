@@ -0,0 +1,104 @@
+#include "ArenaResource.h"
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr std::size_t HUGE_PAGE_SIZE = 2u << 20;
+constexpr std::size_t ARENA_ALIGNMENT = 64;
+
+std::size_t roundUp(std::size_t value, std::size_t multiple) noexcept {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+ArenaResource::ArenaResource(Config config, std::pmr::memory_resource* upstream)
+    : config_{config}, upstream_{upstream} {
+#if defined(__linux__)
+    const int populate = config_.prefault ? MAP_POPULATE : 0;
+    if (config_.hugePages) {
+        mappedBytes_ = roundUp(config_.capacityBytes, HUGE_PAGE_SIZE);
+        void* region = ::mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        if (region != MAP_FAILED) {
+            base_ = static_cast<std::uint8_t*>(region);
+            stats_.hugePagesActive = true;
+        }
+    }
+    if (!base_) {
+        // No reserved huge pages: plain mapping, asking for THP before it is populated
+        mappedBytes_ = roundUp(config_.capacityBytes, static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+        void* region = ::mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+        base_ = static_cast<std::uint8_t*>(region);
+        if (config_.hugePages) {
+            ::madvise(base_, mappedBytes_, MADV_HUGEPAGE);
+        }
+        if (config_.prefault) {
+            ::madvise(base_, mappedBytes_, MADV_WILLNEED);
+            std::memset(base_, 0, mappedBytes_);
+        }
+    }
+    mapped_ = true;
+#else
+    mappedBytes_ = roundUp(config_.capacityBytes, ARENA_ALIGNMENT);
+    base_ = static_cast<std::uint8_t*>(::operator new(mappedBytes_, std::align_val_t{ARENA_ALIGNMENT}));
+    if (config_.prefault) {
+        std::memset(base_, 0, mappedBytes_);
+    }
+#endif
+    stats_.capacityBytes = mappedBytes_;
+}
+
+ArenaResource::~ArenaResource() {
+#if defined(__linux__)
+    if (mapped_) {
+        ::munmap(base_, mappedBytes_);
+    }
+#else
+    ::operator delete(base_, std::align_val_t{ARENA_ALIGNMENT});
+#endif
+}
+
+void ArenaResource::reset() noexcept {
+    stats_.bytesUsed = 0;
+    ++stats_.resets;
+}
+
+void* ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    const std::size_t start = roundUp(stats_.bytesUsed, alignment);
+    if (start + bytes > stats_.capacityBytes) {
+        ++stats_.upstreamAllocations;
+        return upstream_->allocate(bytes, alignment);
+    }
+    
+    stats_.bytesUsed = start + bytes;
+    if (stats_.bytesUsed > stats_.peakBytesUsed) {
+        stats_.peakBytesUsed = stats_.bytesUsed;
+    }
+    ++stats_.allocations;
+    return base_ + start;
+}
+
+void ArenaResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+    // Arena memory is reclaimed wholesale by reset()
+    if (!owns(pointer)) {
+        upstream_->deallocate(pointer, bytes, alignment);
+    }
+}
+
+bool ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace nse::mtbt
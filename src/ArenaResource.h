@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace nse::mtbt {
+
+/**
+ * Monotonic arena over one pre-faulted region, usable as a std::pmr resource
+ *
+ * The region is mapped up front (optionally with 2 MB huge pages on Linux)
+ * and touched so the decode loop never takes a page fault or calls malloc.
+ * Deallocation is a no-op; reset() rewinds the whole arena. Requests that
+ * do not fit fall back to the upstream resource and are counted.
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    /**
+     * Arena configuration
+     */
+    struct Config {
+        std::size_t capacityBytes{64u << 20};
+        bool hugePages{false};   // MAP_HUGETLB, falling back to transparent huge pages
+        bool prefault{true};     // Touch every page at construction
+        
+        Config() = default;
+    };
+
+    /**
+     * Allocator statistics
+     */
+    struct Stats {
+        std::size_t capacityBytes{0};
+        std::size_t bytesUsed{0};
+        std::size_t peakBytesUsed{0};
+        std::uint64_t allocations{0};
+        std::uint64_t upstreamAllocations{0}; // Requests the arena could not satisfy
+        std::uint64_t resets{0};
+        bool hugePagesActive{false};          // Explicit MAP_HUGETLB mapping succeeded
+    };
+
+    ArenaResource() : ArenaResource(Config{}) {}
+
+    explicit ArenaResource(Config config, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+    ~ArenaResource() override;
+
+    /**
+     * Rewind the arena; every outstanding arena allocation becomes invalid
+     */
+    void reset() noexcept;
+
+    [[nodiscard]] const Stats& getStats() const noexcept { return stats_; }
+
+private:
+    Config config_;
+    std::pmr::memory_resource* upstream_;
+    std::uint8_t* base_{nullptr};
+    std::size_t mappedBytes_{0};
+    bool mapped_{false};
+    Stats stats_{};
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    [[nodiscard]] bool owns(const void* pointer) const noexcept {
+        const auto* bytePointer = static_cast<const std::uint8_t*>(pointer);
+        return bytePointer >= base_ && bytePointer < base_ + stats_.capacityBytes;
+    }
+};
+
+} // namespace nse::mtbt
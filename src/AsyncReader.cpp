@@ -0,0 +1,430 @@
+#include "AsyncReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define MTBT_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace nse::mtbt {
+
+/**
+ * One input file and its in-order delivery state
+ */
+struct AsyncReader::Input {
+    std::string path;
+    int fd{-1};             // O_DIRECT where the filesystem allows it
+    int bufferedFd{-1};     // Page-cache descriptor for unaligned fix-up reads
+    std::uint64_t size{0};
+    std::uint64_t submitOffset{0};
+    std::uint64_t deliverOffset{0};
+    std::map<std::uint64_t, std::pair<std::uint32_t, std::size_t>> completed; // offset -> (buffer, bytes)
+};
+
+#if defined(MTBT_HAVE_IO_URING)
+
+/**
+ * Raw io_uring: no liburing dependency, just the three syscalls and the ring mappings
+ */
+struct AsyncReader::Ring {
+    int fd{-1};
+    void* sqMapping{nullptr};
+    std::size_t sqMappingSize{0};
+    void* cqMapping{nullptr};
+    std::size_t cqMappingSize{0};
+    io_uring_sqe* sqes{nullptr};
+    std::size_t sqesSize{0};
+
+    unsigned* sqTail{nullptr};
+    unsigned* sqMask{nullptr};
+    unsigned* sqArray{nullptr};
+    unsigned* cqHead{nullptr};
+    unsigned* cqTail{nullptr};
+    unsigned* cqMask{nullptr};
+    io_uring_cqe* cqes{nullptr};
+    bool fixedBuffers{false};
+    std::vector<iovec> iovecs;   // One per buffer, also used by READV when not registered
+
+    ~Ring() {
+        if (sqes != nullptr) {
+            ::munmap(sqes, sqesSize);
+        }
+        if (cqMapping != nullptr && cqMapping != sqMapping) {
+            ::munmap(cqMapping, cqMappingSize);
+        }
+        if (sqMapping != nullptr) {
+            ::munmap(sqMapping, sqMappingSize);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    [[nodiscard]] bool setup(unsigned entries) {
+        io_uring_params params{};
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false; // ENOSYS on old kernels, EPERM under seccomp
+        }
+
+        sqMappingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqMappingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMapping) {
+            sqMappingSize = cqMappingSize = std::max(sqMappingSize, cqMappingSize);
+        }
+
+        sqMapping = ::mmap(nullptr, sqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqMapping == MAP_FAILED) {
+            sqMapping = nullptr;
+            return false;
+        }
+        cqMapping = singleMapping ? sqMapping
+                                  : ::mmap(nullptr, cqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqMapping == MAP_FAILED) {
+            cqMapping = nullptr;
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqeMapping = ::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqeMapping == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqeMapping);
+
+        auto* sq = static_cast<std::uint8_t*>(sqMapping);
+        auto* cq = static_cast<std::uint8_t*>(cqMapping);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void registerBuffers(const std::vector<std::uint8_t*>& buffers, std::size_t bufferBytes) {
+        iovecs.clear();
+        for (auto* buffer : buffers) {
+            iovecs.push_back({buffer, bufferBytes});
+        }
+        // Pinned once up front: READ_FIXED then skips per-I/O page mapping
+        fixedBuffers = ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS,
+                                 iovecs.data(), static_cast<unsigned>(iovecs.size())) == 0;
+    }
+
+    void queueRead(int fileFd, std::uint64_t offset, std::uint32_t buffer, std::size_t length, std::uint64_t userData) {
+        const unsigned tail = *sqTail;
+        const unsigned index = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = fileFd;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        if (fixedBuffers) {
+            sqe.opcode = IORING_OP_READ_FIXED;
+            sqe.addr = reinterpret_cast<std::uint64_t>(iovecs[buffer].iov_base);
+            sqe.len = static_cast<std::uint32_t>(length);
+            sqe.buf_index = static_cast<std::uint16_t>(buffer);
+        } else {
+            iovecs[buffer].iov_len = length;
+            sqe.opcode = IORING_OP_READV;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&iovecs[buffer]);
+            sqe.len = 1;
+        }
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    [[nodiscard]] bool submitAndWait(unsigned toSubmit) {
+        for (;;) {
+            const long result = ::syscall(__NR_io_uring_enter, fd, toSubmit, 1U, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0) {
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void reap(Visitor&& visit) {
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes[head & *cqMask];
+            visit(cqe.user_data, cqe.res);
+            ++head;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+};
+
+#else
+
+struct AsyncReader::Ring {};
+
+#endif
+
+namespace {
+
+// O_DIRECT needs page-aligned buffers; aligned new also works on MinGW/MSVCRT, unlike aligned_alloc
+constexpr std::align_val_t BUFFER_ALIGNMENT{4096};
+
+#if defined(__linux__)
+
+/**
+ * Blocking read of [offset, offset + length) that tolerates short reads
+ */
+std::size_t preadFully(int fd, std::uint8_t* buffer, std::size_t length, std::uint64_t offset) {
+    std::size_t done = 0;
+    while (done < length) {
+        const ssize_t result = ::pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(result);
+    }
+    return done;
+}
+
+#endif
+
+} // namespace
+
+AsyncReader::AsyncReader(Config config) : config_{config} {
+    config_.bufferBytes = std::max<std::size_t>(
+        (config_.bufferBytes + FRAME_PAGE_ALIGNMENT - 1) / FRAME_PAGE_ALIGNMENT * FRAME_PAGE_ALIGNMENT, FRAME_PAGE_ALIGNMENT);
+    config_.queueDepth = std::clamp<std::size_t>(config_.queueDepth, 1, 1024);
+
+    // Stop at the first failed allocation and run with the buffers we got; none leaves readFiles() failing
+    const std::size_t bufferCount = config_.forcePread ? 1 : config_.queueDepth;
+    for (std::size_t i = 0; i < bufferCount; ++i) {
+        auto* buffer = static_cast<std::uint8_t*>(::operator new(config_.bufferBytes, BUFFER_ALIGNMENT, std::nothrow));
+        if (buffer == nullptr) {
+            break;
+        }
+        buffers_.push_back(buffer);
+    }
+
+#if defined(MTBT_HAVE_IO_URING)
+    if (!config_.forcePread && !buffers_.empty()) {
+        auto* ring = new Ring{};
+        if (ring->setup(static_cast<unsigned>(config_.queueDepth))) {
+            ring->registerBuffers(buffers_, config_.bufferBytes);
+            ring_ = ring;
+            backend_ = Backend::IO_URING;
+        } else {
+            delete ring;
+        }
+    }
+#endif
+}
+
+AsyncReader::~AsyncReader() {
+    delete ring_;
+    for (auto* buffer : buffers_) {
+        ::operator delete(buffer, BUFFER_ALIGNMENT);
+    }
+}
+
+bool AsyncReader::readFiles(const std::vector<std::string>& paths, const BufferHandler& handler) {
+    if (buffers_.empty()) {
+        return false;
+    }
+    std::vector<Input> inputs(paths.size());
+    bool opened = true;
+
+#if defined(__linux__)
+    for (std::size_t i = 0; i < paths.size() && opened; ++i) {
+        auto& input = inputs[i];
+        input.path = paths[i];
+        input.bufferedFd = ::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info{};
+        opened = input.bufferedFd >= 0 && ::fstat(input.bufferedFd, &info) == 0;
+        input.size = opened ? static_cast<std::uint64_t>(info.st_size) : 0;
+
+        // tmpfs and some network filesystems reject O_DIRECT: use the buffered descriptor there
+        input.fd = config_.directIo ? ::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT) : -1;
+        if (input.fd >= 0) {
+            ++stats_.directFiles;
+        } else {
+            input.fd = input.bufferedFd;
+        }
+    }
+#else
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        inputs[i].path = paths[i];
+    }
+#endif
+
+    const bool ok = opened && (backend_ == Backend::IO_URING ? readWithRing(inputs, handler)
+                                                             : readSequential(inputs, handler));
+
+#if defined(__linux__)
+    for (auto& input : inputs) {
+        if (input.fd >= 0 && input.fd != input.bufferedFd) {
+            ::close(input.fd);
+        }
+        if (input.bufferedFd >= 0) {
+            ::close(input.bufferedFd);
+        }
+    }
+#endif
+    return ok;
+}
+
+bool AsyncReader::readSequential(std::vector<Input>& inputs, const BufferHandler& handler) {
+    std::uint8_t* buffer = buffers_.front();
+    for (std::size_t file = 0; file < inputs.size(); ++file) {
+#if defined(__linux__)
+        auto& input = inputs[file];
+        while (input.deliverOffset < input.size) {
+            const std::size_t length = static_cast<std::size_t>(
+                std::min<std::uint64_t>(config_.bufferBytes, input.size - input.deliverOffset));
+            const std::size_t got = preadFully(input.bufferedFd, buffer, length, input.deliverOffset);
+            if (got == 0) {
+                return false;
+            }
+            ++stats_.reads;
+            stats_.bytesRead += got;
+            handler(file, buffer, got);
+            input.deliverOffset += got;
+        }
+#else
+        std::ifstream stream{inputs[file].path, std::ios::binary};
+        if (!stream.is_open()) {
+            return false;
+        }
+        while (stream) {
+            stream.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(config_.bufferBytes));
+            const auto got = static_cast<std::size_t>(stream.gcount());
+            if (got == 0) {
+                break;
+            }
+            ++stats_.reads;
+            stats_.bytesRead += got;
+            handler(file, buffer, got);
+        }
+#endif
+    }
+    return true;
+}
+
+bool AsyncReader::readWithRing(std::vector<Input>& inputs, const BufferHandler& handler) {
+#if defined(MTBT_HAVE_IO_URING)
+    std::vector<std::uint32_t> freeBuffers;
+    for (std::uint32_t i = 0; i < buffers_.size(); ++i) {
+        freeBuffers.push_back(i);
+    }
+
+    // user_data packs (file << 32 | buffer); offsets are tracked per buffer
+    std::vector<std::uint64_t> bufferOffset(buffers_.size(), 0);
+    std::vector<std::size_t> bufferLength(buffers_.size(), 0);
+    std::size_t inFlight = 0;
+    std::size_t nextFile = 0;
+    bool failed = false;
+
+    const auto allSubmitted = [&] {
+        return std::all_of(inputs.begin(), inputs.end(), [](const Input& in) { return in.submitOffset >= in.size; });
+    };
+
+    while (!failed && (inFlight > 0 || !allSubmitted())) {
+        // Keep every free buffer busy, rotating over inputs that still have data
+        unsigned queued = 0;
+        for (std::size_t scanned = 0; !freeBuffers.empty() && scanned < inputs.size();) {
+            auto& input = inputs[nextFile];
+            if (input.submitOffset >= input.size) {
+                nextFile = (nextFile + 1) % inputs.size();
+                ++scanned;
+                continue;
+            }
+            const std::uint32_t buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            const std::size_t length = static_cast<std::size_t>(
+                std::min<std::uint64_t>(config_.bufferBytes, input.size - input.submitOffset));
+            bufferOffset[buffer] = input.submitOffset;
+            bufferLength[buffer] = length;
+            // O_DIRECT wants page-multiple lengths; the kernel stops at EOF anyway
+            const std::size_t requested = input.fd != input.bufferedFd
+                ? (length + 4095) / 4096 * 4096 : length;
+            ring_->queueRead(input.fd, input.submitOffset, buffer, requested,
+                             (static_cast<std::uint64_t>(nextFile) << 32) | buffer);
+            input.submitOffset += length;
+            ++queued;
+            ++inFlight;
+            nextFile = (nextFile + 1) % inputs.size();
+            scanned = 0;
+        }
+
+        if (!ring_->submitAndWait(queued)) {
+            failed = true;
+            break;
+        }
+
+        ring_->reap([&](std::uint64_t userData, std::int32_t result) {
+            const auto file = static_cast<std::size_t>(userData >> 32);
+            const auto buffer = static_cast<std::uint32_t>(userData & 0xFFFFFFFFu);
+            auto& input = inputs[file];
+            const std::size_t expected = bufferLength[buffer];
+            std::size_t got = result > 0 ? std::min<std::size_t>(static_cast<std::size_t>(result), expected) : 0;
+
+            // Short or failed read: finish the rest through the page cache
+            if (got < expected) {
+                ++stats_.fallbackReads;
+                got += preadFully(input.bufferedFd, buffers_[buffer] + got, expected - got, bufferOffset[buffer] + got);
+                if (got < expected) {
+                    failed = true;
+                }
+            }
+            ++stats_.reads;
+            stats_.bytesRead += got;
+            --inFlight;
+            input.completed.emplace(bufferOffset[buffer], std::make_pair(buffer, got));
+        });
+
+        // Deliver each file strictly in offset order, recycling buffers as they drain
+        for (std::size_t file = 0; file < inputs.size(); ++file) {
+            auto& input = inputs[file];
+            for (auto it = input.completed.begin();
+                 it != input.completed.end() && it->first == input.deliverOffset;
+                 it = input.completed.erase(it)) {
+                const auto [buffer, got] = it->second;
+                handler(file, buffers_[buffer], got);
+                input.deliverOffset += got;
+                freeBuffers.push_back(buffer);
+            }
+        }
+    }
+
+    if (failed) {
+        // Drain whatever is still in flight so buffers are not written after we return
+        while (inFlight > 0 && ring_->submitAndWait(0)) {
+            ring_->reap([&](std::uint64_t, std::int32_t) { --inFlight; });
+        }
+    }
+    return !failed;
+#else
+    return readSequential(inputs, handler);
+#endif
+}
+
+} // namespace nse::mtbt
\ No newline at end of file
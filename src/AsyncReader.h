@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Bulk capture ingest with many reads in flight (io_uring on Linux)
+ *
+ * A fixed set of page-aligned buffers is registered with the kernel once and
+ * kept busy with O_DIRECT reads spread round-robin over all input files.
+ * Completed buffers are handed to the caller in file order, one file's
+ * buffers strictly by offset. Buffer sizes are multiples of both the page
+ * size and the 40-byte frame, so a frame never straddles two buffers.
+ *
+ * Without io_uring (old kernel, seccomp, non-Linux) the same interface falls
+ * back to blocking sequential reads.
+ */
+class AsyncReader {
+public:
+    enum class Backend : std::uint8_t {
+        IO_URING,
+        PREAD
+    };
+
+    /**
+     * Least common multiple of the 4 KiB page and the 40-byte frame
+     */
+    static constexpr std::size_t FRAME_PAGE_ALIGNMENT = 20480;
+
+    struct Config {
+        std::size_t bufferBytes{50 * FRAME_PAGE_ALIGNMENT}; // ~1 MB, rounded up to the alignment
+        std::size_t queueDepth{16};                          // Buffers (and reads) in flight
+        bool directIo{true};                                 // Bypass the page cache where supported
+        bool forcePread{false};                              // Skip io_uring even if available
+
+        Config() = default;
+    };
+
+    struct Stats {
+        std::uint64_t bytesRead{0};
+        std::uint64_t reads{0};
+        std::uint64_t directFiles{0};     // Inputs opened with O_DIRECT
+        std::uint64_t fallbackReads{0};   // Short or failed async reads completed with pread
+    };
+
+    using BufferHandler = std::function<void(std::size_t file, const std::uint8_t* data, std::size_t size)>;
+
+    AsyncReader() : AsyncReader(Config{}) {}
+    explicit AsyncReader(Config config);
+    ~AsyncReader();
+
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+
+    /**
+     * Read every file to the end; false if a file cannot be opened or read
+     */
+    bool readFiles(const std::vector<std::string>& paths, const BufferHandler& handler);
+
+    [[nodiscard]] Backend backend() const noexcept { return backend_; }
+    [[nodiscard]] const Stats& getStats() const noexcept { return stats_; }
+
+private:
+    struct Ring;   // io_uring mappings, defined where the kernel headers are available
+    struct Input;
+
+    Config config_;
+    Backend backend_{Backend::PREAD};
+    Stats stats_{};
+    std::vector<std::uint8_t*> buffers_;
+    Ring* ring_{nullptr};
+
+    bool readWithRing(std::vector<Input>& inputs, const BufferHandler& handler);
+    bool readSequential(std::vector<Input>& inputs, const BufferHandler& handler);
+};
+
+} // namespace nse::mtbt
\ No newline at end of file
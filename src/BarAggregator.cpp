@@ -0,0 +1,92 @@
+#include "BarAggregator.h"
+#include <algorithm>
+
+namespace nse::mtbt {
+
+BarAggregator::BarAggregator(Config config, BarHandler handler)
+    : config_{std::move(config)}, handler_{std::move(handler)} {
+    // Zero-length intervals would never close; drop them
+    config_.intervals.erase(std::remove(config_.intervals.begin(), config_.intervals.end(), 0u),
+                            config_.intervals.end());
+}
+
+void BarAggregator::onTrade(const TradeMessage& message) {
+    const std::uint32_t symbolId = symbols_.getOrAssign(message.symbolToken);
+    if (symbolId == SymbolIndex::INVALID_ID) {
+        return;
+    }
+    const std::size_t intervalCount = config_.intervals.size();
+    if (states_.size() < symbols_.size() * intervalCount) {
+        states_.resize(symbols_.size() * intervalCount);
+    }
+    
+    ++stats_.tradesProcessed;
+    const std::uint32_t price = message.priceInPaisa;
+    const std::uint64_t notional = static_cast<std::uint64_t>(price) * message.quantity;
+    
+    BarState* state = &states_[static_cast<std::size_t>(symbolId) * intervalCount];
+    for (std::size_t i = 0; i < intervalCount; ++i, ++state) {
+        const std::uint64_t interval = config_.intervals[i];
+        
+        if (state->tradeCount > 0 && message.timestamp >= state->startTime + interval) {
+            emit(symbolId, i, *state);
+        }
+        if (state->tradeCount == 0) {
+            state->startTime = message.timestamp - message.timestamp % interval;
+            state->open = price;
+            state->high = price;
+            state->low = price;
+        } else if (message.timestamp < state->startTime) {
+            ++stats_.lateTrades;
+        }
+        
+        state->high = std::max(state->high, price);
+        state->low = std::min(state->low, price);
+        state->close = price;
+        state->volume += message.quantity;
+        state->priceVolume += notional;
+        ++state->tradeCount;
+    }
+}
+
+void BarAggregator::advanceTo(std::uint64_t timestamp) {
+    const std::size_t intervalCount = config_.intervals.size();
+    for (std::size_t slot = 0; slot < states_.size(); ++slot) {
+        auto& state = states_[slot];
+        const std::size_t intervalIndex = slot % intervalCount;
+        if (state.tradeCount > 0 && timestamp >= state.startTime + config_.intervals[intervalIndex]) {
+            emit(static_cast<std::uint32_t>(slot / intervalCount), intervalIndex, state);
+        }
+    }
+}
+
+void BarAggregator::flush() {
+    const std::size_t intervalCount = config_.intervals.size();
+    for (std::size_t slot = 0; slot < states_.size(); ++slot) {
+        if (states_[slot].tradeCount > 0) {
+            emit(static_cast<std::uint32_t>(slot / intervalCount), slot % intervalCount, states_[slot]);
+        }
+    }
+}
+
+void BarAggregator::emit(std::uint32_t symbolId, std::size_t intervalIndex, BarState& state) {
+    Bar bar;
+    bar.symbolToken = symbols_.tokenOf(symbolId);
+    bar.interval = config_.intervals[intervalIndex];
+    bar.startTime = state.startTime;
+    bar.open = state.open;
+    bar.high = state.high;
+    bar.low = state.low;
+    bar.close = state.close;
+    bar.volume = state.volume;
+    bar.tradeCount = state.tradeCount;
+    bar.priceVolume = state.priceVolume;
+    
+    state = BarState{};
+    ++stats_.barsEmitted;
+    if (handler_) {
+        handler_(bar);
+    }
+}
+
+} // namespace nse::mtbt
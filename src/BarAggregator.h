@@ -0,0 +1,123 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SymbolIndex.h"
+#include <functional>
+#include <vector>
+
+namespace nse::mtbt {
+
+#if defined(__SIZEOF_INT128__)
+__extension__ using VwapNumerator = unsigned __int128;  // Exact sum of price * quantity
+#else
+using VwapNumerator = std::uint64_t;                    // Exact up to ~1.8e19 paisa-shares per bar
+#endif
+
+/**
+ * Completed OHLCV bar for one symbol and interval
+ */
+struct Bar {
+    std::uint32_t symbolToken{0};
+    std::uint64_t interval{0};        // Bar length in timestamp units
+    std::uint64_t startTime{0};       // Aligned to a multiple of interval
+    std::uint32_t open{0};            // Prices in paisa
+    std::uint32_t high{0};
+    std::uint32_t low{0};
+    std::uint32_t close{0};
+    std::uint64_t volume{0};
+    std::uint64_t tradeCount{0};
+    VwapNumerator priceVolume{0};     // Sum of priceInPaisa * quantity
+
+    /**
+     * Volume-weighted average price in paisa
+     */
+    [[nodiscard]] double vwapInPaisa() const noexcept {
+        return volume > 0 ? static_cast<double>(priceVolume) / static_cast<double>(volume) : 0.0;
+    }
+};
+
+/**
+ * Incremental per-symbol OHLCV/VWAP bar engine
+ *
+ * State for every (symbol, interval) pair lives in one flat array indexed
+ * by dense symbol id, so a trade costs one table lookup plus a few integer
+ * updates per interval. A bar is emitted when a trade crosses its time
+ * boundary, or when advanceTo() moves the clock past it.
+ */
+class BarAggregator {
+public:
+    /**
+     * Aggregation configuration
+     */
+    struct Config {
+        std::vector<std::uint64_t> intervals{1'000'000, 60'000'000};  // 1s and 1m of µs timestamps
+        
+        Config() = default;
+    };
+
+    /**
+     * Running counters
+     */
+    struct Stats {
+        std::uint64_t tradesProcessed{0};
+        std::uint64_t barsEmitted{0};
+        std::uint64_t lateTrades{0};       // Older than the open bar; folded into it
+    };
+
+    using BarHandler = std::function<void(const Bar& bar)>;
+
+    BarAggregator(Config config, BarHandler handler);
+
+    /**
+     * Fold one trade into every interval's open bar
+     */
+    void onTrade(const TradeMessage& message);
+
+    /**
+     * Fold a batch of trades
+     */
+    template<typename Container>
+    void onTrades(const Container& messages) {
+        for (const auto& message : messages) {
+            onTrade(message);
+        }
+    }
+
+    /**
+     * Emit every open bar that ends at or before the given time (for quiet symbols)
+     */
+    void advanceTo(std::uint64_t timestamp);
+
+    /**
+     * Emit all open bars (end of session)
+     */
+    void flush();
+
+    [[nodiscard]] const Stats& getStats() const noexcept { return stats_; }
+    [[nodiscard]] const Config& getConfig() const noexcept { return config_; }
+
+private:
+    /**
+     * Open bar for one (symbol, interval) slot; tradeCount == 0 means no open bar
+     */
+    struct BarState {
+        std::uint64_t startTime{0};
+        std::uint64_t volume{0};
+        std::uint64_t tradeCount{0};
+        VwapNumerator priceVolume{0};
+        std::uint32_t open{0};
+        std::uint32_t high{0};
+        std::uint32_t low{0};
+        std::uint32_t close{0};
+    };
+
+    Config config_;
+    BarHandler handler_;
+    SymbolIndex symbols_;
+    std::vector<BarState> states_;  // [symbolId * intervals + intervalIndex]
+    Stats stats_{};
+
+    void emit(std::uint32_t symbolId, std::size_t intervalIndex, BarState& state);
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,1269 @@
+#include "Benchmarks.h"
+#include "AsyncReader.h"
+#include "BarAggregator.h"
+#include "Conflator.h"
+#include "Decoder.h"
+#include "EventTracer.h"
+#include "FeedSimulator.h"
+#include "IndexEngine.h"
+#include "InstrumentLimits.h"
+#include "LatencyHistogram.h"
+#include "MergeReplay.h"
+#include "Platform.h"
+#include "QuantileSketch.h"
+#include "SpscQueue.h"
+#include "StreamDemux.h"
+#include "TcpPublisher.h"
+#include "TcpSubscriber.h"
+#include "TradeHistory.h"
+#include "TradeRing.h"
+#include "Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt::bench {
+
+namespace {
+
+using utils::colors::BOLD;
+using utils::colors::CYAN;
+using utils::colors::RESET;
+
+void printHeader(const std::string& title) {
+    std::cout << BOLD << CYAN << "\n⏱️  " << title << RESET << "\n"
+              << CYAN << "═══════════════════════════════════════════════════════════" << RESET << "\n";
+}
+
+/**
+ * Deterministic decoded trades spread over a session at a fixed spacing
+ */
+std::vector<TradeMessage> generateSessionTrades(const BenchmarkOptions& options, std::uint64_t spacingUs) {
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = options.messageCount;
+    simConfig.seed = options.seed;
+    FeedSimulator simulator{simConfig};
+    
+    Decoder decoder{};
+    auto trades = decoder.decodeFeed(simulator.generateFeed());
+    const std::uint64_t sessionStart = trades.empty() ? 0 : trades.front().timestamp;
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        trades[i].timestamp = sessionStart + i * spacingUs;
+    }
+    return trades;
+}
+
+double nsPerItem(std::chrono::steady_clock::duration elapsed, std::size_t items) {
+    return items > 0 ? static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                       static_cast<double>(items) : 0.0;
+}
+
+/**
+ * Bar engine cost per trade next to the decoder's own cost
+ */
+bool runBarsBenchmark(const BenchmarkOptions& options) {
+    printHeader("OHLCV/VWAP bar aggregation (1s + 1m bars)");
+    
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = options.messageCount;
+    simConfig.seed = options.seed;
+    FeedSimulator simulator{simConfig};
+    const auto feed = simulator.generateFeed();
+    
+    Decoder decoder{};
+    const auto decodeStart = std::chrono::steady_clock::now();
+    const auto decoded = decoder.decodeFeed(feed);
+    const double decodeNs = nsPerItem(std::chrono::steady_clock::now() - decodeStart, decoded.size());
+    
+    // 50 µs apart: a 1s bar closes roughly every 20k trades
+    const auto trades = generateSessionTrades(options, 50);
+    BarAggregator aggregator{BarAggregator::Config{}, [](const Bar&) {}};
+    const auto barsStart = std::chrono::steady_clock::now();
+    aggregator.onTrades(trades);
+    aggregator.flush();
+    const double barsNs = nsPerItem(std::chrono::steady_clock::now() - barsStart, trades.size());
+    
+    std::cout << std::fixed << std::setprecision(1)
+              << "Trades:            " << trades.size() << "\n"
+              << "Bars emitted:      " << aggregator.getStats().barsEmitted << "\n"
+              << "Decoder:           " << decodeNs << " ns/msg\n"
+              << "Bar engine:        " << barsNs << " ns/trade\n"
+              << "Headroom:          " << (barsNs > 0 ? decodeNs / barsNs : 0.0)
+              << "x decoder rate on one core\n";
+    return true;
+}
+
+/**
+ * Hundreds of indices over shared constituents: per-trade update and tick latency
+ */
+bool runIndexBenchmark(const BenchmarkOptions& options) {
+    printHeader("Incremental index computation (500 indices, shared constituents)");
+    
+    constexpr std::size_t INDEX_COUNT = 500;
+    std::vector<std::uint32_t> tokens;
+    for (const auto& [token, name] : SymbolRegistry::tokenToSymbol) {
+        tokens.push_back(token);
+    }
+    std::sort(tokens.begin(), tokens.end());
+    
+    std::mt19937 rng{options.seed};
+    std::vector<IndexDefinition> definitions(INDEX_COUNT);
+    for (std::size_t i = 0; i < INDEX_COUNT; ++i) {
+        definitions[i].name = "IDX" + std::to_string(i);
+        auto members = tokens;
+        std::shuffle(members.begin(), members.end(), rng);
+        members.resize(5 + rng() % (tokens.size() - 5));
+        for (const auto token : members) {
+            definitions[i].constituents.push_back({token, 1'000'000'000 + rng() % 5'000'000'000ULL, 100'000});
+        }
+    }
+    
+    std::uint64_t ticks = 0;
+    IndexEngine engine{definitions, [&ticks](const IndexTick&) { ++ticks; }};
+    const auto trades = generateSessionTrades(options, 50);
+    
+    LatencyHistogram perTrade;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& trade : trades) {
+        const auto before = steadyNowNs();
+        engine.onTrade(trade);
+        perTrade.record(steadyNowNs() - before);
+    }
+    const double tradeNs = nsPerItem(std::chrono::steady_clock::now() - start, trades.size());
+    
+    std::cout << std::fixed << std::setprecision(1)
+              << "Trades:            " << trades.size() << "\n"
+              << "Ticks published:   " << ticks << " (" << (trades.empty() ? 0.0 : static_cast<double>(ticks) / trades.size())
+              << " per trade)\n"
+              << "Per trade:         " << tradeNs << " ns (incl. timer)\n"
+              << "Per tick:          " << nsPerItem(std::chrono::steady_clock::now() - start, ticks) << " ns\n"
+              << "Latency p50/p99:   " << perTrade.percentile(0.50) << " / " << perTrade.percentile(0.99)
+              << " ns, max " << perTrade.max() << " ns\n";
+    return true;
+}
+
+/**
+ * K-way timestamp merge of 1-8 captures, inline decoding vs decode-ahead threads
+ */
+bool runMergeBenchmark(const BenchmarkOptions& options) {
+    printHeader("K-way capture merge (inline vs decode-ahead)");
+    
+    const auto directory = std::filesystem::temp_directory_path();
+    std::cout << std::left << std::setw(8) << "Inputs" << std::setw(14) << "Trades"
+              << std::setw(18) << "Inline ns/msg" << std::setw(22) << "Decode-ahead ns/msg" << "Ordered\n";
+    
+    for (const std::size_t inputCount : {1, 2, 4, 8}) {
+        // Interleaved timestamps: frame i of input k sorts at position i * K + k
+        std::vector<std::string> paths;
+        for (std::size_t k = 0; k < inputCount; ++k) {
+            FeedSimulator::Config simConfig{};
+            simConfig.messageCount = std::max<std::size_t>(options.messageCount / inputCount, 1);
+            simConfig.seed = options.seed + static_cast<std::uint32_t>(k);
+            auto feed = FeedSimulator{simConfig}.generateFeed();
+            for (std::size_t i = 0; i * ProtocolConstants::MESSAGE_SIZE < feed.size(); ++i) {
+                const std::uint64_t timestamp = 1'700'000'000'000'000ULL + (i * inputCount + k) * 10;
+                wire::TradeFrame::Timestamp::store(feed.data() + i * ProtocolConstants::MESSAGE_SIZE, timestamp);
+            }
+            paths.push_back((directory / ("mtbt_merge_" + std::to_string(k) + ".cap")).string());
+            if (!CaptureFile::write(paths.back(), feed)) {
+                std::cerr << "Failed to write " << paths.back() << "\n";
+                return false;
+            }
+        }
+        
+        std::uint64_t trades = 0;
+        bool ordered = true;
+        double nsPerMessage[2] = {0.0, 0.0};
+        for (const bool decodeAhead : {false, true}) {
+            std::vector<CaptureFile> inputs;
+            for (const auto& path : paths) {
+                inputs.push_back(std::move(*CaptureFile::open(path)));
+            }
+            MergeReplay::Config mergeConfig{};
+            mergeConfig.decodeAhead = decodeAhead;
+            MergeReplay replay{std::move(inputs), mergeConfig};
+            
+            std::uint64_t lastTimestamp = 0;
+            const auto start = std::chrono::steady_clock::now();
+            trades = replay.run([&](std::size_t, const TradeMessage& message) {
+                ordered = ordered && message.timestamp >= lastTimestamp;
+                lastTimestamp = message.timestamp;
+            });
+            nsPerMessage[decodeAhead ? 1 : 0] = nsPerItem(std::chrono::steady_clock::now() - start, trades);
+        }
+        
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << inputCount << std::setw(14) << trades
+                  << std::setw(18) << nsPerMessage[0] << std::setw(22) << nsPerMessage[1]
+                  << (ordered ? "yes" : "NO") << "\n";
+        for (const auto& path : paths) {
+            std::filesystem::remove(path);
+        }
+    }
+    std::cout << "Decode-ahead gains need spare cores: one decoder thread runs per input\n";
+    return true;
+}
+
+/**
+ * Evict a file from the page cache so the next read hits the device
+ */
+void dropFromPageCache(const std::string& path) {
+#if defined(__linux__)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+/**
+ * Cold-cache ingest + decode: mmap vs blocking read vs io_uring
+ */
+bool runIngestBenchmark(const BenchmarkOptions& options) {
+    printHeader("Capture ingest + decode, cold page cache");
+    
+    std::vector<std::string> paths = options.inputs;
+    std::string generated;
+    if (paths.empty()) {
+        // Repeat one simulated feed up to ~256 MB so device time dominates
+        FeedSimulator::Config simConfig{};
+        simConfig.messageCount = options.messageCount;
+        simConfig.seed = options.seed;
+        const auto feed = FeedSimulator{simConfig}.generateFeed();
+        generated = (std::filesystem::temp_directory_path() / "mtbt_ingest.cap").string();
+        std::ofstream file{generated, std::ios::binary | std::ios::trunc};
+        const std::size_t repeats = std::max<std::size_t>((256u << 20) / std::max<std::size_t>(feed.size(), 1), 1);
+        for (std::size_t i = 0; i < repeats && file; ++i) {
+            file.write(reinterpret_cast<const char*>(feed.data()), static_cast<std::streamsize>(feed.size()));
+        }
+        if (!file) {
+            std::cerr << "Failed to write " << generated << "\n";
+            return false;
+        }
+        paths.push_back(generated);
+    }
+    
+    struct Result {
+        const char* name;
+        std::uint64_t bytes{0};
+        std::uint64_t messages{0};
+        double seconds{0.0};
+    };
+    std::vector<Result> results;
+    
+    const auto measure = [&](const char* name, auto&& ingest) {
+        for (const auto& path : paths) {
+            dropFromPageCache(path);
+        }
+        Result result{name};
+        const auto start = std::chrono::steady_clock::now();
+        ingest(result);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        results.push_back(result);
+    };
+    
+    measure("mmap", [&](Result& result) {
+        for (const auto& path : paths) {
+            auto capture = CaptureFile::open(path);
+            if (!capture) {
+                continue;
+            }
+            Decoder decoder{};
+            Decoder::MessageBuffer batch;
+            for (std::size_t offset = 0; offset < capture->size(); offset += AsyncReader::Config{}.bufferBytes) {
+                decoder.decodeFeedInto(capture->data() + offset,
+                                       std::min(AsyncReader::Config{}.bufferBytes, capture->size() - offset), batch);
+                result.messages += batch.size();
+            }
+            result.bytes += capture->size();
+        }
+    });
+    
+    std::string uringLabel;
+    for (const bool async : {false, true}) {
+        AsyncReader::Config readerConfig{};
+        readerConfig.forcePread = !async;
+        AsyncReader reader{readerConfig};
+        if (async && reader.backend() != AsyncReader::Backend::IO_URING) {
+            std::cout << "io_uring unavailable here (kernel or seccomp); async path uses blocking reads\n";
+        }
+        std::vector<Decoder> decoders(paths.size());
+        Decoder::MessageBuffer batch;
+        measure(async ? "io_uring" : "read", [&](Result& result) {
+            reader.readFiles(paths, [&](std::size_t file, const std::uint8_t* data, std::size_t size) {
+                decoders[file].decodeFeedInto(data, size, batch);
+                result.messages += batch.size();
+            });
+            result.bytes = reader.getStats().bytesRead;
+        });
+        if (async) {
+            uringLabel = std::to_string(reader.getStats().directFiles) + " of " + std::to_string(paths.size()) +
+                         " inputs O_DIRECT, " + std::to_string(reader.getStats().fallbackReads) + " fallback reads";
+        }
+    }
+    
+    std::cout << std::left << std::setw(12) << "Method" << std::setw(14) << "MB/s"
+              << std::setw(16) << "Msgs/s" << "Messages\n";
+    for (const auto& result : results) {
+        const double seconds = std::max(result.seconds, 1e-9);
+        std::cout << std::fixed << std::setprecision(1) << std::setw(12) << result.name
+                  << std::setw(14) << static_cast<double>(result.bytes) / (1 << 20) / seconds
+                  << std::setw(16) << std::setprecision(0) << static_cast<double>(result.messages) / seconds
+                  << result.messages << "\n";
+    }
+    std::cout << "io_uring: " << uringLabel << "\n";
+    
+    if (!generated.empty()) {
+        std::filesystem::remove(generated);
+    }
+    return true;
+}
+
+/**
+ * Tick-to-decode latency: send-stamped frames through an SPSC ring, measured at the sink
+ */
+bool runLatencyBenchmark(const BenchmarkOptions& options) {
+    printHeader("Tick-to-decode latency by load and batch size");
+    
+    struct Frame {
+        std::uint8_t bytes[ProtocolConstants::MESSAGE_SIZE];
+    };
+    
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = std::max<std::size_t>(options.messageCount, 20000);
+    simConfig.seed = options.seed;
+    FeedSimulator simulator{simConfig};
+    const auto feed = simulator.generateFeed();
+    const std::size_t frameCount = feed.size() / ProtocolConstants::MESSAGE_SIZE;
+    
+    std::cout << std::left << std::setw(12) << "Load" << std::setw(8) << "Batch" << std::setw(14) << "Achieved/s"
+              << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(12) << "p99.9 ns" << "max ns\n";
+    
+    // 0 = unpaced: the producer publishes as fast as the ring accepts
+    for (const std::uint64_t rate : {100'000ULL, 1'000'000ULL, 5'000'000ULL, 0ULL}) {
+        for (const std::size_t batchFrames : {1, 16, 256}) {
+            SpscQueue<Frame> ring{1 << 16};
+            std::atomic<bool> producerDone{false};
+            LatencyHistogram latency;
+            
+            std::thread consumer{[&] {
+                Decoder decoder{};
+                Decoder::MessageBuffer batch;
+                std::vector<std::uint8_t> pending(batchFrames * ProtocolConstants::MESSAGE_SIZE);
+                std::size_t pendingFrames = 0;
+                
+                const auto decodeAndSink = [&] {
+                    decoder.decodeFeedInto(pending.data(), pendingFrames * ProtocolConstants::MESSAGE_SIZE, batch);
+                    for (const auto& message : batch) {
+                        latency.record(FeedSimulator::sendClockNs() - message.timestamp);
+                    }
+                    pendingFrames = 0;
+                };
+                
+                Frame frame;
+                for (;;) {
+                    if (ring.tryPop(frame)) {
+                        std::memcpy(pending.data() + pendingFrames * ProtocolConstants::MESSAGE_SIZE,
+                                    frame.bytes, ProtocolConstants::MESSAGE_SIZE);
+                        if (++pendingFrames == batchFrames) {
+                            decodeAndSink();
+                        }
+                    } else if (producerDone.load(std::memory_order_acquire) && ring.empty()) {
+                        if (pendingFrames > 0) {
+                            decodeAndSink();
+                        }
+                        return;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }};
+            
+            const std::uint64_t periodNs = rate > 0 ? 1'000'000'000ULL / rate : 0;
+            const std::uint64_t start = FeedSimulator::sendClockNs();
+            Frame frame;
+            for (std::size_t i = 0; i < frameCount; ++i) {
+                while (periodNs > 0 && FeedSimulator::sendClockNs() < start + i * periodNs) {
+                    // Busy-wait pacing; yield lets the consumer run on small machines
+                    std::this_thread::yield();
+                }
+                std::memcpy(frame.bytes, feed.data() + i * ProtocolConstants::MESSAGE_SIZE, ProtocolConstants::MESSAGE_SIZE);
+                simulator.stampSendTime(frame.bytes, false);
+                while (!ring.tryPush(frame)) {
+                    std::this_thread::yield();
+                }
+            }
+            producerDone.store(true, std::memory_order_release);
+            consumer.join();
+            const double seconds = static_cast<double>(FeedSimulator::sendClockNs() - start) / 1e9;
+            
+            std::cout << std::setw(12) << (rate > 0 ? std::to_string(rate / 1000) + "k/s" : std::string{"max"})
+                      << std::setw(8) << batchFrames
+                      << std::setw(14) << static_cast<std::uint64_t>(static_cast<double>(frameCount) / seconds)
+                      << std::setw(10) << latency.percentile(0.50) << std::setw(10) << latency.percentile(0.99)
+                      << std::setw(12) << latency.percentile(0.999) << latency.max() << "\n";
+        }
+    }
+    std::cout << "Send time: CLOCK_MONOTONIC_RAW stamped into the timestamp field just before publish\n";
+    return true;
+}
+
+/**
+ * Per-symbol history store: bytes per trade, append cost and query latency
+ */
+bool runHistoryBenchmark(const BenchmarkOptions& options) {
+    printHeader("Columnar per-symbol trade history");
+    
+    // Random-walk prices per symbol: the simulator's uniform prices are not a realistic tape
+    const std::size_t tradeCount = std::max<std::size_t>(options.messageCount, 1'000'000);
+    const std::uint32_t tokens[] = {3045, 1270, 11536, 2885, 1594, 4963, 8479, 6364, 1922, 5258};
+    std::uint32_t prices[std::size(tokens)];
+    std::mt19937 rng{options.seed};
+    for (auto& price : prices) {
+        price = 100'000 + rng() % 300'000;
+    }
+    std::vector<TradeMessage> trades(tradeCount);
+    const std::uint64_t sessionStart = 1'700'000'000'000'000ULL;
+    for (std::size_t i = 0; i < tradeCount; ++i) {
+        const std::size_t symbol = rng() % std::size(tokens);
+        prices[symbol] = static_cast<std::uint32_t>(std::max<std::int64_t>(5, static_cast<std::int64_t>(prices[symbol]) +
+                                                                               static_cast<std::int64_t>(rng() % 41) - 20));
+        trades[i] = TradeMessage{static_cast<std::uint32_t>(i + 1), tokens[symbol], sessionStart + i * 20,
+                                 prices[symbol], static_cast<std::uint32_t>(1 + rng() % 5000), (rng() & 1) ? TradeSide::SELL : TradeSide::BUY};
+    }
+    
+    TradeHistory history;
+    const auto appendStart = std::chrono::steady_clock::now();
+    history.onTrades(trades);
+    const double appendNs = nsPerItem(std::chrono::steady_clock::now() - appendStart, trades.size());
+    const auto stats = history.getStats();
+    
+    const auto timeQuery = [](auto&& query) {
+        constexpr int REPEATS = 200;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPEATS; ++i) {
+            query();
+        }
+        return nsPerItem(std::chrono::steady_clock::now() - start, REPEATS) / 1000.0;
+    };
+    
+    const std::uint64_t sessionEnd = trades.back().timestamp;
+    const std::uint64_t midSession = sessionStart + (sessionEnd - sessionStart) / 2 + 7; // Not block-aligned
+    std::vector<TradeMessage> out;
+    TradeHistory::Aggregate sinceMid;
+    const double lastUs = timeQuery([&] { out.clear(); history.lastTrades(tokens[0], 10'000, out); });
+    const double sinceUs = timeQuery([&] { sinceMid = history.aggregate(tokens[0], midSession, sessionEnd); });
+    const double windowUs = timeQuery([&] {
+        sinceMid = history.aggregate(tokens[0], midSession, midSession + 1'000'000); // 1s partial window
+    });
+    
+    // Cross-check the aggregate against a plain scan of the source trades
+    std::uint64_t exactVolume = 0;
+    for (const auto& trade : trades) {
+        if (trade.symbolToken == tokens[0] && trade.timestamp >= midSession && trade.timestamp <= midSession + 1'000'000) {
+            exactVolume += trade.quantity;
+        }
+    }
+    
+    // Illiquid tape: many symbols trading every 75 minutes (past the u32 µs delta) with wide
+    // price swings, so nearly every trade seals its block
+    constexpr std::uint32_t SPARSE_SYMBOLS = 20'000;
+    constexpr std::uint32_t SPARSE_ROUNDS = 5;
+    constexpr std::uint64_t SPARSE_SPACING_US = 75ULL * 60 * 1'000'000;
+    TradeHistory sparse;
+    std::uint32_t sparseSequence = 0;
+    const auto sparseStart = std::chrono::steady_clock::now();
+    for (std::uint32_t round = 0; round < SPARSE_ROUNDS; ++round) {
+        for (std::uint32_t symbol = 0; symbol < SPARSE_SYMBOLS; ++symbol) {
+            sparse.append(TradeMessage{++sparseSequence, 100'000 + symbol, sessionStart + round * SPARSE_SPACING_US + symbol,
+                                       static_cast<std::uint32_t>(10'000 + rng() % 1'000'000),
+                                       static_cast<std::uint32_t>(1 + rng() % 500), (rng() & 1) ? TradeSide::SELL : TradeSide::BUY});
+        }
+    }
+    const double sparseAppendNs = nsPerItem(std::chrono::steady_clock::now() - sparseStart, std::size_t{sparseSequence});
+    const auto sparseStats = sparse.getStats();
+    out.clear();
+    const bool sparseComplete = sparse.lastTrades(100'000 + SPARSE_SYMBOLS / 2, 100, out) == SPARSE_ROUNDS;
+    
+    std::cout << std::fixed << std::setprecision(2)
+              << "Trades:               " << stats.trades << " in " << stats.blocks << " blocks\n"
+              << "Memory:               " << stats.bytesPerTrade() << " bytes/trade (vs "
+              << sizeof(TradeMessage) << " for TradeMessage)\n"
+              << "Append:               " << appendNs << " ns/trade\n"
+              << "Last 10,000 trades:   " << lastUs << " µs\n"
+              << "Volume, half session: " << sinceUs << " µs\n"
+              << "Volume, 1s window:    " << windowUs << " µs ("
+              << (sinceMid.volume == exactVolume ? "matches" : "MISMATCH vs") << " exact scan)\n"
+              << "Sparse tape:          " << sparseStats.trades << " trades of " << SPARSE_SYMBOLS << " symbols in "
+              << sparseStats.blocks << " blocks\n"
+              << "Sparse memory:        " << sparseStats.bytesPerTrade() << " bytes/trade, append "
+              << sparseAppendNs << " ns/trade" << (sparseComplete ? "" : " (MISSING trades)") << "\n";
+    return sinceMid.volume == exactVolume && sparseComplete;
+}
+
+/**
+ * Per-instrument limit checks: branchy per-message validate() vs the batch bitmask validator
+ */
+bool runLimitsBenchmark(const BenchmarkOptions& options) {
+    printHeader("Per-instrument limits: per-message validate() vs batch bitmask");
+    
+    BenchmarkOptions sized = options;
+    sized.messageCount = std::max<std::size_t>(options.messageCount, 1'000'000);
+    const auto trades = generateSessionTrades(sized, 1);
+    
+    // Bands around each traded symbol's first price, plus a few thousand idle instruments
+    InstrumentLimits::Table table;
+    for (const auto& trade : trades) {
+        if (table.get(trade.symbolToken).upperPrice == InstrumentLimits::Limits{}.upperPrice) {
+            InstrumentLimits::Limits bands;
+            bands.lowerPrice = trade.priceInPaisa / 2;
+            bands.upperPrice = trade.priceInPaisa + trade.priceInPaisa / 2;
+            bands.tickSize = 5;
+            table.set(trade.symbolToken, bands);
+        }
+    }
+    for (std::uint32_t token = 100'000; token < 105'000; ++token) {
+        table.set(token, InstrumentLimits::Limits{});
+    }
+    const std::size_t instruments = table.instrumentCount();
+    InstrumentLimits limits{table};
+    
+    // Validation runs on just-decoded, cache-hot messages: repeat each 4096-trade chunk in place
+    constexpr int PASSES = 5;
+    constexpr std::size_t CHUNK = 4096;
+    std::uint64_t scalarValid = 0;
+    const auto scalarStart = std::chrono::steady_clock::now();
+    for (std::size_t begin = 0; begin < trades.size(); begin += CHUNK) {
+        const std::size_t end = std::min(begin + CHUNK, trades.size());
+        for (int pass = 0; pass < PASSES; ++pass) {
+            for (std::size_t i = begin; i < end; ++i) {
+                scalarValid += trades[i].validate().isValid;
+            }
+        }
+    }
+    const double scalarNs = nsPerItem(std::chrono::steady_clock::now() - scalarStart, trades.size() * PASSES);
+    
+    std::uint64_t batchValid = 0;
+    const auto batchStart = std::chrono::steady_clock::now();
+    {
+        const auto pinned = limits.acquire();
+        for (std::size_t begin = 0; begin < trades.size(); begin += CHUNK) {
+            const std::size_t end = std::min(begin + CHUNK, trades.size());
+            for (int pass = 0; pass < PASSES; ++pass) {
+                for (std::size_t i = begin; i < end; i += InstrumentLimits::BATCH_MESSAGES) {
+                    const std::size_t count = std::min(InstrumentLimits::BATCH_MESSAGES, end - i);
+                    batchValid += static_cast<std::uint64_t>(
+                        __builtin_popcountll(InstrumentLimits::validateBatch(*pinned, trades.data() + i, count)));
+                }
+            }
+        }
+    }
+    const double batchNs = nsPerItem(std::chrono::steady_clock::now() - batchStart, trades.size() * PASSES);
+    
+    // End to end: decoding with the limits table attached, while another thread swaps it
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = sized.messageCount;
+    simConfig.seed = options.seed;
+    const auto feed = FeedSimulator{simConfig}.generateFeed();
+    Decoder plain{};
+    const auto plainStart = std::chrono::steady_clock::now();
+    const auto plainDecoded = plain.decodeFeed(feed);
+    const double plainNs = nsPerItem(std::chrono::steady_clock::now() - plainStart, feed.size() / ProtocolConstants::MESSAGE_SIZE);
+    
+    // Intraday updates: swaps land between 4096-message batches without stalling the decoder
+    Decoder limited{};
+    limited.setInstrumentLimits(&limits);
+    std::atomic<bool> decoding{true};
+    std::thread updater([&] {
+        while (decoding.load(std::memory_order_relaxed)) {
+            limits.update(table);
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    });
+    constexpr std::size_t BATCH_BYTES = 4096 * ProtocolConstants::MESSAGE_SIZE;
+    Decoder::MessageBuffer batch;
+    std::size_t limitedKept = 0;
+    const auto limitedStart = std::chrono::steady_clock::now();
+    for (std::size_t offset = 0; offset < feed.size(); offset += BATCH_BYTES) {
+        limited.decodeFeedInto(feed.data() + offset, std::min(BATCH_BYTES, feed.size() - offset), batch);
+        limitedKept += batch.size();
+    }
+    const double limitedNs = nsPerItem(std::chrono::steady_clock::now() - limitedStart, feed.size() / ProtocolConstants::MESSAGE_SIZE);
+    decoding.store(false, std::memory_order_relaxed);
+    updater.join();
+    
+    std::cout << std::fixed << std::setprecision(2)
+              << "Trades:                  " << trades.size() << " (" << instruments << " instruments in table)\n"
+              << "validate() per message:  " << scalarNs << " ns/msg (global rules, " << scalarValid / PASSES << " valid)\n"
+              << "validateBatch (64/mask): " << batchNs << " ns/msg (per-instrument, " << batchValid / PASSES << " valid)\n"
+              << "Decode, global rules:    " << plainNs << " ns/msg (" << plainDecoded.size() << " kept)\n"
+              << "Decode, limits + swaps:  " << limitedNs << " ns/msg (" << limitedKept << " kept, "
+              << limits.updateCount() << " table swaps during the run)\n";
+    return true;
+}
+
+/**
+ * Multi-stream segment decode: one global decoder vs per-stream demux on 1-4 threads
+ */
+bool runStreamsBenchmark(const BenchmarkOptions& options) {
+    printHeader("Multi-stream segment demux (per-stream sequence spaces)");
+    
+    constexpr std::uint16_t STREAMS = 16;
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = std::max<std::size_t>(options.messageCount, 2'000'000);
+    simConfig.seed = options.seed;
+    simConfig.streamCount = STREAMS;
+    const auto feed = FeedSimulator{simConfig}.generateBinaryFeed();
+    constexpr std::size_t CHUNK_BYTES = 1 << 16;
+    
+    // Lose every 10007th frame in transit, so each stream has real gaps to find
+    constexpr std::size_t DROP_EVERY = 10'007;
+    std::vector<std::uint8_t> segment;
+    segment.reserve(feed.size());
+    std::size_t dropped = 0;
+    for (std::size_t offset = 0; offset < feed.size(); offset += ProtocolConstants::MESSAGE_SIZE) {
+        if ((offset / ProtocolConstants::MESSAGE_SIZE) % DROP_EVERY == DROP_EVERY - 1) {
+            ++dropped;
+            continue;
+        }
+        segment.insert(segment.end(), feed.begin() + offset, feed.begin() + offset + ProtocolConstants::MESSAGE_SIZE);
+    }
+    
+    // A single decoder's high-water mark follows the fastest stream and hides the slower streams' losses
+    Decoder global{};
+    Decoder::MessageBuffer globalOut;
+    const auto globalStart = std::chrono::steady_clock::now();
+    global.decodeFeedInto(segment.data(), segment.size(), globalOut);
+    const double globalNs = nsPerItem(std::chrono::steady_clock::now() - globalStart, globalOut.size());
+    
+    std::cout << std::left << std::setw(26) << "Mode" << std::setw(12) << "ns/msg" << std::setw(12) << "Valid"
+              << std::setw(14) << "Missing" << "Stalls\n";
+    std::cout << std::fixed << std::setprecision(1) << std::setw(26) << "Global decoder" << std::setw(12) << globalNs
+              << std::setw(12) << globalOut.size() << std::setw(14) << global.getStats().missingMessages << "-\n";
+    
+    for (const std::size_t threads : {0, 1, 2, 4}) {
+        StreamDemux::Config demuxConfig{};
+        demuxConfig.streamCount = STREAMS;
+        demuxConfig.threadCount = threads;
+        std::vector<std::uint64_t> handled(STREAMS * 8, 0);  // Stride 8: one cache line per stream
+        StreamDemux demux{demuxConfig, [&handled](std::uint16_t stream, const TradeMessage&) {
+            ++handled[stream * 8];
+        }};
+        
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t position = 0; position < segment.size(); position += CHUNK_BYTES) {
+            demux.onSegmentData(segment.data() + position, std::min(CHUNK_BYTES, segment.size() - position));
+        }
+        demux.flush();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        
+        std::uint64_t valid = 0;
+        std::uint64_t missing = 0;
+        for (std::uint16_t stream = 0; stream < STREAMS; ++stream) {
+            valid += demux.getStats(stream).validMessages;
+            missing += demux.getStats(stream).missingMessages;
+        }
+        const std::string mode = threads == 0 ? "Demux, inline" : "Demux, " + std::to_string(threads) + " thread(s)";
+        std::cout << std::setw(26) << mode << std::setw(12) << nsPerItem(elapsed, valid) << std::setw(12) << valid
+                  << std::setw(14) << missing << demux.getDemuxStats().producerStalls << "\n";
+    }
+    std::cout << "Streams: " << STREAMS << ", frames dropped: " << dropped << ", segment read in " << CHUNK_BYTES << "-byte chunks;\n"
+              << "thread scaling needs spare cores (this host: " << std::thread::hardware_concurrency() << ")\n";
+    return true;
+}
+
+/**
+ * Cost of one traced scope, and of tracing a full decode
+ */
+bool runTracerBenchmark(const BenchmarkOptions& options) {
+    printHeader("Hot-path event tracer overhead");
+    
+    // Scope objects are used directly so the cost is measurable in any build
+    constexpr std::size_t SCOPES = 1 << 22;
+    const auto timeScopes = [] {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < SCOPES; ++i) {
+            const EventTracer::Scope scope{"bench::scope"};
+            std::atomic_signal_fence(std::memory_order_seq_cst);  // Keep the empty scope in the loop
+        }
+        return nsPerItem(std::chrono::steady_clock::now() - start, SCOPES);
+    };
+    const auto tickStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < SCOPES; ++i) {
+        (void)EventTracer::now();  // Not elided: the TSC read is volatile
+    }
+    const double tickNs = nsPerItem(std::chrono::steady_clock::now() - tickStart, SCOPES);
+    
+    EventTracer::enable(false);
+    const double disabledNs = timeScopes();
+    EventTracer::enable(true);
+    const double enabledNs = timeScopes();
+    EventTracer::enable(false);
+    EventTracer::clear();
+    
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = std::max<std::size_t>(options.messageCount, 1'000'000);
+    simConfig.seed = options.seed;
+    const auto feed = FeedSimulator{simConfig}.generateBinaryFeed();
+    constexpr int PASSES = 3;
+    double decodeNs[2] = {1e9, 1e9};  // Best of PASSES
+    for (int pass = 0; pass < PASSES; ++pass) {
+        for (const bool traced : {false, true}) {
+            EventTracer::enable(traced);
+            Decoder decoder{};
+            const auto start = std::chrono::steady_clock::now();
+            const auto messages = decoder.decodeFeed(feed);
+            decodeNs[traced ? 1 : 0] = std::min(decodeNs[traced ? 1 : 0],
+                                                nsPerItem(std::chrono::steady_clock::now() - start, messages.size()));
+        }
+    }
+    EventTracer::enable(false);
+    const auto summary = EventTracer::summary();
+    EventTracer::clear();
+    
+    std::cout << std::fixed << std::setprecision(2)
+              << "Instrumentation:         " << (EventTracer::compiledIn() ? "compiled in" : "compiled out (-DMTBT_ENABLE_TRACING to enable)") << "\n"
+              << "Timestamp read:          " << tickNs << " ns (virtualized TSCs can be several times slower)\n"
+              << "Scope, recording off:    " << disabledNs << " ns\n"
+              << "Scope, recording on:     " << enabledNs << " ns/event (two TSC reads + ring write)\n"
+              << "Decode, recording off:   " << decodeNs[0] << " ns/msg\n"
+              << "Decode, recording on:    " << decodeNs[1] << " ns/msg (" << summary.recorded / PASSES << " events per pass)\n";
+    return true;
+}
+
+/**
+ * Worst normalized rank error of a table's price and quantity quantiles against exact sorted values
+ */
+double worstRankError(const QuantileTable& table, const std::vector<TradeMessage>& trades) {
+    constexpr double QUANTILES[] = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+    double worst = 0.0;
+    for (std::size_t id = 0; id < table.symbolCount(); ++id) {
+        const auto token = table.tokenAt(id);
+        std::vector<std::uint32_t> prices;
+        std::vector<std::uint32_t> quantities;
+        for (const auto& trade : trades) {
+            if (trade.symbolToken == token) {
+                prices.push_back(trade.priceInPaisa);
+                quantities.push_back(trade.quantity);
+            }
+        }
+        std::sort(prices.begin(), prices.end());
+        std::sort(quantities.begin(), quantities.end());
+        
+        // Error is how far q lies outside the exact rank range of the returned value
+        const auto check = [&](const KllSketch& sketch, const std::vector<std::uint32_t>& exact) {
+            const auto n = static_cast<double>(exact.size());
+            for (const double q : QUANTILES) {
+                const auto value = sketch.quantile(q);
+                const auto low = static_cast<double>(std::lower_bound(exact.begin(), exact.end(), value) - exact.begin()) / n;
+                const auto high = static_cast<double>(std::upper_bound(exact.begin(), exact.end(), value) - exact.begin()) / n;
+                worst = std::max({worst, low - q, q - high});
+            }
+        };
+        check(table.sketchesAt(id).price, prices);
+        check(table.sketchesAt(id).quantity, quantities);
+    }
+    return worst;
+}
+
+/**
+ * Sketch update cost, accuracy against exact quantiles, and merged accuracy
+ */
+bool runQuantilesBenchmark(const BenchmarkOptions& options) {
+    printHeader("Per-symbol KLL quantile sketches");
+    
+    BenchmarkOptions sized = options;
+    sized.messageCount = std::max<std::size_t>(options.messageCount, 2'000'000);
+    const auto trades = generateSessionTrades(sized, 1);
+    
+    // Ingest with a concurrent reader querying the published snapshot
+    QuantileTracker tracker{};
+    std::atomic<bool> ingesting{true};
+    std::uint64_t queries = 0;
+    std::thread reader{[&] {
+        while (ingesting.load(std::memory_order_relaxed)) {
+            const auto snapshot = tracker.snapshot();
+            if (snapshot->symbolCount() > 0) {
+                queries += snapshot->sketchesAt(0).quantity.quantile(0.99) > 0 ? 1 : 0;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }};
+    const auto start = std::chrono::steady_clock::now();
+    tracker.onTrades(trades);
+    const double updateNs = nsPerItem(std::chrono::steady_clock::now() - start, trades.size());
+    ingesting.store(false, std::memory_order_relaxed);
+    reader.join();
+    
+    // Same trades over four "workers", then merged
+    std::vector<QuantileTable> workers(4);
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        workers[i % workers.size()].add(trades[i]);
+    }
+    const auto mergeStart = std::chrono::steady_clock::now();
+    QuantileTable merged;
+    for (const auto& worker : workers) {
+        merged.merge(worker);
+    }
+    const auto mergeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - mergeStart).count();
+    
+    // Exact quantiles need every trade kept and sorted
+    const auto exactStart = std::chrono::steady_clock::now();
+    std::vector<std::uint32_t> exactQuantities(trades.size());
+    std::transform(trades.begin(), trades.end(), exactQuantities.begin(), [](const TradeMessage& t) { return t.quantity; });
+    std::sort(exactQuantities.begin(), exactQuantities.end());
+    const double exactNs = nsPerItem(std::chrono::steady_clock::now() - exactStart, trades.size());
+    
+    const auto& table = tracker.table();
+    std::cout << std::fixed << std::setprecision(2)
+              << "Trades:                  " << trades.size() << " over " << table.symbolCount() << " symbols\n"
+              << "Update (price + qty):    " << updateNs << " ns/trade, snapshot every "
+              << QuantileTracker::Config{}.publishInterval << " trades, " << queries << " concurrent reads\n"
+              << "Exact (copy + sort qty): " << exactNs << " ns/trade, " << trades.size() * sizeof(std::uint32_t) / 1024
+              << " KB per field\n"
+              << "Sketch memory:           " << table.memoryBytes() / std::max<std::size_t>(table.symbolCount(), 1)
+              << " bytes/symbol (k=" << KllSketch::DEFAULT_K << ")\n"
+              << std::setprecision(3)
+              << "Worst rank error:        " << 100.0 * worstRankError(table, trades) << "% single sketch, "
+              << 100.0 * worstRankError(merged, trades) << "% merged from 4 (p1..p99, price and qty)\n"
+              << "Merge of 4 tables:       " << mergeUs << " μs\n";
+    return true;
+}
+
+/**
+ * Loopback TCP fan-out: one publisher, 1-64 subscriber threads, plus a stalled one that must be dropped
+ */
+bool runTcpBenchmark(const BenchmarkOptions& options) {
+#if defined(__linux__)
+    struct SubscriberResult {
+        std::atomic<std::uint64_t> received{0};
+        std::atomic<bool> finished{false};   // Also set when dropped, so nothing waits on it forever
+        std::uint64_t gaps{0};
+        LatencyHistogram latency;
+    };
+    
+    constexpr std::uint64_t PACED_MESSAGES = 20'000;
+    constexpr std::uint64_t PACED_RATE = 100'000;     // msgs/sec in the latency phase
+    constexpr std::size_t PACED_FLUSH_EVERY = 10;     // A batch every 100 μs
+    const auto trades = generateSessionTrades(options, 1000);
+    const std::uint64_t blast = trades.size();
+    const std::uint64_t blastBatches = (blast + 255) / 256;
+    
+    printHeader("Loopback TCP publisher: 1 epoll loop, N subscribers");
+    std::cout << blast << " trades flat out in batches of 256, then " << PACED_MESSAGES << " paced at "
+              << PACED_RATE << " msg/s (batch every " << PACED_FLUSH_EVERY << "); latency is batch seal -> receive\n\n"
+              << std::left << std::setw(8) << "Subs" << std::setw(14) << "Publish ns" << std::setw(16) << "Fan-out Mmsg/s"
+              << std::setw(10) << "MB/s" << std::setw(12) << "Sends" << std::setw(10) << "p50 μs"
+              << std::setw(10) << "p99 μs" << "Gaps\n";
+    
+    for (const std::size_t subscribers : {1, 4, 16, 64}) {
+        TcpPublisher publisher{};
+        if (!publisher.listening()) {
+            std::cerr << "❌ Could not listen on loopback\n";
+            return false;
+        }
+        
+        const std::uint64_t expected = blast + PACED_MESSAGES;
+        std::vector<SubscriberResult> results(subscribers);
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> connected{0};
+        for (std::size_t s = 0; s < subscribers; ++s) {
+            threads.emplace_back([&, s] {
+                auto subscriber = TcpSubscriber::connect("127.0.0.1", publisher.port());
+                connected.fetch_add(1);
+                auto& result = results[s];
+                while (subscriber && result.received < expected && subscriber->connected()) {
+                    const auto received = subscriber->receive([](const TradeMessage&) {});
+                    result.received += received;
+                    if (received > 0 && subscriber->lastBatch() >= blastBatches) {
+                        result.latency.record(steadyNowNs() - subscriber->lastSendTimeNs());
+                    }
+                }
+                result.gaps = subscriber ? subscriber->getStats().batchGaps : 0;
+                result.finished.store(true);
+            });
+        }
+        while (connected.load() < subscribers || publisher.clientCount() < subscribers) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        
+        const auto start = std::chrono::steady_clock::now();
+        publisher.publish(trades);
+        publisher.flush();
+        const auto published = std::chrono::steady_clock::now() - start;
+        
+        // Throughput runs until every subscriber holds the whole blast
+        while (std::any_of(results.begin(), results.end(), [&](const auto& result) {
+            return result.received < blast && !result.finished;
+        })) {
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+        }
+        const auto blastEnded = std::chrono::steady_clock::now() - start;
+        
+        const std::uint64_t pacedStart = steadyNowNs();
+        for (std::uint64_t i = 0; i < PACED_MESSAGES; ++i) {
+            const std::uint64_t due = pacedStart + i * 1'000'000'000ull / PACED_RATE;
+            while (steadyNowNs() < due) {
+            }
+            publisher.publish(trades[i % trades.size()]);
+            if ((i + 1) % PACED_FLUSH_EVERY == 0) {
+                publisher.flush();
+            }
+        }
+        publisher.flush();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        LatencyHistogram latency;
+        std::uint64_t gaps = 0;
+        for (const auto& result : results) {
+            latency.merge(result.latency);
+            gaps += result.gaps;
+        }
+        const auto stats = publisher.getStats();
+        const double seconds = std::chrono::duration<double>(blastEnded).count();
+        const double delivered = static_cast<double>(blast * subscribers);
+        std::cout << std::left << std::setw(8) << subscribers
+                  << std::setw(14) << std::fixed << std::setprecision(1) << nsPerItem(published, blast)
+                  << std::setw(16) << std::setprecision(2) << delivered / seconds / 1e6
+                  << std::setw(10) << std::setprecision(0) << delivered * ProtocolConstants::MESSAGE_SIZE / seconds / 1e6
+                  << std::setw(12) << stats.sendCalls
+                  << std::setw(10) << std::setprecision(1) << static_cast<double>(latency.percentile(0.5)) / 1000.0
+                  << std::setw(10) << static_cast<double>(latency.percentile(0.99)) / 1000.0 << gaps << "\n";
+    }
+    
+    // A subscriber that stops reading is cut off once its queue passes the limit; the others are unaffected
+    TcpPublisher::Config slowConfig{};
+    slowConfig.maxQueuedBytes = 4 << 20;
+    TcpPublisher publisher{slowConfig};
+    const auto stalled = TcpSubscriber::connect("127.0.0.1", publisher.port());
+    std::atomic<std::uint64_t> healthyReceived{0};
+    std::atomic<bool> healthyFinished{false};
+    std::thread healthy{[&] {
+        auto subscriber = TcpSubscriber::connect("127.0.0.1", publisher.port());
+        while (subscriber && healthyReceived.load() < blast * 4 && subscriber->connected()) {
+            healthyReceived += subscriber->receive([](const TradeMessage&) {});
+        }
+        healthyFinished.store(true);
+    }};
+    while (publisher.clientCount() < 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    // Chunks the reading subscriber keeps up with, so only the stalled one can outgrow its queue
+    constexpr std::size_t CHUNK = 8192;
+    std::uint64_t sent = 0;
+    for (int round = 0; round < 4; ++round) {
+        for (std::size_t first = 0; first < trades.size(); first += CHUNK) {
+            const std::size_t last = std::min(first + CHUNK, trades.size());
+            for (std::size_t i = first; i < last; ++i) {
+                publisher.publish(trades[i]);
+            }
+            publisher.flush();
+            sent += last - first;
+            while (healthyReceived.load() < sent && !healthyFinished.load()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    healthy.join();
+    const auto stats = publisher.getStats();
+    std::cout << "\nStalled subscriber with a " << (slowConfig.maxQueuedBytes >> 20) << " MB queue limit: "
+              << (stats.slowDisconnects == 1 ? "disconnected" : "NOT disconnected") << "; the reading subscriber got "
+              << healthyReceived << "/" << blast * 4 << " trades\n";
+    return stats.slowDisconnects == 1 && healthyReceived == blast * 4;
+#else
+    (void)options;
+    std::cerr << "❌ The TCP benchmark needs Linux sockets\n";
+    return false;
+#endif
+}
+
+/**
+ * Conflation writer cost with 0-4 readers draining at different speeds, and reader work per drain
+ */
+bool runConflationBenchmark(const BenchmarkOptions& options) {
+    struct Scenario {
+        const char* name;
+        std::vector<std::uint64_t> drainIntervalsUs;   // One reader per entry
+    };
+    struct ReaderResult {
+        std::uint64_t drains{0};
+        std::uint64_t delivered{0};
+        std::uint64_t maxPerDrain{0};
+    };
+    
+    constexpr std::uint32_t HOT_SYMBOLS = 50;
+    constexpr std::uint32_t COLD_SYMBOLS = 2000;
+    constexpr int PASSES = 5;
+    
+    // 80% of trades on a few hot symbols, the rest spread thin: what a full-market feed looks like
+    auto trades = generateSessionTrades(options, 1000);
+    std::mt19937 rng{options.seed};
+    for (auto& trade : trades) {
+        const bool hot = rng() % 10 < 8;
+        trade.symbolToken = 10'000 + (hot ? rng() % HOT_SYMBOLS : HOT_SYMBOLS + rng() % COLD_SYMBOLS);
+    }
+    const std::uint64_t total = trades.size() * PASSES;
+    
+    printHeader("Per-symbol conflation: 1 writer, readers at their own pace");
+    std::cout << total << " trades over " << HOT_SYMBOLS + COLD_SYMBOLS << " symbols (80% on " << HOT_SYMBOLS
+              << "); a reader's work is bounded by symbols changed, not trades\n\n"
+              << std::left << std::setw(26) << "Readers (drain every)" << std::setw(14) << "Writer ns"
+              << std::setw(10) << "Drains" << std::setw(12) << "Delivered" << std::setw(12) << "Max/drain"
+              << "Trades per update\n";
+    
+    const Scenario scenarios[] = {
+        {"none", {}},
+        {"1 x 50us", {50}},
+        {"1 x 20ms", {20'000}},
+        {"4 x 50us..20ms", {50, 1'000, 5'000, 20'000}},
+    };
+    for (const auto& scenario : scenarios) {
+        Conflator conflator{};
+        std::vector<ReaderResult> results(scenario.drainIntervalsUs.size());
+        std::vector<std::thread> readers;
+        std::atomic<bool> done{false};
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            const auto reader = conflator.attachReader();
+            if (!reader) {
+                return false;
+            }
+            readers.emplace_back([&, r, id = *reader] {
+                auto& result = results[r];
+                for (bool last = false; !last;) {
+                    last = done.load(std::memory_order_acquire);
+                    const auto delivered = conflator.drain(id, [](const Conflator::SymbolState&) {});
+                    result.delivered += delivered;
+                    result.maxPerDrain = std::max<std::uint64_t>(result.maxPerDrain, delivered);
+                    ++result.drains;
+                    std::this_thread::sleep_for(std::chrono::microseconds{scenario.drainIntervalsUs[r]});
+                }
+            });
+        }
+        
+        const auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; ++pass) {
+            conflator.update(trades);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        done.store(true, std::memory_order_release);
+        for (auto& thread : readers) {
+            thread.join();
+        }
+        
+        ReaderResult summed;
+        for (const auto& result : results) {
+            summed.drains += result.drains;
+            summed.delivered += result.delivered;
+            summed.maxPerDrain = std::max(summed.maxPerDrain, result.maxPerDrain);
+        }
+        std::cout << std::left << std::setw(26) << scenario.name
+                  << std::setw(14) << std::fixed << std::setprecision(1) << nsPerItem(elapsed, total);
+        if (results.empty()) {
+            std::cout << std::setw(10) << "-" << std::setw(12) << "-" << std::setw(12) << "-" << "-\n";
+        } else {
+            std::cout << std::setw(10) << summed.drains << std::setw(12) << summed.delivered
+                      << std::setw(12) << summed.maxPerDrain << std::setprecision(1)
+                      << static_cast<double>(total * results.size()) / static_cast<double>(std::max<std::uint64_t>(summed.delivered, 1))
+                      << "\n";
+        }
+    }
+    std::cout << "(Max/drain never exceeds the " << HOT_SYMBOLS + COLD_SYMBOLS
+              << " symbols however far behind a reader falls)\n";
+    return true;
+}
+
+/**
+ * One writer process, 1-8 reader processes on the shared-memory trade ring
+ */
+bool runIpcBenchmark(const BenchmarkOptions& options) {
+#if defined(__linux__)
+    struct ReaderResult {
+        std::uint64_t received{0};
+        std::uint64_t lost{0};
+        std::uint64_t p50{0};
+        std::uint64_t p99{0};
+        std::uint64_t p999{0};
+        std::uint64_t max{0};
+    };
+    
+    constexpr const char* RING_NAME = "/nse_mtbt_bench_ring";
+    constexpr std::size_t RING_CAPACITY = 1 << 16;
+    constexpr std::uint64_t PUBLISH_RATE = 1'000'000; // msgs/sec, paced so readers can keep up
+    const std::uint64_t total = options.messageCount;
+    
+    printHeader("Shared-memory trade ring: 1 writer, N reader processes");
+    std::cout << total << " messages per run, paced at " << PUBLISH_RATE << " msg/s, ring of "
+              << RING_CAPACITY << " slots; latency is publish -> reader copy-out\n\n"
+              << std::left << std::setw(9) << "Readers" << std::setw(14) << "Writer ns/msg"
+              << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns" << std::setw(12) << "p99.9 ns"
+              << std::setw(12) << "max ns" << "Lost\n";
+    
+    for (const std::size_t readers : {1, 2, 4, 8}) {
+        auto writer = TradeRing::create(RING_NAME, RING_CAPACITY);
+        if (!writer) {
+            std::cerr << "❌ Could not create " << RING_NAME << "\n";
+            return false;
+        }
+        
+        std::vector<pid_t> children;
+        std::vector<int> resultPipes;
+        int readyPipe[2];
+        if (::pipe(readyPipe) != 0) {
+            return false;
+        }
+        
+        for (std::size_t r = 0; r < readers; ++r) {
+            int resultPipe[2];
+            if (::pipe(resultPipe) != 0) {
+                return false;
+            }
+            const pid_t pid = ::fork();
+            if (pid == 0) {
+                // Reader process: attach, signal readiness, consume until the writer is done
+                auto reader = TradeRing::attach(RING_NAME);
+                const char ready = reader ? 1 : 0;
+                (void)!::write(readyPipe[1], &ready, 1);
+                ReaderResult result;
+                if (reader) {
+                    LatencyHistogram histogram;
+                    TradeMessage message;
+                    while (result.received + reader->lostMessages() < total) {
+                        const auto status = reader->poll(message);
+                        if (status == TradeRing::PollResult::MESSAGE) {
+                            histogram.record(steadyNowNs() - message.timestamp);
+                            ++result.received;
+                        } else if (status == TradeRing::PollResult::EMPTY) {
+                            std::this_thread::yield();
+                        }
+                    }
+                    result.lost = reader->lostMessages();
+                    result.p50 = histogram.percentile(0.5);
+                    result.p99 = histogram.percentile(0.99);
+                    result.p999 = histogram.percentile(0.999);
+                    result.max = histogram.max();
+                }
+                (void)!::write(resultPipe[1], &result, sizeof(result));
+                ::_exit(0);
+            }
+            ::close(resultPipe[1]);
+            children.push_back(pid);
+            resultPipes.push_back(resultPipe[0]);
+        }
+        
+        for (std::size_t r = 0; r < readers; ++r) {
+            char ready = 0;
+            (void)!::read(readyPipe[0], &ready, 1);
+        }
+        ::close(readyPipe[0]);
+        ::close(readyPipe[1]);
+        
+        // Writer: stamp each trade with its publish time
+        TradeMessage message{1, 2885, 0, 154325, 100, TradeSide::BUY};
+        const std::uint64_t start = steadyNowNs();
+        std::uint64_t writeNs = 0;
+        for (std::uint64_t i = 0; i < total; ++i) {
+            const std::uint64_t due = start + i * 1'000'000'000ull / PUBLISH_RATE;
+            while (steadyNowNs() < due) {
+            }
+            const std::uint64_t before = steadyNowNs();
+            message.sequenceNumber = static_cast<std::uint32_t>(i + 1);
+            message.timestamp = before;
+            writer->publish(message);
+            writeNs += steadyNowNs() - before;
+        }
+        
+        ReaderResult worst;
+        std::uint64_t p50Sum = 0;
+        std::uint64_t lost = 0;
+        for (std::size_t r = 0; r < readers; ++r) {
+            ReaderResult result;
+            (void)!::read(resultPipes[r], &result, sizeof(result));
+            ::close(resultPipes[r]);
+            ::waitpid(children[r], nullptr, 0);
+            p50Sum += result.p50;
+            lost += result.lost;
+            worst.p99 = std::max(worst.p99, result.p99);
+            worst.p999 = std::max(worst.p999, result.p999);
+            worst.max = std::max(worst.max, result.max);
+        }
+        TradeRing::unlink(RING_NAME);
+        
+        std::cout << std::left << std::setw(9) << readers
+                  << std::setw(14) << std::fixed << std::setprecision(1) << static_cast<double>(writeNs) / static_cast<double>(total)
+                  << std::setw(12) << p50Sum / readers << std::setw(12) << worst.p99
+                  << std::setw(12) << worst.p999 << std::setw(12) << worst.max << lost << "\n";
+    }
+    std::cout << "(p50 averaged over readers; p99/p99.9/max are the worst reader)\n";
+    return true;
+#else
+    (void)options;
+    std::cerr << "❌ The IPC benchmark needs Linux shared memory\n";
+    return false;
+#endif
+}
+
+/**
+ * Registered benchmarks
+ */
+struct BenchmarkEntry {
+    const char* name;
+    const char* description;
+    bool (*run)(const BenchmarkOptions&);
+};
+
+const BenchmarkEntry BENCHMARKS[] = {
+    {"ipc", "Shared-memory trade ring latency, 1 writer / 1-8 reader processes", runIpcBenchmark},
+    {"bars", "Per-trade cost of 1s/1m OHLCV+VWAP bars vs decoding", runBarsBenchmark},
+    {"index", "Per-trade update and tick latency for 500 overlapping indices", runIndexBenchmark},
+    {"merge", "Timestamp merge of 1-8 captures, inline vs decode-ahead", runMergeBenchmark},
+    {"ingest", "Cold-cache capture ingest: mmap vs read vs io_uring (--input to use a file)", runIngestBenchmark},
+    {"latency", "Tick-to-decode latency histograms by load level and batch size", runLatencyBenchmark},
+    {"history", "Columnar per-symbol trade history: bytes/trade and query latency", runHistoryBenchmark},
+    {"limits", "Per-instrument limit checks: per-message vs SIMD batch bitmask", runLimitsBenchmark},
+    {"streams", "16-stream segment: global decoder vs per-stream demux on 1-4 threads", runStreamsBenchmark},
+    {"tracer", "Event tracer cost per scope and per traced decode", runTracerBenchmark},
+    {"quantiles", "Per-symbol KLL price/size sketches: update cost and rank error vs exact", runQuantilesBenchmark},
+    {"tcp", "Loopback TCP publisher fan-out to 1-64 subscribers: throughput, latency, slow-consumer drop", runTcpBenchmark},
+    {"conflate", "Per-symbol conflation: writer cost vs reader count/speed, reader work per drain", runConflationBenchmark},
+};
+
+} // namespace
+
+bool runBenchmark(const std::string& name, const BenchmarkOptions& options) {
+    for (const auto& entry : BENCHMARKS) {
+        if (name == entry.name) {
+            return entry.run(options);
+        }
+    }
+    std::cerr << "❌ Unknown benchmark: " << name << "\n";
+    return false;
+}
+
+std::vector<std::string> listBenchmarks() {
+    std::vector<std::string> result;
+    for (const auto& entry : BENCHMARKS) {
+        result.push_back(std::string{entry.name} + " - " + entry.description);
+    }
+    return result;
+}
+
+} // namespace nse::mtbt::bench
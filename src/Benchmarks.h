@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nse::mtbt::bench {
+
+/**
+ * Options shared by all benchmarks
+ */
+struct BenchmarkOptions {
+    std::size_t messageCount{200'000};
+    std::uint32_t seed{42};
+    std::vector<std::string> inputs{};   // Capture files, for benchmarks that read them
+};
+
+/**
+ * Run a named benchmark (see listBenchmarks()); false if unknown or it failed
+ */
+[[nodiscard]] bool runBenchmark(const std::string& name, const BenchmarkOptions& options);
+
+/**
+ * "name - description" lines for --help
+ */
+[[nodiscard]] std::vector<std::string> listBenchmarks();
+
+} // namespace nse::mtbt::bench
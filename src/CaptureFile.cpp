@@ -0,0 +1,107 @@
+#include "CaptureFile.h"
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt {
+
+std::optional<CaptureFile> CaptureFile::open(const std::string& path) {
+    CaptureFile capture;
+    capture.path_ = path;
+    
+#if defined(__linux__)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    capture.size_ = static_cast<std::size_t>(info.st_size);
+    if (capture.size_ > 0) {
+        void* mapping = ::mmap(nullptr, capture.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        ::madvise(mapping, capture.size_, MADV_SEQUENTIAL);
+        capture.data_ = static_cast<const std::uint8_t*>(mapping);
+        capture.mapped_ = true;
+    }
+    ::close(fd); // The mapping keeps the file referenced
+#else
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    capture.buffer_.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    capture.data_ = capture.buffer_.data();
+    capture.size_ = capture.buffer_.size();
+#endif
+    
+    return capture;
+}
+
+bool CaptureFile::write(const std::string& path, const std::vector<std::uint8_t>& data) {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+CaptureFile::CaptureFile(CaptureFile&& other) noexcept
+    : path_{std::move(other.path_)}, data_{other.data_}, size_{other.size_},
+      mapped_{other.mapped_}, buffer_{std::move(other.buffer_)} {
+    if (!mapped_) {
+        data_ = buffer_.data();
+    }
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapped_ = false;
+}
+
+CaptureFile& CaptureFile::operator=(CaptureFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        path_ = std::move(other.path_);
+        data_ = other.data_;
+        size_ = other.size_;
+        mapped_ = other.mapped_;
+        buffer_ = std::move(other.buffer_);
+        if (!mapped_) {
+            data_ = buffer_.data();
+        }
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = false;
+    }
+    return *this;
+}
+
+CaptureFile::~CaptureFile() {
+    release();
+}
+
+void CaptureFile::release() noexcept {
+#if defined(__linux__)
+    if (mapped_ && data_) {
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Read-only view of a recorded raw MTBT capture (back-to-back 40-byte frames)
+ *
+ * Memory-mapped on Linux; other platforms read the file into memory.
+ */
+class CaptureFile {
+public:
+    /**
+     * Open a capture file; nullopt if it cannot be read
+     */
+    [[nodiscard]] static std::optional<CaptureFile> open(const std::string& path);
+
+    /**
+     * Write raw feed bytes as a capture file
+     */
+    [[nodiscard]] static bool write(const std::string& path, const std::vector<std::uint8_t>& data);
+
+    CaptureFile(const CaptureFile&) = delete;
+    CaptureFile& operator=(const CaptureFile&) = delete;
+    CaptureFile(CaptureFile&& other) noexcept;
+    CaptureFile& operator=(CaptureFile&& other) noexcept;
+    ~CaptureFile();
+
+    [[nodiscard]] const std::uint8_t* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] const std::string& path() const noexcept { return path_; }
+
+private:
+    CaptureFile() = default;
+
+    std::string path_;
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+    bool mapped_{false};
+    std::vector<std::uint8_t> buffer_; // Fallback storage when not mapped
+
+    void release() noexcept;
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,152 @@
+#include "CaptureIndex.h"
+#include "Decoder.h"
+#include "MessageTypes.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr std::uint32_t INDEX_MAGIC = 0x5849544D; // "MTIX"
+constexpr std::uint16_t INDEX_VERSION = 2;   // v1 maxima included damaged frames
+
+template<typename T>
+void put(std::vector<std::uint8_t>& buffer, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        buffer.push_back(static_cast<std::uint8_t>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+std::uint32_t checksum(const std::uint8_t* data, std::size_t size) noexcept {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+CaptureIndex CaptureIndex::build(const std::uint8_t* data, std::size_t size, std::uint64_t intervalFrames) {
+    CaptureIndex index;
+    index.intervalFrames_ = std::max<std::uint64_t>(intervalFrames, 1);
+    index.captureSize_ = size;
+    
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+    const std::uint64_t frameCount = size / FRAME;
+    index.entries_.reserve(frameCount / index.intervalFrames_ + 1);
+    
+    std::uint64_t maxTimestamp = 0;
+    std::uint32_t maxSequence = 0;
+    for (std::uint64_t frame = 0; frame < frameCount; ++frame) {
+        const std::uint8_t* bytes = data + frame * FRAME;
+        if (frame % index.intervalFrames_ == 0) {
+            index.entries_.push_back({frame * FRAME, maxTimestamp, maxSequence});
+        }
+        // One damaged field would raise every later bound and turn seeks into full scans
+        if (!Decoder::frameTrusted(bytes)) {
+            continue;
+        }
+        maxTimestamp = std::max(maxTimestamp, wire::TradeFrame::Timestamp::load(bytes));
+        maxSequence = std::max(maxSequence, wire::TradeFrame::Sequence::load(bytes));
+    }
+    
+    return index;
+}
+
+std::uint64_t CaptureIndex::offsetForTimestamp(std::uint64_t timestamp) const noexcept {
+    // First entry whose preceding frames already reach the target, then step back one
+    const auto it = std::partition_point(entries_.begin(), entries_.end(),
+                                         [timestamp](const Entry& entry) { return entry.maxTimestampBefore < timestamp; });
+    return it == entries_.begin() ? 0 : std::prev(it)->offset;
+}
+
+std::uint64_t CaptureIndex::offsetForSequence(std::uint32_t sequence) const noexcept {
+    const auto it = std::partition_point(entries_.begin(), entries_.end(),
+                                         [sequence](const Entry& entry) { return entry.maxSequenceBefore < sequence; });
+    return it == entries_.begin() ? 0 : std::prev(it)->offset;
+}
+
+bool CaptureIndex::save(const std::string& path) const {
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(32 + entries_.size() * 20);
+    
+    put(buffer, INDEX_MAGIC);
+    put(buffer, INDEX_VERSION);
+    put(buffer, std::uint16_t{0}); // Reserved
+    put(buffer, intervalFrames_);
+    put(buffer, captureSize_);
+    put(buffer, static_cast<std::uint64_t>(entries_.size()));
+    for (const auto& entry : entries_) {
+        put(buffer, entry.offset);
+        put(buffer, entry.maxTimestampBefore);
+        put(buffer, entry.maxSequenceBefore);
+    }
+    put(buffer, checksum(buffer.data(), buffer.size()));
+    
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+std::optional<CaptureIndex> CaptureIndex::load(const std::string& path, std::uint64_t captureSize) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    const std::vector<std::uint8_t> buffer{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    
+    constexpr std::size_t HEADER_SIZE = 32;
+    constexpr std::size_t ENTRY_SIZE = 20;
+    if (buffer.size() < HEADER_SIZE + 4) {
+        return std::nullopt;
+    }
+    const std::size_t payloadSize = buffer.size() - 4;
+    if (wire::load<std::uint32_t>(buffer.data() + payloadSize) != checksum(buffer.data(), payloadSize)) {
+        return std::nullopt;
+    }
+    
+    const std::uint8_t* header = buffer.data();
+    if (wire::load<std::uint32_t>(header) != INDEX_MAGIC ||
+        wire::load<std::uint16_t>(header + 4) != INDEX_VERSION) {
+        return std::nullopt;
+    }
+    
+    CaptureIndex index;
+    index.intervalFrames_ = wire::load<std::uint64_t>(header + 8);
+    index.captureSize_ = wire::load<std::uint64_t>(header + 16);
+    const auto entryCount = wire::load<std::uint64_t>(header + 24);
+    if (index.captureSize_ != captureSize || index.intervalFrames_ == 0 ||
+        entryCount != (payloadSize - HEADER_SIZE) / ENTRY_SIZE || (payloadSize - HEADER_SIZE) % ENTRY_SIZE != 0) {
+        return std::nullopt; // Stale sidecar (capture grew) or truncated file
+    }
+    
+    index.entries_.resize(entryCount);
+    const std::uint8_t* cursor = buffer.data() + HEADER_SIZE;
+    for (auto& entry : index.entries_) {
+        entry.offset = wire::load<std::uint64_t>(cursor);
+        entry.maxTimestampBefore = wire::load<std::uint64_t>(cursor + 8);
+        entry.maxSequenceBefore = wire::load<std::uint32_t>(cursor + 16);
+        cursor += ENTRY_SIZE;
+    }
+    
+    return index;
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Sparse seek index over a raw capture, stored next to it as "<capture>.idx"
+ *
+ * One entry every N frames records the frame's byte offset and the highest
+ * sequence number / timestamp seen in all intact frames before it (see
+ * Decoder::frameTrusted). Those running maxima are monotonic even when the
+ * capture has out-of-order frames, and damaged ones cannot inflate them, so
+ * both lookups are binary searches that never skip an intact frame matching
+ * the target.
+ */
+class CaptureIndex {
+public:
+    /**
+     * Seek checkpoint
+     */
+    struct Entry {
+        std::uint64_t offset{0};             // Byte offset of a frame boundary
+        std::uint64_t maxTimestampBefore{0}; // Highest timestamp in intact frames [0, offset)
+        std::uint32_t maxSequenceBefore{0};  // Highest sequence in intact frames [0, offset)
+    };
+
+    static constexpr std::uint64_t DEFAULT_INTERVAL = 4096;
+
+    /**
+     * Build an index in one pass over back-to-back frames
+     */
+    [[nodiscard]] static CaptureIndex build(const std::uint8_t* data, std::size_t size,
+                                            std::uint64_t intervalFrames = DEFAULT_INTERVAL);
+
+    /**
+     * Sidecar location for a capture file
+     */
+    [[nodiscard]] static std::string sidecarPath(const std::string& capturePath) { return capturePath + ".idx"; }
+
+    /**
+     * Load a sidecar; nullopt if missing, corrupt or built for a different capture size
+     */
+    [[nodiscard]] static std::optional<CaptureIndex> load(const std::string& path, std::uint64_t captureSize);
+
+    [[nodiscard]] bool save(const std::string& path) const;
+
+    /**
+     * Latest checkpoint offset such that no earlier frame has timestamp >= target
+     */
+    [[nodiscard]] std::uint64_t offsetForTimestamp(std::uint64_t timestamp) const noexcept;
+
+    /**
+     * Latest checkpoint offset such that no earlier frame has sequence >= target
+     */
+    [[nodiscard]] std::uint64_t offsetForSequence(std::uint32_t sequence) const noexcept;
+
+    [[nodiscard]] const std::vector<Entry>& entries() const noexcept { return entries_; }
+    [[nodiscard]] std::uint64_t intervalFrames() const noexcept { return intervalFrames_; }
+    [[nodiscard]] std::uint64_t captureSize() const noexcept { return captureSize_; }
+
+private:
+    CaptureIndex() = default;
+
+    std::uint64_t intervalFrames_{DEFAULT_INTERVAL};
+    std::uint64_t captureSize_{0};
+    std::vector<Entry> entries_;
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,197 @@
+#include "Checkpoint.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr std::uint32_t CHECKPOINT_MAGIC = 0x4B43544D; // "MTCK"
+constexpr std::uint16_t CHECKPOINT_VERSION = 4;
+
+/**
+ * Visit DecodingStats counters in their on-disk order
+ */
+template<typename Stats, typename Visitor>
+void forEachStatsField(Stats& stats, Visitor&& visit) {
+    visit(stats.decodedMessages);
+    visit(stats.validMessages);
+    visit(stats.errorCount);
+    visit(stats.bytesProcessed);
+    visit(stats.truncatedBytes);
+    visit(stats.totalTimeUs);
+    visit(stats.processingSpeed);
+    visit(stats.crcErrors);
+    visit(stats.protocolErrors);
+    visit(stats.sequenceGaps);
+    visit(stats.missingMessages);
+    visit(stats.filteredMessages);
+    visit(stats.limitViolations);
+    visit(stats.suspectSequences);
+}
+
+template<typename T>
+void put(std::vector<std::uint8_t>& buffer, T value) {
+    // Little-endian, independent of host byte order
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        buffer.push_back(static_cast<std::uint8_t>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+/**
+ * Bounds-checked little-endian reader
+ */
+class ByteReader {
+public:
+    ByteReader(const std::uint8_t* data, std::size_t size) noexcept : data_{data}, size_{size} {}
+    
+    template<typename T>
+    [[nodiscard]] bool get(T& value) noexcept {
+        if (offset_ + sizeof(T) > size_) {
+            return false;
+        }
+        value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<T>(data_[offset_ + i]) << (i * 8));
+        }
+        offset_ += sizeof(T);
+        return true;
+    }
+    
+    [[nodiscard]] std::size_t offset() const noexcept { return offset_; }
+    
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t offset_{0};
+};
+
+std::uint32_t checksum(const std::uint8_t* data, std::size_t size) noexcept {
+    // FNV-1a: cheap corruption check for a file we write ourselves
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(Config config) : config_{std::move(config)} {
+    worker_ = std::thread{[this] { run(); }};
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock{slotMutex_};
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock{slotMutex_};
+    for (;;) {
+        wakeup_.wait(lock, [this] { return hasPending_ || stopping_; });
+        if (!hasPending_) {
+            return; // Stopping with nothing left to write
+        }
+        
+        // Swap buffers and release the lock before touching storage
+        std::swap(pending_, writing_);
+        hasPending_ = false;
+        lock.unlock();
+        
+        if (saveCheckpoint(config_.path, writing_)) {
+            writtenCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        lock.lock();
+    }
+}
+
+bool saveCheckpoint(const std::string& path, const Decoder::Snapshot& snapshot) {
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(128 + snapshot.gaps.size() * 8);
+    
+    put(buffer, CHECKPOINT_MAGIC);
+    put(buffer, CHECKPOINT_VERSION);
+    put(buffer, std::uint16_t{0}); // Reserved
+    put(buffer, snapshot.captureOffset);
+    put(buffer, snapshot.lastSequence);
+    forEachStatsField(snapshot.stats, [&](std::uint64_t value) { put(buffer, value); });
+    put(buffer, static_cast<std::uint32_t>(snapshot.gaps.size()));
+    for (const auto& gap : snapshot.gaps) {
+        put(buffer, gap.firstMissing);
+        put(buffer, gap.lastMissing);
+    }
+    put(buffer, checksum(buffer.data(), buffer.size()));
+    
+    // Write-then-rename so a crash mid-write never leaves a torn checkpoint
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+std::optional<Decoder::Snapshot> loadCheckpoint(const std::string& path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    const std::vector<std::uint8_t> buffer{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    if (buffer.size() < 4) {
+        return std::nullopt;
+    }
+    
+    const std::size_t payloadSize = buffer.size() - 4;
+    ByteReader trailer{buffer.data() + payloadSize, 4};
+    std::uint32_t storedChecksum = 0;
+    if (!trailer.get(storedChecksum) || storedChecksum != checksum(buffer.data(), payloadSize)) {
+        return std::nullopt;
+    }
+    
+    ByteReader reader{buffer.data(), payloadSize};
+    std::uint32_t magic = 0;
+    std::uint16_t version = 0;
+    std::uint16_t reserved = 0;
+    if (!reader.get(magic) || magic != CHECKPOINT_MAGIC ||
+        !reader.get(version) || version != CHECKPOINT_VERSION || !reader.get(reserved)) {
+        return std::nullopt;
+    }
+    
+    Decoder::Snapshot snapshot;
+    bool complete = reader.get(snapshot.captureOffset) && reader.get(snapshot.lastSequence);
+    forEachStatsField(snapshot.stats, [&](std::uint64_t& value) { complete = complete && reader.get(value); });
+    
+    std::uint32_t gapCount = 0;
+    if (!complete || !reader.get(gapCount) || gapCount > Decoder::MAX_TRACKED_GAPS) {
+        return std::nullopt;
+    }
+    snapshot.gaps.resize(gapCount);
+    for (auto& gap : snapshot.gaps) {
+        if (!reader.get(gap.firstMissing) || !reader.get(gap.lastMissing)) {
+            return std::nullopt;
+        }
+    }
+    
+    return snapshot;
+}
+
+} // namespace nse::mtbt
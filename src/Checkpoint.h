@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Decoder.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace nse::mtbt {
+
+/**
+ * Background checkpoint writer for fast restart
+ *
+ * The decode loop offers snapshots into a double buffer; a worker thread
+ * swaps the buffers, serializes and persists the snapshot, so slow storage
+ * never stalls decoding (a busy writer just means the offer is skipped).
+ */
+class CheckpointWriter {
+public:
+    /**
+     * Checkpoint configuration
+     */
+    struct Config {
+        std::string path{"decoder.ckpt"};
+        std::uint64_t intervalMessages{100'000};
+        
+        Config() = default;
+    };
+
+    explicit CheckpointWriter(Config config);
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+    CheckpointWriter(CheckpointWriter&&) = delete;
+    CheckpointWriter& operator=(CheckpointWriter&&) = delete;
+
+    /**
+     * Persist any pending snapshot and stop the worker thread
+     */
+    ~CheckpointWriter();
+
+    /**
+     * Fill the back buffer in place; returns false (without waiting) if the worker holds it
+     */
+    template<typename Fill>
+    bool offer(Fill&& fill) {
+        std::unique_lock<std::mutex> lock{slotMutex_, std::try_to_lock};
+        if (!lock.owns_lock()) {
+            skippedCount_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        fill(pending_);
+        hasPending_ = true;
+        lock.unlock();
+        wakeup_.notify_one();
+        return true;
+    }
+
+    /**
+     * Offer a ready-made snapshot
+     */
+    bool offer(const Decoder::Snapshot& snapshot) {
+        return offer([&](Decoder::Snapshot& slot) { slot = snapshot; });
+    }
+
+    [[nodiscard]] const Config& getConfig() const noexcept { return config_; }
+    [[nodiscard]] std::uint64_t writtenCount() const noexcept { return writtenCount_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t skippedCount() const noexcept { return skippedCount_.load(std::memory_order_relaxed); }
+
+private:
+    Config config_;
+    std::mutex slotMutex_;
+    std::condition_variable wakeup_;
+    Decoder::Snapshot pending_{};
+    Decoder::Snapshot writing_{};
+    bool hasPending_{false};
+    bool stopping_{false};
+    std::atomic<std::uint64_t> writtenCount_{0};
+    std::atomic<std::uint64_t> skippedCount_{0};
+    std::thread worker_;
+
+    void run();
+};
+
+/**
+ * Serialize a snapshot into a compact binary file (atomic replace)
+ */
+[[nodiscard]] bool saveCheckpoint(const std::string& path, const Decoder::Snapshot& snapshot);
+
+/**
+ * Load a snapshot; nullopt if missing, truncated or corrupted
+ */
+[[nodiscard]] std::optional<Decoder::Snapshot> loadCheckpoint(const std::string& path);
+
+} // namespace nse::mtbt
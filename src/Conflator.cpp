@@ -0,0 +1,104 @@
+#include "Conflator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr std::size_t WORDS_PER_LINE = CACHE_LINE_SIZE / sizeof(std::uint64_t);
+
+std::size_t roundUpToLine(std::size_t words) noexcept {
+    return (words + WORDS_PER_LINE - 1) / WORDS_PER_LINE * WORDS_PER_LINE;
+}
+
+} // namespace
+
+Conflator::Conflator(Config config)
+    : latest_(std::max<std::size_t>(config.maxSymbols, 1)),
+      slots_{std::make_unique<Slot[]>(latest_.size())},
+      dirtyWords_{(latest_.size() + 63) / 64},
+      summaryWords_{(dirtyWords_ + 63) / 64},
+      dirtyStride_{roundUpToLine(dirtyWords_)},
+      summaryStride_{roundUpToLine(summaryWords_)} {
+    const std::size_t readers = std::clamp<std::size_t>(config.maxReaders, 1, MAX_READERS);
+    dirty_ = std::make_unique<std::atomic<std::uint64_t>[]>(readers * dirtyStride_);
+    summary_ = std::make_unique<std::atomic<std::uint64_t>[]>(readers * summaryStride_);
+    maxReaders_ = readers;
+}
+
+std::optional<std::size_t> Conflator::attachReader() noexcept {
+    auto attached = readers_.load(std::memory_order_acquire);
+    for (;;) {
+        const auto free = ~attached & (maxReaders_ == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << maxReaders_) - 1);
+        if (free == 0) {
+            return std::nullopt;
+        }
+        const auto reader = static_cast<std::size_t>(__builtin_ctzll(free));
+
+        // Everything already published is news to a new reader; mark it before the writer can see the reader
+        auto* dirty = &dirty_[reader * dirtyStride_];
+        auto* summary = &summary_[reader * summaryStride_];
+        const std::size_t assigned = symbolCount();
+        markRange(dirty, 0, assigned);
+        for (std::size_t s = 0; s < summaryWords_; ++s) {
+            summary[s].store(~std::uint64_t{0}, std::memory_order_relaxed);  // Spurious summary bits only cost a load
+        }
+        if (readers_.compare_exchange_weak(attached, attached | (std::uint64_t{1} << reader))) {
+            // A symbol first assigned between the count above and the CAS may have been
+            // marked before the writer saw this reader. The writer fences between storing
+            // assigned_ and loading readers_, so after our fence one side sees the other.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            markRange(dirty, assigned, symbolCount());
+            return reader;
+        }
+    }
+}
+
+void Conflator::markRange(std::atomic<std::uint64_t>* dirty, std::size_t begin, std::size_t end) noexcept {
+    for (std::size_t word = begin / 64; word * 64 < end; ++word) {
+        const std::size_t first = word * 64;
+        const std::uint64_t from = begin > first ? ~std::uint64_t{0} << (begin - first) : ~std::uint64_t{0};
+        const std::uint64_t to = end - first >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << (end - first)) - 1;
+        dirty[word].fetch_or(from & to, std::memory_order_relaxed);  // Never clears: a racing attach may own the bitmap
+    }
+}
+
+void Conflator::detachReader(std::size_t reader) noexcept {
+    readers_.fetch_and(~(std::uint64_t{1} << reader));
+}
+
+void Conflator::store(std::uint32_t slot, const SymbolState& state) noexcept {
+    std::uint64_t words[PAYLOAD_WORDS]{};
+    std::memcpy(words, &state, sizeof(SymbolState));
+
+    Slot& target = slots_[slot];
+    const std::uint64_t sequence = target.sequence.load(std::memory_order_relaxed);
+    target.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+        target.payload[i].store(words[i], std::memory_order_relaxed);
+    }
+    target.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Conflator::read(std::uint32_t slot, SymbolState& state) const noexcept {
+    const Slot& source = slots_[slot];
+    std::uint64_t words[PAYLOAD_WORDS];
+    for (;;) {
+        const std::uint64_t before = source.sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0) {
+            continue;  // Writer is mid-update on this slot
+        }
+        for (std::size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+            words[i] = source.payload[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (source.sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    std::memcpy(&state, words, sizeof(SymbolState));
+}
+
+} // namespace nse::mtbt
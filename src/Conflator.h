@@ -0,0 +1,186 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SpscQueue.h"
+#include "SymbolIndex.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Latest trade and running totals per symbol, for consumers that cannot take every tick
+ *
+ * One writer (the decode thread) overwrites a seqlocked slot per symbol
+ * in a flat array and sets that symbol's bit in every attached reader's
+ * dirty bitmap. A reader drains only the bits set since its previous
+ * drain, so its work is bounded by the number of symbols that changed,
+ * not by the number of trades, and the writer never waits on it: a slow
+ * reader simply sees fewer, more conflated updates.
+ */
+class Conflator {
+public:
+    static constexpr std::size_t MAX_READERS = 64;
+
+    struct Config {
+        std::size_t maxSymbols{4096};   // Slots; trades of further symbols are only counted
+        std::size_t maxReaders{8};      // Dirty bitmaps to allocate (at most MAX_READERS)
+
+        Config() = default;
+    };
+
+    /**
+     * What a consumer sees for one symbol
+     */
+    struct SymbolState {
+        TradeMessage lastTrade{};
+        std::uint64_t cumulativeVolume{0};
+        std::uint64_t turnoverPaisa{0};      // Sum of price * quantity
+        std::uint64_t tradeCount{0};
+
+        [[nodiscard]] double vwapInPaisa() const noexcept {
+            return cumulativeVolume > 0 ? static_cast<double>(turnoverPaisa) / static_cast<double>(cumulativeVolume) : 0.0;
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<SymbolState>, "slots copy states as raw words");
+
+    Conflator() : Conflator(Config{}) {}
+    explicit Conflator(Config config);
+
+    Conflator(const Conflator&) = delete;
+    Conflator& operator=(const Conflator&) = delete;
+
+    /**
+     * Writer: fold one trade into its symbol's slot (wait-free apart from first-sight id assignment)
+     */
+    void update(const TradeMessage& message) {
+        const auto id = symbols_.getOrAssign(message.symbolToken);
+        if (id >= latest_.size()) {
+            ++overflowTrades_;
+            return;
+        }
+        if (id >= assigned_.load(std::memory_order_relaxed)) {
+            assigned_.store(id + 1, std::memory_order_release);
+        }
+        auto& state = latest_[id];
+        state.lastTrade = message;
+        state.cumulativeVolume += message.quantity;
+        state.turnoverPaisa += std::uint64_t{message.priceInPaisa} * message.quantity;
+        ++state.tradeCount;
+        store(id, state);
+        markDirty(id);
+    }
+
+    template<typename Container>
+    void update(const Container& messages) {
+        for (const auto& message : messages) {
+            update(message);
+        }
+    }
+
+    /**
+     * Register a consumer (any thread); every symbol seen so far starts out dirty for it
+     *
+     * Returns the reader id for drain(), or nullopt when maxReaders are attached.
+     */
+    [[nodiscard]] std::optional<std::size_t> attachReader() noexcept;
+
+    /**
+     * Stop tracking changes for a reader; its id may be handed out again
+     */
+    void detachReader(std::size_t reader) noexcept;
+
+    /**
+     * Reader: hand handler(const SymbolState&) each symbol changed since this reader's last drain
+     *
+     * Each reader id must be drained by one thread at a time. Returns the
+     * number of symbols delivered.
+     */
+    template<typename Handler>
+    std::size_t drain(std::size_t reader, Handler&& handler) {
+        auto* summary = &summary_[reader * summaryStride_];
+        auto* dirty = &dirty_[reader * dirtyStride_];
+        std::size_t delivered = 0;
+        SymbolState state;
+        for (std::size_t s = 0; s < summaryWords_; ++s) {
+            for (auto words = summary[s].exchange(0, std::memory_order_acquire); words != 0; words &= words - 1) {
+                const std::size_t word = s * 64 + static_cast<std::size_t>(__builtin_ctzll(words));
+                auto bits = dirty[word].exchange(0);
+                std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with the fence in markDirty()
+                for (; bits != 0; bits &= bits - 1) {
+                    read(static_cast<std::uint32_t>(word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))), state);
+                    handler(state);
+                    ++delivered;
+                }
+            }
+        }
+        return delivered;
+    }
+
+    /**
+     * Consistent copy of one slot (any thread); slot ids are dense, in first-trade order
+     */
+    void read(std::uint32_t slot, SymbolState& state) const noexcept;
+
+    [[nodiscard]] std::size_t symbolCount() const noexcept { return assigned_.load(std::memory_order_acquire); }
+    [[nodiscard]] std::size_t capacity() const noexcept { return latest_.size(); }
+    [[nodiscard]] std::uint64_t overflowTrades() const noexcept { return overflowTrades_; }  // Writer thread
+
+private:
+    static constexpr std::size_t PAYLOAD_WORDS = (sizeof(SymbolState) + 7) / 8;
+
+    /**
+     * Sequence is odd while the writer is mid-update
+     */
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> payload[PAYLOAD_WORDS];
+    };
+
+    // Writer-thread state
+    SymbolIndex symbols_;
+    std::vector<SymbolState> latest_;
+    std::uint64_t overflowTrades_{0};
+
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::size_t> assigned_{0};
+    std::atomic<std::uint64_t> readers_{0};              // Bit r set while reader r is attached
+    std::size_t maxReaders_{1};
+
+    // Per reader: one dirty bit per slot, plus one summary bit per non-empty dirty word
+    std::size_t dirtyWords_{0};
+    std::size_t summaryWords_{0};
+    std::size_t dirtyStride_{0};                         // Rounded to whole cache lines per reader
+    std::size_t summaryStride_{0};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> dirty_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> summary_;
+
+    void store(std::uint32_t slot, const SymbolState& state) noexcept;
+
+    /**
+     * Set dirty bits [begin, end) in one reader's bitmap
+     */
+    static void markRange(std::atomic<std::uint64_t>* dirty, std::size_t begin, std::size_t end) noexcept;
+
+    void markDirty(std::uint32_t slot) noexcept {
+        const std::size_t word = slot >> 6;
+        const std::uint64_t bit = std::uint64_t{1} << (slot & 63);
+        // Orders the slot store before the bit checks: a reader that clears a bit seen set here reads the new state
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto readers = readers_.load(std::memory_order_acquire); readers != 0; readers &= readers - 1) {
+            const auto reader = static_cast<std::size_t>(__builtin_ctzll(readers));
+            auto& dirty = dirty_[reader * dirtyStride_ + word];
+            // A symbol already pending for this reader costs only the load
+            if ((dirty.load(std::memory_order_relaxed) & bit) == 0 && dirty.fetch_or(bit) == 0) {
+                summary_[reader * summaryStride_ + (word >> 6)].fetch_or(std::uint64_t{1} << (word & 63),
+                                                                          std::memory_order_release);
+            }
+        }
+    }
+};
+
+} // namespace nse::mtbt
@@ -1,4 +1,12 @@
 #include "Decoder.h"
+#include "CaptureIndex.h"
+#include "Checkpoint.h"
+#include "EventTracer.h"
+#include "InstrumentLimits.h"
+#include "SubscriptionFilter.h"
+#include "StatsExport.h"
+#include "TraceLogger.h"
+#include <array>
 #include <chrono>
 #include <cstring>
 #include <algorithm>
@@ -7,51 +15,242 @@
 
 namespace nse::mtbt {
 
+namespace {
+
+/**
+ * Slicing-by-8 tables for the reflected CRC32 polynomial 0xEDB88320
+ *
+ * Table 0 is the classic byte-at-a-time table; table t advances a byte
+ * through t further zero bytes, so eight input bytes fold in per step.
+ */
+constexpr std::array<std::array<std::uint32_t, 256>, 8> makeCrc32Tables() noexcept {
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t byte = 0; byte < 256; ++byte) {
+        std::uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0u);
+        }
+        tables[0][byte] = crc;
+    }
+    for (std::size_t t = 1; t < tables.size(); ++t) {
+        for (std::uint32_t byte = 0; byte < 256; ++byte) {
+            tables[t][byte] = (tables[t - 1][byte] >> 8) ^ tables[0][tables[t - 1][byte] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto CRC32_TABLES = makeCrc32Tables();
+
+} // namespace
+
 std::vector<TradeMessage> Decoder::decodeFeed(const std::vector<std::uint8_t>& data) {
-    const auto startTime = std::chrono::high_resolution_clock::now();
-    
+    return decodeFeed(data.data(), data.size());
+}
+
+std::vector<TradeMessage> Decoder::decodeFeed(const std::uint8_t* data, std::size_t size) {
     std::vector<TradeMessage> messages;
-    messages.reserve(data.size() / ProtocolConstants::MESSAGE_SIZE);
+    messages.reserve(size / ProtocolConstants::MESSAGE_SIZE);
+    decodeInto(data, size, messages);
+    return messages;
+}
+
+void Decoder::decodeFeedInto(const std::uint8_t* data, std::size_t size, MessageBuffer& messages) {
+    // Recycle the caller's buffer: only growth beyond its previous high-water mark allocates
+    messages.clear();
+    const std::size_t required = size / ProtocolConstants::MESSAGE_SIZE;
+    if (required > messages.capacity()) {
+        messages.reserve(required);
+        ++stats_.outputAllocations;
+        stats_.outputBytesAllocated += required * sizeof(TradeMessage);
+    } else {
+        ++stats_.outputBufferReuses;
+    }
+    decodeInto(data, size, messages);
+}
+
+template<typename Output>
+void Decoder::decodeInto(const std::uint8_t* data, std::size_t size, Output& messages) {
+    MTBT_TRACE_SCOPE("Decoder::decodeFeed");
+    const auto startTime = std::chrono::high_resolution_clock::now();
     
     std::size_t offset = 0;
     std::uint64_t messageCount = 0;
+    std::uint64_t nextCheckpoint = checkpointInterval_;
+    
+    // Pin one subscription bitmap for the whole batch; updates apply from the next batch
+    std::optional<RcuPointer<SubscriptionFilter::Bitmap>::ReadGuard> subscriptions;
+    if (subscriptionFilter_) {
+        subscriptions.emplace(subscriptionFilter_->acquire());
+    }
+    std::size_t maskBase = 0;
+    std::size_t maskFrames = 0;
+    std::uint32_t subscribedMask = 0;
+    
+    // With instrument limits, parsed messages are appended provisionally and
+    // validated a block at a time; rejected ones are compacted out on flush
+    std::optional<RcuPointer<InstrumentLimits::Table>::ReadGuard> limits;
+    if (instrumentLimits_) {
+        limits.emplace(instrumentLimits_->acquire());
+    }
+    std::size_t pendingBegin = messages.size();
+    std::size_t pendingOffsets[InstrumentLimits::BATCH_MESSAGES];
+    const auto flushPending = [&] {
+        const std::size_t count = messages.size() - pendingBegin;
+        if (count == 0) {
+            return;
+        }
+        const std::uint64_t validMask = InstrumentLimits::validateBatch(**limits, messages.data() + pendingBegin, count);
+        std::size_t kept = pendingBegin;
+        for (std::size_t i = 0; i < count; ++i) {
+            const bool valid = (validMask >> i) & 1u;
+            const std::size_t frameOffset = pendingOffsets[i];
+            const TradeMessage& message = messages[pendingBegin + i];
+            if (valid) {
+                if (traceLogger_) {
+                    traceLogger_->record(TraceLogger::Event::DECODED, TraceLogger::Reason::NONE,
+                                         captureOffset_ + frameOffset, data + frameOffset, size - frameOffset);
+                }
+                messages[kept++] = message;
+                ++stats_.validMessages;
+                continue;
+            }
+            ++stats_.errorCount;
+            // Rare path: tell instrument limits apart from the exchange-wide rules
+            const auto globalResult = message.validate();
+            if (globalResult.isValid) {
+                ++stats_.limitViolations;
+            }
+            if (traceLogger_) {
+                traceLogger_->record(TraceLogger::Event::INVALID,
+                                     globalResult.isValid ? TraceLogger::Reason::INSTRUMENT_LIMITS : TraceLogger::Reason::FIELD_RULES,
+                                     captureOffset_ + frameOffset, data + frameOffset, size - frameOffset);
+            }
+            if (debugMode_) {
+                std::cout << "❌ Validation failed: "
+                          << (globalResult.isValid ? "Outside instrument limits" : globalResult.errorMessage.value_or("Unknown error"))
+                          << "\n";
+            }
+        }
+        messages.erase(messages.begin() + static_cast<std::ptrdiff_t>(kept), messages.end());
+        pendingBegin = messages.size();
+    };
+    
+    // Hand a copy to the background writer; never blocks the decode loop
+    const auto publishProgress = [&] {
+        if (checkpointWriter_ && messageCount >= nextCheckpoint) {
+            if (limits) {
+                flushPending();
+            }
+            checkpointWriter_->offer([&](Snapshot& slot) { fillSnapshot(slot, offset, messageCount); });
+            nextCheckpoint = messageCount + checkpointInterval_;
+        }
+        if (statsExporter_ && (messageCount & (STATS_PUBLISH_INTERVAL - 1)) == 0) {
+            if (limits) {
+                flushPending();
+            }
+            statsExporter_->publish(stats_, messageCount, offset);
+        }
+    };
     
     if (debugMode_) {
         std::cout << "\n=== NSE MTBT Decoder - Real Binary Parsing ===\n";
-        std::cout << "Data size: " << data.size() << " bytes\n";
+        std::cout << "Data size: " << size << " bytes\n";
         std::cout << "Expected message size: " << ProtocolConstants::MESSAGE_SIZE << " bytes\n\n";
     }
     
-    while (offset + ProtocolConstants::MESSAGE_SIZE <= data.size()) {
-        if (auto message = parseBinaryMessage(data.data() + offset, ProtocolConstants::MESSAGE_SIZE); message) {
+    while (offset + ProtocolConstants::MESSAGE_SIZE <= size) {
+        if (subscriptions) {
+            // Reuse the batch mask while we stay frame-aligned inside it
+            const std::size_t delta = offset - maskBase;
+            if (offset < maskBase || delta >= maskFrames * ProtocolConstants::MESSAGE_SIZE ||
+                delta % ProtocolConstants::MESSAGE_SIZE != 0) {
+                maskBase = offset;
+                maskFrames = std::min(SubscriptionFilter::BATCH_FRAMES, (size - offset) / ProtocolConstants::MESSAGE_SIZE);
+                subscribedMask = SubscriptionFilter::testFrames(**subscriptions, data + offset, maskFrames);
+            }
+            // Damaged frames fall through to the parser, so errors and resync do not depend on the filter
+            if (!((subscribedMask >> ((offset - maskBase) / ProtocolConstants::MESSAGE_SIZE)) & 1u) &&
+                frameIntact(data + offset)) {
+                // Unsubscribed frames still carry the feed sequence, so skipping them is not a gap
+                trackSequence(data + offset, wire::TradeFrame::Sequence::load(data + offset));
+                ++stats_.filteredMessages;
+                ++messageCount;
+                offset += ProtocolConstants::MESSAGE_SIZE;
+                publishProgress();
+                continue;
+            }
+        }
+        
+        if (auto message = parseBinaryMessage(data + offset, ProtocolConstants::MESSAGE_SIZE); message) {
             if (debugMode_) {
-                logBinaryDecoding(*message, data.data() + offset);
+                logBinaryDecoding(*message, data + offset);
             }
             
-            const auto validationResult = message->validate();
-            if (validationResult.isValid) {
+            // Invalid frames still consumed a sequence number; trackSequence decides whether to trust it
+            trackSequence(data + offset, message->sequenceNumber);
+            if (limits) {
+                pendingOffsets[messages.size() - pendingBegin] = offset;
                 messages.push_back(*message);
-                ++stats_.validMessages;
+                if (messages.size() - pendingBegin == InstrumentLimits::BATCH_MESSAGES) {
+                    flushPending();
+                }
             } else {
-                ++stats_.errorCount;
-                if (debugMode_) {
-                    std::cout << "❌ Validation failed: " << validationResult.errorMessage.value_or("Unknown error") << "\n";
+                const auto validationResult = [&] {
+                    MTBT_TRACE_SCOPE("TradeMessage::validate");
+                    return message->validate();
+                }();
+                if (traceLogger_) {
+                    traceLogger_->record(validationResult.isValid ? TraceLogger::Event::DECODED : TraceLogger::Event::INVALID,
+                                         validationResult.isValid ? TraceLogger::Reason::NONE : TraceLogger::Reason::FIELD_RULES,
+                                         captureOffset_ + offset, data + offset, size - offset);
+                }
+                if (validationResult.isValid) {
+                    messages.push_back(*message);
+                    ++stats_.validMessages;
+                } else {
+                    ++stats_.errorCount;
+                    if (debugMode_) {
+                        std::cout << "❌ Validation failed: " << validationResult.errorMessage.value_or("Unknown error") << "\n";
+                    }
                 }
             }
             ++messageCount;
             offset += ProtocolConstants::MESSAGE_SIZE;
+            publishProgress();
         } else {
             ++stats_.protocolErrors;
             ++stats_.errorCount;
+            if (traceLogger_) {
+                // parseBinaryMessage only checks the CRC once the layout passed
+                const bool checksumFailed = size - offset >= ProtocolConstants::MESSAGE_SIZE &&
+                                            validateMessageFormat(data + offset, ProtocolConstants::MESSAGE_SIZE);
+                traceLogger_->record(TraceLogger::Event::PROTOCOL_ERROR,
+                                     checksumFailed ? TraceLogger::Reason::CHECKSUM : TraceLogger::Reason::FORMAT,
+                                     captureOffset_ + offset, data + offset, size - offset);
+            }
             if (debugMode_) {
                 std::cout << "❌ Protocol parsing failed at offset " << offset << "\n";
             }
+            breakSequenceRun();
             ++offset; // Skip bad byte
         }
     }
     
-    stats_.truncatedBytes = data.size() - offset;
+    if (limits) {
+        flushPending();
+    }
+    
+    stats_.truncatedBytes = size - offset;
     updateStats(startTime, offset, messageCount);
+    captureOffset_ += offset;
+    
+    if (statsExporter_) {
+        const auto batchTime = std::chrono::high_resolution_clock::now() - startTime;
+        statsExporter_->publish(stats_);
+        statsExporter_->recordLatency(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(batchTime).count()));
+    }
     
     if (debugMode_) {
         std::cout << "\n=== Decoding Summary ===\n";
@@ -60,11 +259,10 @@ std::vector<TradeMessage> Decoder::decodeFeed(const std::vector<std::uint8_t>& d
         std::cout << "Errors: " << stats_.errorCount << "\n";
         std::cout << "Truncated bytes: " << stats_.truncatedBytes << "\n";
     }
-    
-    return messages;
 }
 
 std::optional<TradeMessage> Decoder::parseBinaryMessage(const std::uint8_t* data, std::size_t size) const {
+    MTBT_TRACE_SCOPE("Decoder::parseBinaryMessage");
     if (size < ProtocolConstants::MESSAGE_SIZE) {
         return std::nullopt;
     }
@@ -75,19 +273,11 @@ std::optional<TradeMessage> Decoder::parseBinaryMessage(const std::uint8_t* data
     }
     
     TradeMessage message;
-    
-    // Extract fields using real bit-level operations
-    message.sequenceNumber = extractUint32(data, ProtocolConstants::OFFSET_SEQUENCE);
-    message.symbolToken = extractUint32(data, ProtocolConstants::OFFSET_SYMBOL_TOKEN);
-    message.timestamp = extractUint64(data, ProtocolConstants::OFFSET_TIMESTAMP);
-    message.priceInPaisa = extractUint32(data, ProtocolConstants::OFFSET_PRICE);
-    message.quantity = extractUint32(data, ProtocolConstants::OFFSET_QUANTITY);
-    message.side = extractTradeSide(data, ProtocolConstants::OFFSET_SIDE);
-    message.checksum = extractUint32(data, ProtocolConstants::OFFSET_CHECKSUM);
+    TradeCodec::parse(data, message);
     
     // CRC validation if enabled
     if (validationLevel_ >= ValidationLevel::CHECKSUM) {
-        const std::uint32_t calculatedCRC = calculateCRC32(data, ProtocolConstants::MESSAGE_SIZE - 4);
+        const std::uint32_t calculatedCRC = calculateCRC32(data, wire::TradeFrame::Checksum::OFFSET);
         if (calculatedCRC != message.checksum) {
             ++stats_.crcErrors;
             return std::nullopt;
@@ -97,53 +287,36 @@ std::optional<TradeMessage> Decoder::parseBinaryMessage(const std::uint8_t* data
     return message;
 }
 
-std::uint32_t Decoder::extractUint32(const std::uint8_t* data, std::size_t offset) const {
-    // Extract 32-bit value with proper byte order conversion
-    std::uint32_t value = 0;
-    
-    // Little-endian extraction with bit manipulation
-    value |= static_cast<std::uint32_t>(data[offset + 0]) << 0;
-    value |= static_cast<std::uint32_t>(data[offset + 1]) << 8;
-    value |= static_cast<std::uint32_t>(data[offset + 2]) << 16;
-    value |= static_cast<std::uint32_t>(data[offset + 3]) << 24;
-    
-    return value;
+std::uint32_t Decoder::calculateCRC32(const std::uint8_t* data, std::size_t size) noexcept {
+    MTBT_TRACE_SCOPE("Decoder::calculateCRC32");
+    // Same CRC32 as FeedSimulator's bitwise loop; sequence tracking checks it on every out-of-order frame
+    const auto& t = CRC32_TABLES;
+    std::uint32_t crc = 0xFFFFFFFF;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const std::uint32_t low = crc ^ wire::load<std::uint32_t, wire::Endian::LITTLE>(data + i);
+        const std::uint32_t high = wire::load<std::uint32_t, wire::Endian::LITTLE>(data + i + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for (; i < size; ++i) {
+        crc = (crc >> 8) ^ t[0][(crc ^ data[i]) & 0xFF];
+    }
+    return ~crc;
 }
 
-std::uint64_t Decoder::extractUint64(const std::uint8_t* data, std::size_t offset) const {
-    // Extract 64-bit value with proper byte order conversion
-    std::uint64_t value = 0;
-    
-    // Little-endian extraction with bit manipulation
-    for (std::size_t i = 0; i < 8; ++i) {
-        value |= static_cast<std::uint64_t>(data[offset + i]) << (i * 8);
-    }
-    
-    return value;
+bool Decoder::checksumMatches(const std::uint8_t* frame) noexcept {
+    return calculateCRC32(frame, wire::TradeFrame::Checksum::OFFSET) == wire::TradeFrame::Checksum::load(frame);
 }
 
-TradeSide Decoder::extractTradeSide(const std::uint8_t* data, std::size_t offset) const {
-    // Extract trade side from single byte
-    const std::uint8_t sideValue = data[offset];
-    return (sideValue == 0) ? TradeSide::BUY : TradeSide::SELL;
+bool Decoder::frameIntact(const std::uint8_t* frame) const {
+    // The checks parseBinaryMessage would apply at this validation level, without parsing
+    return validateMessageFormat(frame, ProtocolConstants::MESSAGE_SIZE) &&
+           (validationLevel_ < ValidationLevel::CHECKSUM || checksumMatches(frame));
 }
 
-std::uint32_t Decoder::calculateCRC32(const std::uint8_t* data, std::size_t size) const {
-    // Simplified CRC32 calculation (in real implementation, use proper CRC32)
-    std::uint32_t crc = 0xFFFFFFFF;
-    
-    for (std::size_t i = 0; i < size; ++i) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    
-    return ~crc;
+bool Decoder::frameTrusted(const std::uint8_t* frame) noexcept {
+    return TradeCodec::parse(frame).validate().isValid && checksumMatches(frame);
 }
 
 bool Decoder::validateMessageFormat(const std::uint8_t* data, std::size_t size) const {
@@ -151,17 +324,10 @@ bool Decoder::validateMessageFormat(const std::uint8_t* data, std::size_t size)
         return false;
     }
     
-    // Basic sanity checks on the binary data
-    // Check if all bytes are not zero (which would indicate corrupted data)
-    bool allZero = true;
-    for (std::size_t i = 0; i < std::min(size, static_cast<std::size_t>(16)); ++i) {
-        if (data[i] != 0) {
-            allZero = false;
-            break;
-        }
-    }
-    
-    return !allZero;
+    // An all-zero leading 16 bytes indicates corrupted data
+    std::uint64_t head[2];
+    std::memcpy(head, data, sizeof(head));
+    return (head[0] | head[1]) != 0;
 }
 
 void Decoder::logBinaryDecoding(const TradeMessage& message, const std::uint8_t* rawData) const {
@@ -187,6 +353,121 @@ void Decoder::logBinaryDecoding(const TradeMessage& message, const std::uint8_t*
     std::cout << "✅ " << message.getDecodingInfo() << "\n\n";
 }
 
+std::optional<std::uint64_t> Decoder::seekToTimestamp(const CaptureIndex& index, const std::uint8_t* data,
+                                                      std::size_t size, std::uint64_t timestamp) {
+    return seekTo(index.offsetForTimestamp(timestamp), index.intervalFrames(), data, size,
+                  [&](const std::uint8_t* frame) {
+                      return wire::TradeFrame::Timestamp::load(frame) >= timestamp;
+                  });
+}
+
+std::optional<std::uint64_t> Decoder::seekToSequence(const CaptureIndex& index, const std::uint8_t* data,
+                                                     std::size_t size, std::uint32_t sequence) {
+    return seekTo(index.offsetForSequence(sequence), index.intervalFrames(), data, size,
+                  [&](const std::uint8_t* frame) {
+                      return wire::TradeFrame::Sequence::load(frame) >= sequence;
+                  });
+}
+
+template<typename Field>
+std::optional<std::uint64_t> Decoder::seekTo(std::uint64_t startOffset, std::uint64_t intervalFrames,
+                                             const std::uint8_t* data, std::size_t size, Field&& reachesTarget) {
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+    const std::uint64_t end = size - size % FRAME;
+    
+    // The next index entry already covers a matching frame, so one interval is enough;
+    // damaged frames were left out of the index and must not stop the scan either
+    std::uint64_t offset = std::min<std::uint64_t>(startOffset, end);
+    const std::uint64_t scanLimit = std::min<std::uint64_t>(end, offset + (intervalFrames + 1) * FRAME);
+    while (offset < scanLimit && !(reachesTarget(data + offset) && frameTrusted(data + offset))) {
+        offset += FRAME;
+    }
+    if (offset == scanLimit) {
+        return std::nullopt;
+    }
+    
+    // Frames before the seek point were never seen: start a fresh sequence baseline there
+    lastSequence_ = 0;
+    suspectSequence_ = 0;
+    untrustedFrames_ = 0;
+    previousSequence_ = 0;
+    captureOffset_ = offset;
+    return offset;
+}
+
+void Decoder::restoreSnapshot(const Snapshot& snapshot) {
+    stats_ = snapshot.stats;
+    gaps_ = snapshot.gaps;
+    lastSequence_ = snapshot.lastSequence;
+    suspectSequence_ = 0;
+    untrustedFrames_ = 0;
+    previousSequence_ = 0;
+    captureOffset_ = snapshot.captureOffset;
+}
+
+void Decoder::trackSequence(const std::uint8_t* frame, std::uint32_t sequenceNumber) {
+    // Only the expected next number vouches for itself; any other value moves or holds the mark
+    // only from a frame whose checksum matches (STRICT parsing never looked at it). A number at or
+    // below the mark that continues the previous frame's run is a replay or retransmission: it can
+    // never move the mark, so it is taken as a duplicate without paying for the checksum.
+    const bool expected = lastSequence_ != 0 && sequenceNumber == lastSequence_ + 1;
+    const bool replayed = sequenceNumber <= lastSequence_ && sequenceNumber == previousSequence_ + 1;
+    previousSequence_ = sequenceNumber;
+    if (!expected && !replayed && validationLevel_ < ValidationLevel::CHECKSUM && !checksumMatches(frame)) {
+        breakSequenceRun();
+        ++untrustedFrames_;
+        return;
+    }
+    
+    // Out-of-order or duplicate sequences never move the high-water mark back
+    if (lastSequence_ != 0 && sequenceNumber > lastSequence_ + 1) {
+        std::uint32_t lastMissing = sequenceNumber - 1;
+        if (sequenceNumber - lastSequence_ > maxSequenceJump_) {
+            // Confirmed only by the very next frame, also checksummed, continuing from this one
+            if (suspectSequence_ == 0 || sequenceNumber != suspectSequence_ + 1) {
+                breakSequenceRun();
+                ++stats_.suspectSequences;
+                suspectSequence_ = sequenceNumber;
+                return;
+            }
+            --stats_.suspectSequences;
+            lastMissing = suspectSequence_ - 1;
+        }
+        // Damaged frames since the mark most likely carried the first of the missing numbers
+        const std::uint32_t firstMissing = lastSequence_ + 1 + std::min(untrustedFrames_, lastMissing - lastSequence_);
+        if (firstMissing <= lastMissing) {
+            ++stats_.sequenceGaps;
+            stats_.missingMessages += lastMissing - firstMissing + 1;
+            if (gaps_.size() < MAX_TRACKED_GAPS) {
+                gaps_.push_back({firstMissing, lastMissing});
+            }
+        }
+    } else if (lastSequence_ != 0 && sequenceNumber <= lastSequence_) {
+        breakSequenceRun();
+        return;
+    }
+    suspectSequence_ = 0;
+    untrustedFrames_ = 0;
+    lastSequence_ = sequenceNumber;
+}
+
+void Decoder::breakSequenceRun() noexcept {
+    // A held-back jump that nothing confirmed counts like any other damaged frame
+    if (suspectSequence_ != 0) {
+        suspectSequence_ = 0;
+        ++untrustedFrames_;
+    }
+}
+
+void Decoder::fillSnapshot(Snapshot& snapshot, std::uint64_t batchOffset, std::uint64_t batchMessages) const {
+    snapshot.captureOffset = captureOffset_ + batchOffset;
+    snapshot.lastSequence = lastSequence_;
+    snapshot.stats = stats_;
+    snapshot.stats.decodedMessages += batchMessages;
+    snapshot.stats.bytesProcessed += batchOffset;
+    snapshot.gaps.assign(gaps_.begin(), gaps_.end()); // Reuses the slot's capacity
+}
+
 void Decoder::updateStats(const std::chrono::high_resolution_clock::time_point& startTime,
                          std::uint64_t processedBytes, std::uint64_t messageCount) noexcept {
     
@@ -1,12 +1,22 @@
 #pragma once
 
 #include "MessageTypes.h"
+#include <algorithm>
 #include <vector>
+#include <memory_resource>
 #include <optional>
 #include <chrono>
+#include <string>
 
 namespace nse::mtbt {
 
+class CaptureIndex;
+class CheckpointWriter;
+class InstrumentLimits;
+class SubscriptionFilter;
+class StatsExporter;
+class TraceLogger;
+
 /**
  * High-performance message decoder with real bit-level decoding
  */
@@ -25,8 +35,44 @@ public:
         std::uint64_t processingSpeed{0}; // messages per second
         std::uint64_t crcErrors{0};       // CRC validation errors
         std::uint64_t protocolErrors{0};  // Protocol format errors
+        std::uint64_t sequenceGaps{0};    // Detected sequence discontinuities
+        std::uint64_t missingMessages{0}; // Messages lost inside those gaps
+        std::uint64_t suspectSequences{0}; // Checksummed jumps beyond the sequence window, held back from gap tracking
+        std::uint64_t filteredMessages{0}; // Frames skipped by the subscription filter
+        std::uint64_t limitViolations{0};  // Rejected by per-instrument limits only (also in errorCount)
+        
+        // Output buffer allocator activity (process-local, not checkpointed)
+        std::uint64_t outputAllocations{0};    // Batches that had to grow the output buffer
+        std::uint64_t outputBytesAllocated{0}; // Bytes requested by those growths
+        std::uint64_t outputBufferReuses{0};   // Batches served from recycled capacity
+    };
+
+    /**
+     * Recyclable output buffer drawing from any std::pmr memory resource
+     */
+    using MessageBuffer = std::pmr::vector<TradeMessage>;
+
+    /**
+     * Inclusive range of sequence numbers that never arrived
+     */
+    struct SequenceGap {
+        std::uint32_t firstMissing{0};
+        std::uint32_t lastMissing{0};
     };
 
+    /**
+     * Point-in-time copy of everything needed to resume decoding
+     */
+    struct Snapshot {
+        std::uint64_t captureOffset{0};   // Byte offset of the next undecoded frame
+        std::uint32_t lastSequence{0};    // Highest sequence number seen so far
+        DecodingStats stats{};
+        std::vector<SequenceGap> gaps;
+    };
+
+    static constexpr std::size_t MAX_TRACKED_GAPS = 4096;
+    static constexpr std::uint32_t DEFAULT_MAX_SEQUENCE_JUMP = 100'000;   // About a second of the busiest stream
+
     /**
      * Modern constructor
      */
@@ -43,21 +89,134 @@ public:
      */
     [[nodiscard]] std::vector<TradeMessage> decodeFeed(const std::vector<std::uint8_t>& data);
 
+    /**
+     * Decode messages from a raw byte range (e.g. a memory-mapped capture)
+     */
+    [[nodiscard]] std::vector<TradeMessage> decodeFeed(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Decode into a caller-owned buffer, reusing its capacity across batches
+     *
+     * With the buffer backed by an ArenaResource, steady-state decoding
+     * makes no calls into the global allocator.
+     */
+    void decodeFeedInto(const std::uint8_t* data, std::size_t size, MessageBuffer& messages);
+
     /**
      * Get comprehensive decoding statistics
      */
     [[nodiscard]] const DecodingStats& getStats() const noexcept { return stats_; }
 
+    /**
+     * Sequence gaps detected so far (oldest first, capped at MAX_TRACKED_GAPS)
+     */
+    [[nodiscard]] const std::vector<SequenceGap>& getGaps() const noexcept { return gaps_; }
+
+    /**
+     * Capture file offset just past the last frame consumed
+     */
+    [[nodiscard]] std::uint64_t getCaptureOffset() const noexcept { return captureOffset_; }
+
+    /**
+     * Copy the resumable decoder state
+     */
+    [[nodiscard]] Snapshot captureSnapshot() const {
+        Snapshot snapshot;
+        fillSnapshot(snapshot, 0, 0);
+        return snapshot;
+    }
+
+    /**
+     * Restore state from a snapshot; subsequent input must start at snapshot.captureOffset
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
+
+    /**
+     * Publish snapshots to a checkpoint writer every N decoded messages (nullptr disables)
+     */
+    void setCheckpointWriter(CheckpointWriter* writer, std::uint64_t intervalMessages) noexcept {
+        checkpointWriter_ = writer;
+        checkpointInterval_ = intervalMessages;
+    }
+
+    /**
+     * Skip frames whose token is not subscribed before parsing them (nullptr disables)
+     */
+    void setSubscriptionFilter(const SubscriptionFilter* filter) noexcept { subscriptionFilter_ = filter; }
+
+    /**
+     * Validate against per-instrument limits, a block of messages at a time (nullptr: global rules)
+     */
+    void setInstrumentLimits(const InstrumentLimits* limits) noexcept { instrumentLimits_ = limits; }
+
+    /**
+     * Publish live counters and batch latency to shared memory (nullptr disables)
+     */
+    void setStatsExporter(StatsExporter* exporter) noexcept { statsExporter_ = exporter; }
+
+    /**
+     * Trace sampled frames through a background formatter (nullptr disables)
+     */
+    void setTraceLogger(TraceLogger* logger) noexcept { traceLogger_ = logger; }
+
+    /**
+     * Messages between live counter publications inside a single batch
+     */
+    static constexpr std::uint64_t STATS_PUBLISH_INTERVAL = 1 << 16;
+
+    /**
+     * Seek to the first intact frame with timestamp >= target; returns its byte offset in data
+     *
+     * Binary-searches the index, then scans at most one index interval of
+     * timestamps, skipping frames that fail frameTrusted(). Decoding continues
+     * from data + offset with a fresh sequence baseline, and checkpoints record
+     * offsets relative to the capture start. nullopt (state untouched) when no
+     * such frame exists.
+     */
+    [[nodiscard]] std::optional<std::uint64_t> seekToTimestamp(const CaptureIndex& index, const std::uint8_t* data,
+                                                               std::size_t size, std::uint64_t timestamp);
+
+    /**
+     * Seek to the first intact frame with sequence number >= target; returns its byte offset in data
+     */
+    [[nodiscard]] std::optional<std::uint64_t> seekToSequence(const CaptureIndex& index, const std::uint8_t* data,
+                                                              std::size_t size, std::uint32_t sequence);
+
+    /**
+     * Whether a whole frame parses, passes the exchange-wide rules and matches its checksum
+     *
+     * Used where raw frame fields are trusted without decoding, such as
+     * building and scanning seek indexes.
+     */
+    [[nodiscard]] static bool frameTrusted(const std::uint8_t* frame) noexcept;
+
     /**
      * Reset decoder state
      */
-    void reset() noexcept { stats_ = DecodingStats{}; }
+    void reset() noexcept {
+        stats_ = DecodingStats{};
+        gaps_.clear();
+        lastSequence_ = 0;
+        suspectSequence_ = 0;
+        untrustedFrames_ = 0;
+        previousSequence_ = 0;
+        captureOffset_ = 0;
+    }
 
     /**
      * Set validation level
      */
     void setValidationLevel(ValidationLevel level) noexcept { validationLevel_ = level; }
 
+    /**
+     * Largest forward sequence jump taken at face value
+     *
+     * A checksummed frame further ahead than this is counted as suspect
+     * instead of moving the high-water mark, unless the very next frame is
+     * also checksummed and continues from it.
+     */
+    void setMaxSequenceJump(std::uint32_t frames) noexcept { maxSequenceJump_ = std::max<std::uint32_t>(frames, 1); }
+
     /**
      * Enable/disable debug output
      */
@@ -67,15 +226,37 @@ private:
     mutable DecodingStats stats_{};
     ValidationLevel validationLevel_{ValidationLevel::STRICT};
     bool debugMode_{false};
+    std::uint32_t lastSequence_{0};
+    std::uint32_t suspectSequence_{0};    // Previous frame, if it was held back by the jump window
+    std::uint32_t untrustedFrames_{0};    // Frames since the mark whose sequence failed the checksum
+    std::uint32_t previousSequence_{0};   // Sequence field of the previous tracked frame
+    std::uint32_t maxSequenceJump_{DEFAULT_MAX_SEQUENCE_JUMP};
+    std::uint64_t captureOffset_{0};
+    std::vector<SequenceGap> gaps_;
+    CheckpointWriter* checkpointWriter_{nullptr};
+    const SubscriptionFilter* subscriptionFilter_{nullptr};
+    const InstrumentLimits* instrumentLimits_{nullptr};
+    StatsExporter* statsExporter_{nullptr};
+    TraceLogger* traceLogger_{nullptr};
+    std::uint64_t checkpointInterval_{0};
+    
+    template<typename Field>
+    [[nodiscard]] std::optional<std::uint64_t> seekTo(std::uint64_t startOffset, std::uint64_t intervalFrames,
+                                                      const std::uint8_t* data, std::size_t size, Field&& reachesTarget);
+    
+    template<typename Output>
+    void decodeInto(const std::uint8_t* data, std::size_t size, Output& messages);
     
-    // Real bit-level parsing methods
+    // Field layout comes from TradeCodec (WireSchema.h)
     [[nodiscard]] std::optional<TradeMessage> parseBinaryMessage(const std::uint8_t* data, std::size_t size) const;
-    [[nodiscard]] std::uint32_t extractUint32(const std::uint8_t* data, std::size_t offset) const;
-    [[nodiscard]] std::uint64_t extractUint64(const std::uint8_t* data, std::size_t offset) const;
-    [[nodiscard]] TradeSide extractTradeSide(const std::uint8_t* data, std::size_t offset) const;
-    [[nodiscard]] std::uint32_t calculateCRC32(const std::uint8_t* data, std::size_t size) const;
+    [[nodiscard]] static std::uint32_t calculateCRC32(const std::uint8_t* data, std::size_t size) noexcept;
     [[nodiscard]] bool validateMessageFormat(const std::uint8_t* data, std::size_t size) const;
     
+    [[nodiscard]] static bool checksumMatches(const std::uint8_t* frame) noexcept;
+    [[nodiscard]] bool frameIntact(const std::uint8_t* frame) const;
+    void trackSequence(const std::uint8_t* frame, std::uint32_t sequenceNumber);
+    void breakSequenceRun() noexcept;
+    void fillSnapshot(Snapshot& snapshot, std::uint64_t batchOffset, std::uint64_t batchMessages) const;
     void updateStats(const std::chrono::high_resolution_clock::time_point& startTime,
                     std::uint64_t processedBytes, std::uint64_t messageCount) noexcept;
     void logBinaryDecoding(const TradeMessage& message, const std::uint8_t* rawData) const;
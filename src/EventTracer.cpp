@@ -0,0 +1,112 @@
+#include "EventTracer.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Every ring ever registered, plus the tick/clock anchor used to convert to microseconds
+ */
+struct EventTracer::Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::uint64_t anchorTicks{EventTracer::now()};
+    std::uint64_t anchorNs{steadyNowNs()};
+};
+
+EventTracer::Registry& EventTracer::registry() noexcept {
+    static Registry instance;
+    return instance;
+}
+
+void EventTracer::enable(bool enabled) noexcept {
+    if (enabled) {
+        auto& shared = registry();
+        const std::lock_guard lock{shared.mutex};
+        shared.anchorTicks = now();
+        shared.anchorNs = steadyNowNs();
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+EventTracer::Ring* EventTracer::registerThread() noexcept {
+    auto& shared = registry();
+    const std::lock_guard lock{shared.mutex};
+    auto& ring = shared.rings.emplace_back(std::make_unique<Ring>());
+    ring->threadId = static_cast<std::uint32_t>(shared.rings.size());
+    threadRing_ = ring.get();
+    return threadRing_;
+}
+
+EventTracer::Summary EventTracer::summary() noexcept {
+    auto& shared = registry();
+    const std::lock_guard lock{shared.mutex};
+    Summary result;
+    result.threads = shared.rings.size();
+    for (const auto& ring : shared.rings) {
+        const auto head = ring->head.load(std::memory_order_acquire);
+        result.recorded += head;
+        result.kept += std::min<std::uint64_t>(head, RING_EVENTS);
+    }
+    return result;
+}
+
+void EventTracer::clear() noexcept {
+    auto& shared = registry();
+    const std::lock_guard lock{shared.mutex};
+    for (const auto& ring : shared.rings) {
+        ring->head.store(0, std::memory_order_release);
+    }
+}
+
+bool EventTracer::exportChromeTrace(const std::string& path) {
+    auto& shared = registry();
+
+    // Tick rate from the anchor to now; wait out a too-short window so the ratio is stable
+    std::uint64_t anchorTicks = 0;
+    std::uint64_t anchorNs = 0;
+    {
+        const std::lock_guard lock{shared.mutex};
+        anchorTicks = shared.anchorTicks;
+        anchorNs = shared.anchorNs;
+    }
+    constexpr std::uint64_t MIN_CALIBRATION_NS = 10'000'000;
+    if (const auto elapsed = steadyNowNs() - anchorNs; elapsed < MIN_CALIBRATION_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds{MIN_CALIBRATION_NS - elapsed});
+    }
+    const double ticksPerUs = static_cast<double>(now() - anchorTicks) * 1000.0 /
+                              static_cast<double>(steadyNowNs() - anchorNs);
+    const auto toUs = [&](std::uint64_t ticks) {
+        return static_cast<double>(static_cast<std::int64_t>(ticks - anchorTicks)) / ticksPerUs;
+    };
+
+    std::ofstream out{path};
+    if (!out) {
+        return false;
+    }
+    out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    const std::lock_guard lock{shared.mutex};
+    bool first = true;
+    for (const auto& ring : shared.rings) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId
+            << ",\"args\":{\"name\":\"thread " << ring->threadId << "\"}}";
+        first = false;
+
+        const auto head = ring->head.load(std::memory_order_acquire);
+        for (std::uint64_t i = head > RING_EVENTS ? head - RING_EVENTS : 0; i < head; ++i) {
+            const Event& event = ring->events[i & (RING_EVENTS - 1)];
+            out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"mtbt\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << ring->threadId << ",\"ts\":" << toUs(event.beginTicks)
+                << ",\"dur\":" << static_cast<double>(event.endTicks - event.beginTicks) / ticksPerUs << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Platform.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define MTBT_HAVE_RDTSC 1
+#endif
+
+/**
+ * Hot-path scope tracing, compiled in only with -DMTBT_ENABLE_TRACING
+ *
+ * MTBT_TRACE_SCOPE("name") records the enclosing scope as one complete
+ * event; the name must be a string literal. Without the flag it expands to
+ * nothing, so instrumented code costs nothing in regular builds.
+ */
+#if defined(MTBT_ENABLE_TRACING)
+#define MTBT_TRACE_CONCAT_INNER(a, b) a##b
+#define MTBT_TRACE_CONCAT(a, b) MTBT_TRACE_CONCAT_INNER(a, b)
+#define MTBT_TRACE_SCOPE(name) const ::nse::mtbt::EventTracer::Scope MTBT_TRACE_CONCAT(mtbtTraceScope, __LINE__){name}
+#else
+#define MTBT_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace nse::mtbt {
+
+/**
+ * Per-thread rings of TSC-stamped scope events, exported as Chrome trace_event JSON
+ *
+ * Each thread writes fixed-size events into its own ring (no locks, no
+ * shared cache lines); when a ring wraps, the oldest events are
+ * overwritten. Rings outlive their threads, so short-lived workers still
+ * show up in the export. Recording is off until enable(true).
+ */
+class EventTracer {
+public:
+    /**
+     * One completed scope; name points at a string literal
+     */
+    struct Event {
+        const char* name;
+        std::uint64_t beginTicks;
+        std::uint64_t endTicks;
+    };
+
+    /**
+     * Events kept per thread (most recent)
+     */
+    static constexpr std::size_t RING_EVENTS = std::size_t{1} << 18;
+
+    /**
+     * Recording totals across all threads
+     */
+    struct Summary {
+        std::uint64_t recorded{0};     // Events written since the last clear()
+        std::uint64_t kept{0};         // Still in the rings (the rest were overwritten)
+        std::size_t threads{0};
+    };
+
+    /**
+     * True when this build contains the MTBT_TRACE_SCOPE instrumentation
+     */
+    [[nodiscard]] static constexpr bool compiledIn() noexcept {
+#if defined(MTBT_ENABLE_TRACING)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Start or stop recording (scopes already open when stopping still complete)
+     */
+    static void enable(bool enabled) noexcept;
+
+    [[nodiscard]] static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Raw timestamp: TSC where available, steady clock nanoseconds otherwise
+     */
+    [[nodiscard]] static std::uint64_t now() noexcept {
+#if defined(MTBT_HAVE_RDTSC)
+        return __rdtsc();
+#else
+        return steadyNowNs();
+#endif
+    }
+
+    /**
+     * Append one event to the calling thread's ring
+     */
+    static void record(const char* name, std::uint64_t beginTicks, std::uint64_t endTicks) noexcept {
+        Ring* ring = threadRing_ ? threadRing_ : registerThread();
+        const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+        ring->events[head & (RING_EVENTS - 1)] = Event{name, beginTicks, endTicks};
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * Write every thread's kept events as Chrome trace_event JSON (open in Perfetto)
+     *
+     * Call once the traced threads are idle; events written concurrently
+     * with the export may be torn.
+     */
+    [[nodiscard]] static bool exportChromeTrace(const std::string& path);
+
+    [[nodiscard]] static Summary summary() noexcept;
+
+    /**
+     * Drop all recorded events (rings stay allocated)
+     */
+    static void clear() noexcept;
+
+    /**
+     * RAII scope: stamps begin on construction, records on destruction
+     */
+    class Scope {
+    public:
+        explicit Scope(const char* name) noexcept : name_{name}, beginTicks_{enabled() ? now() : 0} {}
+        ~Scope() {
+            if (beginTicks_ != 0) {
+                record(name_, beginTicks_, now());
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_;
+        std::uint64_t beginTicks_;
+    };
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Ring {
+        std::unique_ptr<Event[]> events{new Event[RING_EVENTS]};
+        std::atomic<std::uint64_t> head{0};
+        std::uint32_t threadId{0};
+    };
+
+    struct Registry;
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline thread_local Ring* threadRing_{nullptr};
+
+    static Registry& registry() noexcept;
+    static Ring* registerThread() noexcept;
+};
+
+} // namespace nse::mtbt
@@ -1,8 +1,14 @@
 #include "FeedSimulator.h"
+#include "EventTracer.h"
+#include "Platform.h"
 #include <chrono>
 #include <cstring>
 #include <algorithm>
 
+#if defined(__linux__)
+#include <time.h>
+#endif
+
 namespace nse::mtbt {
 
 std::vector<std::uint8_t> FeedSimulator::generateFeed() {
@@ -10,13 +16,22 @@ std::vector<std::uint8_t> FeedSimulator::generateFeed() {
 }
 
 std::vector<std::uint8_t> FeedSimulator::generateBinaryFeed() {
-    std::vector<std::uint8_t> feedData;
-    feedData.reserve(config_.messageCount * ProtocolConstants::MESSAGE_SIZE);
+    MTBT_TRACE_SCOPE("FeedSimulator::generateBinaryFeed");
+    // Zero-filled up front so reserved bytes need no per-frame writes
+    std::vector<std::uint8_t> feedData(static_cast<std::size_t>(config_.messageCount) * ProtocolConstants::MESSAGE_SIZE);
+    
+    // Multi-stream segments: a symbol always lives on one stream, numbered from 1 per stream
+    std::vector<std::uint32_t> streamSequences(std::max<std::uint16_t>(config_.streamCount, 1), 0);
     
+    std::uint8_t* frame = feedData.data();
     for (std::uint32_t i = 1; i <= config_.messageCount; ++i) {
-        const auto message = generateMessage(i);
-        const auto serializedMessage = serializeMessage(message);
-        feedData.insert(feedData.end(), serializedMessage.begin(), serializedMessage.end());
+        auto message = generateMessage(i);
+        if (config_.streamCount > 1) {
+            message.streamId = static_cast<std::uint16_t>(message.symbolToken % config_.streamCount);
+            message.sequenceNumber = ++streamSequences[message.streamId];
+        }
+        serializeMessage(message, frame);
+        frame += ProtocolConstants::MESSAGE_SIZE;
     }
     
     return feedData;
@@ -39,39 +54,9 @@ std::vector<std::uint8_t> FeedSimulator::generateTestFeed() {
     return feedData;
 }
 
-std::vector<std::uint8_t> FeedSimulator::serializeMessage(const TradeMessage& message) {
-    std::vector<std::uint8_t> buffer(ProtocolConstants::MESSAGE_SIZE, 0);
-    
-    // Serialize each field using bit-level operations
-    writeUint32(buffer, ProtocolConstants::OFFSET_SEQUENCE, message.sequenceNumber);
-    writeUint32(buffer, ProtocolConstants::OFFSET_SYMBOL_TOKEN, message.symbolToken);
-    writeUint64(buffer, ProtocolConstants::OFFSET_TIMESTAMP, message.timestamp);
-    writeUint32(buffer, ProtocolConstants::OFFSET_PRICE, message.priceInPaisa);
-    writeUint32(buffer, ProtocolConstants::OFFSET_QUANTITY, message.quantity);
-    
-    // Trade side as single byte
-    buffer[ProtocolConstants::OFFSET_SIDE] = static_cast<std::uint8_t>(message.side);
-    
-    // Calculate and write checksum
-    const std::uint32_t checksum = calculateCRC32(buffer.data(), ProtocolConstants::MESSAGE_SIZE - 4);
-    writeUint32(buffer, ProtocolConstants::OFFSET_CHECKSUM, checksum);
-    
-    return buffer;
-}
-
-void FeedSimulator::writeUint32(std::vector<std::uint8_t>& buffer, std::size_t offset, std::uint32_t value) {
-    // Little-endian byte order
-    buffer[offset + 0] = static_cast<std::uint8_t>(value & 0xFF);
-    buffer[offset + 1] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
-    buffer[offset + 2] = static_cast<std::uint8_t>((value >> 16) & 0xFF);
-    buffer[offset + 3] = static_cast<std::uint8_t>((value >> 24) & 0xFF);
-}
-
-void FeedSimulator::writeUint64(std::vector<std::uint8_t>& buffer, std::size_t offset, std::uint64_t value) {
-    // Little-endian byte order
-    for (std::size_t i = 0; i < 8; ++i) {
-        buffer[offset + i] = static_cast<std::uint8_t>((value >> (i * 8)) & 0xFF);
-    }
+void FeedSimulator::serializeMessage(const TradeMessage& message, std::uint8_t* frame) const {
+    TradeCodec::serialize(message, frame);
+    wire::TradeFrame::Checksum::store(frame, calculateCRC32(frame, wire::TradeFrame::Checksum::OFFSET));
 }
 
 std::uint32_t FeedSimulator::calculateCRC32(const std::uint8_t* data, std::size_t size) const {
@@ -92,6 +77,24 @@ std::uint32_t FeedSimulator::calculateCRC32(const std::uint8_t* data, std::size_
     return ~crc;
 }
 
+std::uint64_t FeedSimulator::sendClockNs() noexcept {
+#if defined(__linux__)
+    // Not slewed by NTP, so differences between two threads stay meaningful
+    timespec now{};
+    ::clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return static_cast<std::uint64_t>(now.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(now.tv_nsec);
+#else
+    return steadyNowNs();
+#endif
+}
+
+void FeedSimulator::stampSendTime(std::uint8_t* frame, bool refreshChecksum) const noexcept {
+    wire::TradeFrame::Timestamp::store(frame, sendClockNs());
+    if (refreshChecksum) {
+        wire::TradeFrame::Checksum::store(frame, calculateCRC32(frame, wire::TradeFrame::Checksum::OFFSET));
+    }
+}
+
 TradeMessage FeedSimulator::generateMessage(std::uint32_t sequenceNumber) {
     return TradeMessage{
         sequenceNumber,
@@ -138,6 +141,11 @@ std::uint32_t FeedSimulator::selectSymbolToken() const {
         1922,    // ITC (ITC Limited)
         5258     // LT (Larsen & Toubro)
     };
+    if (config_.skewedSymbols) {
+        // RELIANCE and HDFCBANK take most of the volume
+        std::discrete_distribution<std::size_t> skewDist({4, 35, 4, 4, 35, 4, 4, 4, 3, 3});
+        return symbols[skewDist(rng_)];
+    }
     std::uniform_int_distribution<std::size_t> indexDist(0, symbols.size() - 1);
     return symbols[indexDist(rng_)];
 }
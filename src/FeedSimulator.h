@@ -20,6 +20,8 @@ public:
         std::size_t malformedCount{0};
         std::uint32_t seed{0};
         ValidationLevel validationLevel{ValidationLevel::STRICT};
+        bool skewedSymbols{false};  // Concentrate volume in RELIANCE/HDFCBANK like a real session
+        std::uint16_t streamCount{1};  // Split symbols across streams, each with its own sequence space
         
         Config() = default;
     };
@@ -60,6 +62,19 @@ public:
      */
     [[nodiscard]] std::vector<std::uint8_t> generateBinaryFeed();
 
+    /**
+     * Send-side clock for latency mode: CLOCK_MONOTONIC_RAW nanoseconds where available
+     */
+    [[nodiscard]] static std::uint64_t sendClockNs() noexcept;
+
+    /**
+     * Overwrite a serialized frame's timestamp with the current send clock
+     *
+     * Call immediately before publishing. Refreshing the checksum costs a CRC
+     * pass, so latency runs that decode under STRICT validation can skip it.
+     */
+    void stampSendTime(std::uint8_t* frame, bool refreshChecksum) const noexcept;
+
     /**
      * Get current configuration
      */
@@ -70,14 +85,12 @@ private:
     mutable std::mt19937 rng_;
     
     [[nodiscard]] TradeMessage generateMessage(std::uint32_t sequenceNumber);
-    [[nodiscard]] std::vector<std::uint8_t> serializeMessage(const TradeMessage& message);
+    void serializeMessage(const TradeMessage& message, std::uint8_t* frame) const;   // frame: MESSAGE_SIZE zeroed bytes
     [[nodiscard]] std::uint64_t generateTimestamp() const;
     [[nodiscard]] std::uint32_t generatePrice() const;
     [[nodiscard]] std::uint32_t generateQuantity() const;
     [[nodiscard]] std::uint32_t selectSymbolToken() const;
     [[nodiscard]] TradeSide generateTradeSide() const;
-    void writeUint32(std::vector<std::uint8_t>& buffer, std::size_t offset, std::uint32_t value);
-    void writeUint64(std::vector<std::uint8_t>& buffer, std::size_t offset, std::uint64_t value);
     [[nodiscard]] std::uint32_t calculateCRC32(const std::uint8_t* data, std::size_t size) const;
 };
 
@@ -0,0 +1,114 @@
+#include "IndexEngine.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace nse::mtbt {
+
+IndexEngine::IndexEngine(const std::vector<IndexDefinition>& definitions, TickHandler handler)
+    : handler_{std::move(handler)} {
+    // Count memberships per symbol, then lay them out contiguously (CSR)
+    std::vector<std::vector<Membership>> bySymbol;
+    for (std::uint32_t indexId = 0; indexId < definitions.size(); ++indexId) {
+        const auto& definition = definitions[indexId];
+        IndexState state;
+        state.name = definition.name;
+        state.baseValue = definition.baseValue;
+        
+        for (const auto& constituent : definition.constituents) {
+            const std::uint32_t symbolId = symbols_.getOrAssign(constituent.symbolToken);
+            if (symbolId == SymbolIndex::INVALID_ID) {
+                continue;
+            }
+            if (symbolId >= bySymbol.size()) {
+                bySymbol.resize(symbolId + 1);
+            }
+            bySymbol[symbolId].push_back({indexId, constituent.basePriceInPaisa, constituent.freeFloatShares});
+            state.baseMarketCap += static_cast<MarketCap>(constituent.freeFloatShares) * constituent.basePriceInPaisa;
+        }
+        state.marketCap = state.baseMarketCap;
+        indices_.push_back(std::move(state));
+    }
+    
+    membershipStart_.reserve(bySymbol.size() + 1);
+    for (const auto& list : bySymbol) {
+        membershipStart_.push_back(static_cast<std::uint32_t>(memberships_.size()));
+        memberships_.insert(memberships_.end(), list.begin(), list.end());
+    }
+    membershipStart_.push_back(static_cast<std::uint32_t>(memberships_.size()));
+}
+
+std::optional<std::vector<IndexDefinition>> IndexEngine::loadDefinitions(const std::string& path) {
+    std::ifstream file{path};
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    
+    std::vector<IndexDefinition> definitions;
+    std::unordered_map<std::string, std::size_t> byName;
+    
+    for (std::string line; std::getline(file, line);) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields{line};
+        std::string indexName, symbol, shares, basePrice;
+        if (!std::getline(fields, indexName, ',') || !std::getline(fields, symbol, ',') ||
+            !std::getline(fields, shares, ',') || !std::getline(fields, basePrice, ',')) {
+            return std::nullopt;
+        }
+        
+        IndexDefinition::Constituent constituent;
+        try {
+            const auto token = SymbolRegistry::findToken(symbol);
+            constituent.symbolToken = token ? *token : static_cast<std::uint32_t>(std::stoul(symbol));
+            constituent.freeFloatShares = std::stoull(shares);
+            constituent.basePriceInPaisa = static_cast<std::uint32_t>(std::stoul(basePrice));
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+        
+        auto [it, inserted] = byName.try_emplace(indexName, definitions.size());
+        if (inserted) {
+            definitions.push_back(IndexDefinition{indexName, 1000.0, {}});
+        }
+        definitions[it->second].constituents.push_back(constituent);
+    }
+    
+    return definitions;
+}
+
+void IndexEngine::onTrade(const TradeMessage& message) {
+    const std::uint32_t symbolId = symbols_.find(message.symbolToken);
+    if (symbolId == SymbolIndex::INVALID_ID || symbolId + 1 >= membershipStart_.size()) {
+        return; // Not an index constituent
+    }
+    
+    for (std::uint32_t m = membershipStart_[symbolId]; m < membershipStart_[symbolId + 1]; ++m) {
+        auto& membership = memberships_[m];
+        if (message.priceInPaisa == membership.lastPriceInPaisa) {
+            continue; // No level change to publish
+        }
+        const auto priceDelta = static_cast<MarketCap>(message.priceInPaisa) -
+                                static_cast<MarketCap>(membership.lastPriceInPaisa);
+        membership.lastPriceInPaisa = message.priceInPaisa;
+        auto& index = indices_[membership.indexId];
+        index.marketCap += priceDelta * static_cast<MarketCap>(membership.freeFloatShares);
+        
+        ++ticksPublished_;
+        if (handler_) {
+            handler_(IndexTick{membership.indexId, level(membership.indexId), message.timestamp, message.sequenceNumber});
+        }
+    }
+}
+
+double IndexEngine::level(std::uint32_t indexId) const noexcept {
+    const auto& index = indices_[indexId];
+    if (index.baseMarketCap == 0) {
+        return 0.0;
+    }
+    return index.baseValue * static_cast<double>(index.marketCap) / static_cast<double>(index.baseMarketCap);
+}
+
+} // namespace nse::mtbt
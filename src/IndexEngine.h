@@ -0,0 +1,114 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SymbolIndex.h"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nse::mtbt {
+
+#if defined(__SIZEOF_INT128__)
+__extension__ using MarketCap = __int128;   // Exact sum of free-float shares * price
+#else
+using MarketCap = std::int64_t;
+#endif
+
+/**
+ * Free-float index definition (constituents and their base prices)
+ */
+struct IndexDefinition {
+    /**
+     * One constituent: free-float shares and the price at which the index was based
+     */
+    struct Constituent {
+        std::uint32_t symbolToken{0};
+        std::uint64_t freeFloatShares{0};
+        std::uint32_t basePriceInPaisa{0};
+    };
+
+    std::string name;
+    double baseValue{1000.0};
+    std::vector<Constituent> constituents;
+};
+
+/**
+ * Index level published after a constituent trade
+ */
+struct IndexTick {
+    std::uint32_t indexId{0};         // Position in the definition list
+    double level{0.0};
+    std::uint64_t timestamp{0};       // Timestamp of the triggering trade
+    std::uint32_t triggerSequence{0}; // Sequence number of the triggering trade
+};
+
+/**
+ * Real-time free-float weighted index engine
+ *
+ * Each index keeps its running market cap; a trade updates only the traded
+ * constituent's contribution (shares * price delta) in every index that
+ * holds it, found through a token -> index inverted list. Ticks are
+ * published synchronously from onTrade(), so latency after the trade is
+ * bounded by the number of indices containing that token.
+ */
+class IndexEngine {
+public:
+    using TickHandler = std::function<void(const IndexTick& tick)>;
+
+    IndexEngine(const std::vector<IndexDefinition>& definitions, TickHandler handler);
+
+    /**
+     * Load definitions from "index,symbol_or_token,free_float_shares,base_price_paisa" lines
+     */
+    [[nodiscard]] static std::optional<std::vector<IndexDefinition>> loadDefinitions(const std::string& path);
+
+    /**
+     * Apply a trade and publish ticks for every affected index
+     */
+    void onTrade(const TradeMessage& message);
+
+    template<typename Container>
+    void onTrades(const Container& messages) {
+        for (const auto& message : messages) {
+            onTrade(message);
+        }
+    }
+
+    [[nodiscard]] double level(std::uint32_t indexId) const noexcept;
+    [[nodiscard]] const std::string& name(std::uint32_t indexId) const noexcept { return indices_[indexId].name; }
+    [[nodiscard]] std::size_t indexCount() const noexcept { return indices_.size(); }
+    [[nodiscard]] std::uint64_t ticksPublished() const noexcept { return ticksPublished_; }
+
+private:
+    /**
+     * Running state of one index
+     */
+    struct IndexState {
+        std::string name;
+        double baseValue{1000.0};
+        MarketCap baseMarketCap{0};
+        MarketCap marketCap{0};
+    };
+
+    /**
+     * Inverted-list entry: an index holding a symbol, with its share count there
+     *
+     * The reference price is per membership: indices based at different
+     * prices for the same symbol each move from their own base.
+     */
+    struct Membership {
+        std::uint32_t indexId{0};
+        std::uint32_t lastPriceInPaisa{0};   // Base price until the first trade
+        std::uint64_t freeFloatShares{0};
+    };
+
+    TickHandler handler_;
+    SymbolIndex symbols_;
+    std::vector<IndexState> indices_;
+    std::vector<std::uint32_t> membershipStart_;   // CSR offsets per symbol id (+1 sentinel)
+    std::vector<Membership> memberships_;
+    std::uint64_t ticksPublished_{0};
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,293 @@
+#include "InstrumentLimits.h"
+#include "EventTracer.h"
+#include "Platform.h"
+#include "SymbolIndex.h"
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace nse::mtbt {
+
+namespace {
+
+struct Divisor {
+    std::uint32_t inverse;
+    std::uint32_t shift;
+    std::uint32_t maxQuotient;
+};
+
+Divisor divisorOf(std::uint32_t divisor) noexcept {
+    Divisor result{};
+    result.shift = static_cast<std::uint32_t>(__builtin_ctz(divisor));
+    const std::uint32_t odd = divisor >> result.shift;
+    // Newton's iteration doubles the correct low bits each step: 3 -> 6 -> 12 -> 24 -> 48
+    std::uint32_t inverse = odd;
+    for (int i = 0; i < 4; ++i) {
+        inverse *= 2u - odd * inverse;
+    }
+    result.inverse = inverse;
+    result.maxQuotient = 0xFFFF'FFFFu / divisor;
+    return result;
+}
+
+std::uint32_t rotateRight(std::uint32_t value, std::uint32_t shift) noexcept {
+    return shift == 0 ? value : (value >> shift) | (value << (32 - shift));
+}
+
+} // namespace
+
+InstrumentLimits::Table::Row InstrumentLimits::Table::Row::from(const Limits& limits) noexcept {
+    const auto tick = divisorOf(limits.tickSize);
+    const auto lot = divisorOf(limits.lotSize);
+    return Row{limits.lowerPrice, limits.upperPrice, limits.maxQuantity,
+               tick.inverse, tick.maxQuotient, lot.inverse, lot.maxQuotient,
+               tick.shift | (lot.shift << 8)};
+}
+
+InstrumentLimits::Table::Table() : tokenToRow_(1, 0) {
+    // Row 0: exchange-wide defaults for tokens without an entry
+    rows_.push_back(Row::from(Limits{}));
+    limits_.push_back(Limits{});
+}
+
+bool InstrumentLimits::Table::set(std::uint32_t token, const Limits& limits) {
+    if (token == 0 || token >= SymbolIndex::MAX_TOKEN || limits.tickSize == 0 || limits.lotSize == 0) {
+        return false;
+    }
+    if (token + 1 >= tokenToRow_.size()) {
+        tokenToRow_.resize(token + 2, 0);
+    }
+    
+    auto& row = tokenToRow_[token];
+    if (row == 0) {
+        row = static_cast<std::uint32_t>(rows_.size());
+        rows_.emplace_back();
+        limits_.emplace_back();
+    }
+    rows_[row] = Row::from(limits);
+    limits_[row] = limits;
+    return true;
+}
+
+InstrumentLimits::Limits InstrumentLimits::Table::get(std::uint32_t token) const noexcept {
+    return limits_[rowOf(token)];
+}
+
+namespace {
+
+using Row = InstrumentLimits::Table::Row;
+
+bool validScalar(const TradeMessage& message, const Row& row) noexcept {
+    const std::uint32_t price = message.priceInPaisa;
+    const std::uint32_t quantity = message.quantity;
+    
+    // Non-short-circuit ANDs keep this branch-free like the vector path
+    bool valid = message.sequenceNumber != 0;
+    valid &= message.symbolToken != 0;
+    valid &= message.timestamp != 0;
+    valid &= static_cast<std::uint8_t>(message.side) <= static_cast<std::uint8_t>(TradeSide::SELL);
+    valid &= price >= row.lowerPrice;
+    valid &= price <= row.upperPrice;
+    valid &= quantity != 0;
+    valid &= quantity <= row.maxQuantity;
+    valid &= rotateRight(price * row.tickInverse, row.shifts & 0xFF) <= row.tickMaxQuotient;
+    valid &= rotateRight(quantity * row.lotInverse, row.shifts >> 8) <= row.lotMaxQuotient;
+    return valid;
+}
+
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+
+// Eight TradeMessages transpose into lanes as: seq, token, ts lo, ts hi, price, qty, side, checksum
+static_assert(sizeof(TradeMessage) == 32 && offsetof(TradeMessage, symbolToken) == 4 &&
+              offsetof(TradeMessage, timestamp) == 8 && offsetof(TradeMessage, priceInPaisa) == 16 &&
+              offsetof(TradeMessage, quantity) == 20 && offsetof(TradeMessage, side) == 24,
+              "validateEightAvx2 assumes the 32-byte TradeMessage layout");
+static_assert(sizeof(Row) == 32, "a limits row is one AVX2 vector");
+
+/**
+ * In-place 8x8 transpose of 32-bit elements
+ */
+__attribute__((target("avx2")))
+inline void transpose8x8(__m256i (&r)[8]) noexcept {
+    const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/**
+ * Lane-wise rotr(n * inverse, shift) <= maxQuotient, i.e. n is a multiple of the divisor
+ */
+__attribute__((target("avx2")))
+inline __m256i isMultiple(__m256i n, __m256i inverse, __m256i shift, __m256i maxQuotient) noexcept {
+    const __m256i product = _mm256_mullo_epi32(n, inverse);
+    // sllv by 32 yields 0, so shift 0 needs no special case
+    const __m256i rotated = _mm256_or_si256(_mm256_srlv_epi32(product, shift),
+                                            _mm256_sllv_epi32(product, _mm256_sub_epi32(_mm256_set1_epi32(32), shift)));
+    return _mm256_cmpeq_epi32(_mm256_min_epu32(rotated, maxQuotient), rotated);
+}
+
+/**
+ * Validate 8 messages against their instruments' rows; bit i set if message i passes
+ */
+__attribute__((target("avx2")))
+std::uint32_t validateEightAvx2(const TradeMessage* messages, const Row* const* rows) noexcept {
+    __m256i field[8];
+    __m256i limit[8];
+    for (int i = 0; i < 8; ++i) {
+        field[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(messages + i));
+        limit[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(rows[i]));
+    }
+    transpose8x8(field);
+    transpose8x8(limit);
+    
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i price = field[4];
+    const __m256i quantity = field[5];
+    
+    __m256i invalid = _mm256_cmpeq_epi32(field[0], zero);
+    invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi32(field[1], zero));
+    invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi32(_mm256_or_si256(field[2], field[3]), zero));
+    invalid = _mm256_or_si256(invalid, _mm256_cmpgt_epi32(_mm256_and_si256(field[6], _mm256_set1_epi32(0xFF)),
+                                                          _mm256_set1_epi32(static_cast<int>(TradeSide::SELL))));
+    invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi32(quantity, zero));
+    
+    // a >= b as max(a, b) == a, a <= b as min(a, b) == a (unsigned)
+    __m256i valid = _mm256_cmpeq_epi32(_mm256_max_epu32(price, limit[0]), price);
+    valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(_mm256_min_epu32(price, limit[1]), price));
+    valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(_mm256_min_epu32(quantity, limit[2]), quantity));
+    valid = _mm256_and_si256(valid, isMultiple(price, limit[3], _mm256_and_si256(limit[7], _mm256_set1_epi32(0xFF)), limit[4]));
+    valid = _mm256_and_si256(valid, isMultiple(quantity, limit[5], _mm256_srli_epi32(limit[7], 8), limit[6]));
+    valid = _mm256_andnot_si256(invalid, valid);
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(valid)));
+}
+#endif
+
+} // namespace
+
+std::uint64_t InstrumentLimits::validateBatch(const Table& table, const TradeMessage* messages, std::size_t count) noexcept {
+    MTBT_TRACE_SCOPE("InstrumentLimits::validateBatch");
+    count = std::min(count, BATCH_MESSAGES);
+    std::uint64_t mask = 0;
+    std::size_t i = 0;
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+    if (cpuHasAvx2()) {
+        const Row* rows[8];
+        for (; i + 8 <= count; i += 8) {
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                rows[lane] = &table.rows_[table.rowOf(messages[i + lane].symbolToken)];
+            }
+            mask |= static_cast<std::uint64_t>(validateEightAvx2(messages + i, rows)) << i;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        mask |= static_cast<std::uint64_t>(validScalar(messages[i], table.rows_[table.rowOf(messages[i].symbolToken)])) << i;
+    }
+    return mask;
+}
+
+InstrumentLimits::InstrumentLimits(Table table) : table_{std::make_unique<Table>(std::move(table))} {}
+
+InstrumentLimits::~InstrumentLimits() {
+    {
+        std::lock_guard<std::mutex> lock{watchMutex_};
+        stopWatching_ = true;
+    }
+    watchWakeup_.notify_all();
+    if (watcher_.joinable()) {
+        watcher_.join();
+    }
+}
+
+std::optional<InstrumentLimits::Table> InstrumentLimits::loadTable(const std::string& path) {
+    std::ifstream file{path};
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    Table table;
+    for (std::string line; std::getline(file, line);) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields{line};
+        std::string symbol, lower, upper, tick, lot, maxQuantity;
+        if (!std::getline(fields, symbol, ',') || !std::getline(fields, lower, ',') ||
+            !std::getline(fields, upper, ',') || !std::getline(fields, tick, ',') ||
+            !std::getline(fields, lot, ',')) {
+            return std::nullopt;
+        }
+
+        Limits limits;
+        std::uint32_t token = 0;
+        try {
+            const auto known = SymbolRegistry::findToken(symbol);
+            token = known ? *known : static_cast<std::uint32_t>(std::stoul(symbol));
+            limits.lowerPrice = static_cast<std::uint32_t>(std::stoul(lower));
+            limits.upperPrice = static_cast<std::uint32_t>(std::stoul(upper));
+            limits.tickSize = static_cast<std::uint32_t>(std::stoul(tick));
+            limits.lotSize = static_cast<std::uint32_t>(std::stoul(lot));
+            if (std::getline(fields, maxQuantity, ',')) {
+                limits.maxQuantity = static_cast<std::uint32_t>(std::stoul(maxQuantity));
+            }
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+        if (!table.set(token, limits)) {
+            return std::nullopt;
+        }
+    }
+
+    return table;
+}
+
+void InstrumentLimits::update(Table table) {
+    table_.update(std::make_unique<Table>(std::move(table)));
+    updates_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InstrumentLimits::watch(const std::string& path, std::chrono::milliseconds interval) {
+    if (watcher_.joinable()) {
+        return;
+    }
+    watcher_ = std::thread([this, path, interval] {
+        std::error_code error;
+        auto lastWrite = std::filesystem::last_write_time(path, error);
+        std::unique_lock<std::mutex> lock{watchMutex_};
+        while (!watchWakeup_.wait_for(lock, interval, [this] { return stopWatching_; })) {
+            const auto writeTime = std::filesystem::last_write_time(path, error);
+            if (error || writeTime == lastWrite) {
+                continue;
+            }
+            lastWrite = writeTime;
+            if (auto table = loadTable(path)) {
+                update(std::move(*table));
+            }
+        }
+    });
+}
+
+} // namespace nse::mtbt
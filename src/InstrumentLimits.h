@@ -0,0 +1,146 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "Rcu.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Per-instrument price bands, tick size and lot size
+ *
+ * Limits live in an immutable table of 32-byte rows indexed by dense
+ * instrument id; row 0 holds the exchange-wide defaults that
+ * TradeMessage::validate() applies, so unknown tokens behave as before.
+ * A block of decoded messages is checked eight at a time with AVX2 where the
+ * CPU has it (eight messages and their eight rows transposed into lanes),
+ * producing a validity bitmask. Tables are swapped RCU-style, so
+ * limits can be replaced intraday while decoding continues.
+ */
+class InstrumentLimits {
+public:
+    /**
+     * Limits of one instrument; prices in paisa
+     */
+    struct Limits {
+        std::uint32_t lowerPrice{5};           // Lower band (inclusive)
+        std::uint32_t upperPrice{10'000'000};  // Upper band (inclusive)
+        std::uint32_t tickSize{1};             // Price must be a multiple
+        std::uint32_t lotSize{1};              // Quantity must be a multiple
+        std::uint32_t maxQuantity{10'000'000}; // Per-trade freeze quantity
+    };
+
+    /**
+     * Immutable token -> limits table
+     */
+    class Table {
+    public:
+        /**
+         * One instrument's limits in check-ready form: eight 32-bit words, one AVX2 load
+         *
+         * Multiples are tested as rotr(n * inverse, shift) <= maxQuotient
+         * (Granlund-Montgomery), so no lane needs a division.
+         */
+        struct alignas(32) Row {
+            std::uint32_t lowerPrice;
+            std::uint32_t upperPrice;
+            std::uint32_t maxQuantity;
+            std::uint32_t tickInverse;      // Inverse of tick size's odd part mod 2^32
+            std::uint32_t tickMaxQuotient;
+            std::uint32_t lotInverse;
+            std::uint32_t lotMaxQuotient;
+            std::uint32_t shifts;           // Tick size trailing zeros | lot size trailing zeros << 8
+
+            [[nodiscard]] static Row from(const Limits& limits) noexcept;
+        };
+
+        Table();
+
+        /**
+         * Add or replace the limits of a token (tick and lot sizes must be non-zero)
+         */
+        bool set(std::uint32_t token, const Limits& limits);
+
+        [[nodiscard]] Limits get(std::uint32_t token) const noexcept;
+        [[nodiscard]] std::size_t instrumentCount() const noexcept { return rows_.size() - 1; }
+
+    private:
+        friend class InstrumentLimits;
+
+        // tokenToRow_ always ends with a 0 entry, so clamped out-of-range tokens hit the defaults
+        std::vector<std::uint32_t> tokenToRow_;
+        std::vector<Row> rows_;        // Per dense instrument id
+        std::vector<Limits> limits_;   // As configured, for get()
+
+        [[nodiscard]] std::uint32_t rowOf(std::uint32_t token) const noexcept {
+            return tokenToRow_[token < tokenToRow_.size() ? token : tokenToRow_.size() - 1];
+        }
+    };
+
+    /**
+     * Messages covered by one mask word
+     */
+    static constexpr std::size_t BATCH_MESSAGES = 64;
+
+    InstrumentLimits() : InstrumentLimits(Table{}) {}
+    explicit InstrumentLimits(Table table);
+    ~InstrumentLimits();
+
+    InstrumentLimits(const InstrumentLimits&) = delete;
+    InstrumentLimits& operator=(const InstrumentLimits&) = delete;
+
+    /**
+     * Parse "symbol_or_token,lower_paisa,upper_paisa,tick_paisa,lot_size[,max_quantity]" lines ('#' comments)
+     */
+    [[nodiscard]] static std::optional<Table> loadTable(const std::string& path);
+
+    /**
+     * Replace the whole table; decoding threads pick it up at their next batch
+     */
+    void update(Table table);
+
+    /**
+     * Reload the table whenever the file's modification time changes
+     *
+     * A background thread polls the file; a file that fails to parse keeps
+     * the current limits in force.
+     */
+    void watch(const std::string& path, std::chrono::milliseconds interval = std::chrono::seconds{1});
+
+    /**
+     * Pin the current table for the duration of a batch
+     */
+    [[nodiscard]] RcuPointer<Table>::ReadGuard acquire() const noexcept { return table_.read(); }
+
+    /**
+     * Check up to BATCH_MESSAGES messages; bit i of the result is set if message i is valid
+     *
+     * Applies every TradeMessage::validate() rule, with the price band and
+     * quantity cap taken from the message's instrument, plus tick and lot
+     * size multiples.
+     */
+    [[nodiscard]] static std::uint64_t validateBatch(const Table& table, const TradeMessage* messages, std::size_t count) noexcept;
+
+    /**
+     * Number of table swaps so far (initial table excluded)
+     */
+    [[nodiscard]] std::uint64_t updateCount() const noexcept { return updates_.load(std::memory_order_relaxed); }
+
+private:
+    RcuPointer<Table> table_;
+    std::atomic<std::uint64_t> updates_{0};
+
+    std::mutex watchMutex_;
+    std::condition_variable watchWakeup_;
+    bool stopWatching_{false};
+    std::thread watcher_;
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nse::mtbt {
+
+/**
+ * Log-linear latency histogram (8 sub-buckets per power of two, ~12% resolution)
+ *
+ * Fixed size and allocation-free, so it can be recorded into from the hot
+ * path and copied wholesale into shared memory or across threads.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t SUB_BUCKET_BITS = 3;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+    static constexpr std::size_t MAX_EXPONENT = 40;  // Values >= 2^41 ns (~36 min) saturate
+    static constexpr std::size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    using Counts = std::array<std::uint64_t, BUCKET_COUNT>;
+
+    /**
+     * Bucket index for a value
+     */
+    [[nodiscard]] static constexpr std::size_t bucketFor(std::uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        std::size_t exponent = 63;
+        while (!((value >> exponent) & 1u)) {
+            --exponent;
+        }
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        const std::size_t sub = static_cast<std::size_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    /**
+     * Largest value that maps to a bucket
+     */
+    [[nodiscard]] static constexpr std::uint64_t bucketUpperBound(std::size_t bucket) noexcept {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const std::size_t shift = bucket / SUB_BUCKETS - 1;
+        const std::uint64_t lower = static_cast<std::uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return lower + (std::uint64_t{1} << shift) - 1;
+    }
+
+    /**
+     * Value at quantile q (0..1) of a bucket count array; 0 when empty
+     */
+    [[nodiscard]] static std::uint64_t percentile(const Counts& counts, double q) noexcept {
+        std::uint64_t total = 0;
+        for (const auto count : counts) {
+            total += count;
+        }
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+            seen += counts[bucket];
+            if (seen >= rank) {
+                return bucketUpperBound(bucket);
+            }
+        }
+        return bucketUpperBound(BUCKET_COUNT - 1);
+    }
+
+    void record(std::uint64_t value) noexcept {
+        ++counts_[bucketFor(value)];
+        ++count_;
+        sum_ += value;
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        if (other.max_ > max_) {
+            max_ = other.max_;
+        }
+    }
+
+    void reset() noexcept { *this = LatencyHistogram{}; }
+
+    [[nodiscard]] std::uint64_t percentile(double q) const noexcept {
+        const std::uint64_t bound = percentile(counts_, q);
+        return bound < max_ ? bound : max_;
+    }
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] std::uint64_t sum() const noexcept { return sum_; }
+    [[nodiscard]] std::uint64_t max() const noexcept { return max_; }
+    [[nodiscard]] double mean() const noexcept {
+        return count_ > 0 ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+    [[nodiscard]] const Counts& counts() const noexcept { return counts_; }
+
+private:
+    Counts counts_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,182 @@
+#include "MergeReplay.h"
+#include <algorithm>
+#include <limits>
+
+namespace nse::mtbt {
+
+MergeReplay::Stream::Stream(CaptureFile file, std::size_t batchCount)
+    : capture{std::move(file)}, batches(batchCount), ready{batchCount}, free{batchCount} {}
+
+MergeReplay::MergeReplay(std::vector<CaptureFile> inputs, Config config) : config_{config} {
+    config_.batchMessages = std::max<std::size_t>(config_.batchMessages, 1);
+    const std::size_t batchCount = config_.decodeAhead ? std::max<std::size_t>(config_.batchesInFlight, 2) : 1;
+    
+    streams_.reserve(inputs.size());
+    for (auto& input : inputs) {
+        streams_.push_back(std::make_unique<Stream>(std::move(input), batchCount));
+        streams_.back()->decoder.setValidationLevel(config_.validationLevel);
+        streams_.back()->decoder.setInstrumentLimits(config_.instrumentLimits);
+        streams_.back()->decoder.setSubscriptionFilter(config_.subscriptionFilter);
+        streams_.back()->decoder.setMaxSequenceJump(config_.maxSequenceJump);
+    }
+}
+
+MergeReplay::~MergeReplay() {
+    stopping_.store(true, std::memory_order_relaxed);
+    for (auto& stream : streams_) {
+        if (stream->worker.joinable()) {
+            stream->worker.join();
+        }
+    }
+}
+
+bool MergeReplay::decodeNextBatch(Stream& stream, std::uint32_t batch) {
+    const std::size_t size = stream.capture.size();
+    auto& messages = stream.batches[batch];
+    messages.clear();
+    
+    // Skip batches that decode to nothing (all frames corrupt or filtered)
+    while (messages.empty() && stream.decodeOffset < size) {
+        const std::size_t bytes = std::min(config_.batchMessages * ProtocolConstants::MESSAGE_SIZE,
+                                           size - stream.decodeOffset);
+        const auto before = stream.decoder.getCaptureOffset();
+        stream.decoder.decodeFeedInto(stream.capture.data() + stream.decodeOffset, bytes, messages);
+        const auto consumed = stream.decoder.getCaptureOffset() - before;
+        stream.decodeOffset += consumed > 0 ? consumed : bytes; // Trailing partial frame ends the input
+    }
+    return !messages.empty();
+}
+
+void MergeReplay::decodeAheadLoop(Stream& stream) {
+    std::uint32_t batch = 0;
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        if (!stream.free.tryPop(batch)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (!decodeNextBatch(stream, batch)) {
+            break;
+        }
+        while (!stream.ready.tryPush(batch)) {
+            std::this_thread::yield(); // Cannot happen: ready and free share the batch pool
+        }
+    }
+    stream.finished.store(true, std::memory_order_release);
+}
+
+bool MergeReplay::advance(Stream& stream) {
+    if (stream.exhausted) {
+        return false;
+    }
+    if (stream.holdsBatch && ++stream.cursor < stream.batches[stream.currentBatch].size()) {
+        return true;
+    }
+    stream.cursor = 0;
+    
+    if (!config_.decodeAhead) {
+        stream.holdsBatch = decodeNextBatch(stream, 0);
+        stream.exhausted = !stream.holdsBatch;
+        return stream.holdsBatch;
+    }
+    
+    // Hand the drained batch back and wait for the next decoded one
+    if (stream.holdsBatch) {
+        (void)stream.free.tryPush(stream.currentBatch);
+        stream.holdsBatch = false;
+    }
+    for (;;) {
+        if (stream.ready.tryPop(stream.currentBatch)) {
+            stream.holdsBatch = true;
+            return true;
+        }
+        if (stream.finished.load(std::memory_order_acquire)) {
+            stream.holdsBatch = stream.ready.tryPop(stream.currentBatch);
+            stream.exhausted = !stream.holdsBatch;
+            return stream.holdsBatch;
+        }
+        std::this_thread::yield();
+    }
+}
+
+std::uint64_t MergeReplay::headTimestamp(std::uint32_t input) const noexcept {
+    const auto& stream = *streams_[input];
+    return stream.exhausted ? std::numeric_limits<std::uint64_t>::max()
+                            : stream.batches[stream.currentBatch][stream.cursor].timestamp;
+}
+
+bool MergeReplay::before(std::uint32_t a, std::uint32_t b) const noexcept {
+    const auto left = headTimestamp(a);
+    const auto right = headTimestamp(b);
+    return left < right || (left == right && a < b);
+}
+
+void MergeReplay::buildTree() {
+    const auto count = static_cast<std::uint32_t>(streams_.size());
+    tree_.assign(count, 0);
+    
+    // winners[count + i] is leaf i; internal node n plays its two children
+    std::vector<std::uint32_t> winners(2 * count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        winners[count + i] = i;
+    }
+    for (std::uint32_t node = count - 1; node >= 1; --node) {
+        const auto left = winners[2 * node];
+        const auto right = winners[2 * node + 1];
+        const bool leftWins = before(left, right);
+        winners[node] = leftWins ? left : right;
+        tree_[node] = leftWins ? right : left;
+    }
+    tree_[0] = count > 1 ? winners[1] : 0;
+}
+
+void MergeReplay::replay(std::uint32_t input) {
+    // Only the path from the changed leaf to the root is replayed
+    std::uint32_t winner = input;
+    for (auto node = static_cast<std::uint32_t>((streams_.size() + input) / 2); node >= 1; node /= 2) {
+        if (before(tree_[node], winner)) {
+            std::swap(tree_[node], winner);
+        }
+    }
+    tree_[0] = winner;
+}
+
+std::uint64_t MergeReplay::run(const TradeHandler& handler) {
+    if (streams_.empty()) {
+        return 0;
+    }
+    
+    // Prime every input with its first batch
+    for (auto& streamPtr : streams_) {
+        auto& stream = *streamPtr;
+        if (config_.decodeAhead) {
+            for (std::uint32_t batch = 0; batch < stream.batches.size(); ++batch) {
+                (void)stream.free.tryPush(batch);
+            }
+            stream.worker = std::thread{[this, &stream] { decodeAheadLoop(stream); }};
+        }
+        (void)advance(stream);
+    }
+    buildTree();
+    
+    std::uint64_t delivered = 0;
+    for (;;) {
+        const std::uint32_t input = tree_[0];
+        auto& stream = *streams_[input];
+        if (stream.exhausted) {
+            break; // The winner is exhausted only when every input is
+        }
+        handler(input, stream.batches[stream.currentBatch][stream.cursor]);
+        ++delivered;
+        advance(stream);
+        replay(input);
+    }
+    
+    for (auto& stream : streams_) {
+        if (stream->worker.joinable()) {
+            stream->worker.join();
+        }
+    }
+    return delivered;
+}
+
+} // namespace nse::mtbt
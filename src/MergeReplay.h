@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CaptureFile.h"
+#include "Decoder.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Timestamp-ordered replay of several captures (e.g. one per exchange segment)
+ *
+ * Every input keeps its own Decoder and is decoded lazily in batches; with
+ * decode-ahead enabled each input gets a worker thread that stays a few
+ * batches in front of the merge. A loser tree picks the next trade in
+ * O(log K) comparisons; equal timestamps resolve by input order, so the
+ * output is deterministic.
+ */
+class MergeReplay {
+public:
+    struct Config {
+        std::size_t batchMessages{4096};
+        std::size_t batchesInFlight{4};  // Per input, decode-ahead only
+        bool decodeAhead{true};
+        ValidationLevel validationLevel{ValidationLevel::STRICT};
+        const InstrumentLimits* instrumentLimits{nullptr};  // Shared by all input decoders
+        const SubscriptionFilter* subscriptionFilter{nullptr};  // Shared by all input decoders
+        std::uint32_t maxSequenceJump{Decoder::DEFAULT_MAX_SEQUENCE_JUMP};
+        
+        Config() = default;
+    };
+
+    using TradeHandler = std::function<void(std::size_t input, const TradeMessage& message)>;
+
+    MergeReplay(std::vector<CaptureFile> inputs, Config config);
+    ~MergeReplay();
+
+    MergeReplay(const MergeReplay&) = delete;
+    MergeReplay& operator=(const MergeReplay&) = delete;
+
+    /**
+     * Replay every input to completion in timestamp order; returns trades delivered
+     */
+    std::uint64_t run(const TradeHandler& handler);
+
+    /**
+     * Decoder statistics of one input (complete once run() returns)
+     */
+    [[nodiscard]] const Decoder::DecodingStats& getStats(std::size_t input) const noexcept {
+        return streams_[input]->decoder.getStats();
+    }
+
+    [[nodiscard]] std::size_t inputCount() const noexcept { return streams_.size(); }
+
+private:
+    /**
+     * One input: its capture, decoder and batch pipeline
+     */
+    struct Stream {
+        Stream(CaptureFile file, std::size_t batchCount);
+        
+        CaptureFile capture;
+        Decoder decoder;
+        std::size_t decodeOffset{0};                // Producer position in the capture
+        std::vector<Decoder::MessageBuffer> batches;
+        SpscQueue<std::uint32_t> ready;             // Decoded batches, producer -> merge
+        SpscQueue<std::uint32_t> free;              // Consumed batches, merge -> producer
+        std::atomic<bool> finished{false};
+        std::thread worker;
+        
+        // Merge-side cursor
+        std::uint32_t currentBatch{0};
+        std::size_t cursor{0};
+        bool holdsBatch{false};
+        bool exhausted{false};
+    };
+
+    Config config_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::vector<std::uint32_t> tree_;   // tree_[0] is the winner, tree_[1..K) hold losers
+    std::atomic<bool> stopping_{false};
+
+    void decodeAheadLoop(Stream& stream);
+    bool decodeNextBatch(Stream& stream, std::uint32_t batch);
+    bool advance(Stream& stream);
+    [[nodiscard]] std::uint64_t headTimestamp(std::uint32_t input) const noexcept;
+    [[nodiscard]] bool before(std::uint32_t a, std::uint32_t b) const noexcept;
+    void buildTree();
+    void replay(std::uint32_t input);
+};
+
+} // namespace nse::mtbt
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "WireSchema.h"
 #include <cstdint>
 #include <string>
 #include <optional>
@@ -22,6 +23,18 @@ public:
         return (it != tokenToSymbol.end()) ? std::optional<std::string>{it->second} : std::nullopt;
     }
     
+    /**
+     * Reverse lookup by symbol name (linear; for configuration, not the hot path)
+     */
+    [[nodiscard]] static std::optional<std::uint32_t> findToken(std::string_view symbol) noexcept {
+        for (const auto& [token, name] : tokenToSymbol) {
+            if (name == symbol) {
+                return token;
+            }
+        }
+        return std::nullopt;
+    }
+    
     [[nodiscard]] static std::string getSymbolOrToken(std::uint32_t token) noexcept {
         if (auto symbol = getSymbol(token)) {
             return *symbol;
@@ -80,18 +93,19 @@ public:
  * NSE MTBT binary protocol constants
  */
 struct ProtocolConstants {
-    static constexpr std::size_t MESSAGE_SIZE = 40;  // NSE MTBT message size
+    static constexpr std::size_t MESSAGE_SIZE = wire::TradeFrame::SIZE;  // NSE MTBT message size
     static constexpr std::size_t HEADER_SIZE = 8;    // Message header size
     static constexpr std::uint32_t MAGIC_BYTES = 0xDEADBEEF;  // Protocol magic
     
-    // Field offsets in the binary message
-    static constexpr std::size_t OFFSET_SEQUENCE = 0;
-    static constexpr std::size_t OFFSET_SYMBOL_TOKEN = 4;
-    static constexpr std::size_t OFFSET_TIMESTAMP = 8;
-    static constexpr std::size_t OFFSET_PRICE = 16;
-    static constexpr std::size_t OFFSET_QUANTITY = 20;
-    static constexpr std::size_t OFFSET_SIDE = 24;
-    static constexpr std::size_t OFFSET_CHECKSUM = 36;
+    // Field offsets in the binary message (declared once, in wire::TradeFrame)
+    static constexpr std::size_t OFFSET_SEQUENCE = wire::TradeFrame::Sequence::OFFSET;
+    static constexpr std::size_t OFFSET_SYMBOL_TOKEN = wire::TradeFrame::SymbolToken::OFFSET;
+    static constexpr std::size_t OFFSET_TIMESTAMP = wire::TradeFrame::Timestamp::OFFSET;
+    static constexpr std::size_t OFFSET_PRICE = wire::TradeFrame::Price::OFFSET;
+    static constexpr std::size_t OFFSET_QUANTITY = wire::TradeFrame::Quantity::OFFSET;
+    static constexpr std::size_t OFFSET_SIDE = wire::TradeFrame::Side::OFFSET;
+    static constexpr std::size_t OFFSET_STREAM_ID = wire::TradeFrame::StreamId::OFFSET;
+    static constexpr std::size_t OFFSET_CHECKSUM = wire::TradeFrame::Checksum::OFFSET;
 };
 
 /**
@@ -133,6 +147,7 @@ struct TradeMessage {
     std::uint32_t priceInPaisa{0};    // Trade price in paisa (1/100 rupee)
     std::uint32_t quantity{0};        // Trade quantity
     TradeSide side{TradeSide::BUY};   // Trade side (BUY/SELL)
+    std::uint16_t streamId{0};        // Stream (sequence space) within the segment
     std::uint32_t checksum{0};        // CRC32 checksum
     
     TradeMessage() = default;
@@ -227,6 +242,36 @@ struct TradeMessage {
     }
 };
 
+/**
+ * Side byte on the wire: 0 is BUY, anything else decodes as SELL
+ */
+struct TradeSideConversion {
+    template<typename Member>
+    [[nodiscard]] static constexpr TradeSide fromWire(std::uint8_t value) noexcept {
+        return value == 0 ? TradeSide::BUY : TradeSide::SELL;
+    }
+    
+    template<typename Wire>
+    [[nodiscard]] static constexpr std::uint8_t toWire(TradeSide side) noexcept {
+        return static_cast<std::uint8_t>(side);
+    }
+};
+
+/**
+ * TradeMessage <-> 40-byte frame, used by both the decoder and the simulator
+ */
+using TradeCodec = wire::Codec<TradeMessage,
+    wire::Bind<&TradeMessage::sequenceNumber, wire::TradeFrame::Sequence>,
+    wire::Bind<&TradeMessage::symbolToken, wire::TradeFrame::SymbolToken>,
+    wire::Bind<&TradeMessage::timestamp, wire::TradeFrame::Timestamp>,
+    wire::Bind<&TradeMessage::priceInPaisa, wire::TradeFrame::Price>,
+    wire::Bind<&TradeMessage::quantity, wire::TradeFrame::Quantity>,
+    wire::Bind<&TradeMessage::side, wire::TradeFrame::Side, TradeSideConversion>,
+    wire::Bind<&TradeMessage::streamId, wire::TradeFrame::StreamId>,
+    wire::Bind<&TradeMessage::checksum, wire::TradeFrame::Checksum>>;
+
+static_assert(TradeCodec::END == ProtocolConstants::MESSAGE_SIZE, "TradeCodec must cover the whole frame");
+
 /**
  * Helper functions
  */
@@ -0,0 +1,806 @@
+#include "PerfHarness.h"
+#include "CaptureIndex.h"
+#include "Checkpoint.h"
+#include "Decoder.h"
+#include "FeedSimulator.h"
+#include "LatencyHistogram.h"
+#include "QuantileSketch.h"
+#include "StreamDemux.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt::bench {
+
+namespace {
+
+using utils::colors::BOLD;
+using utils::colors::CYAN;
+using utils::colors::GREEN;
+using utils::colors::RED;
+using utils::colors::RESET;
+using utils::colors::YELLOW;
+
+constexpr std::size_t BATCH_FRAMES = 4096;
+constexpr double MAX_SPREAD_ALLOWANCE_PERCENT = 5.0;   // Most of the baseline's own spread added to the threshold
+
+/**
+ * Hardware counters for one scenario; unavailable in most containers and VMs
+ */
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        fds_[0] = open(PERF_COUNT_HW_CPU_CYCLES);
+        fds_[1] = open(PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[2] = open(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (const int fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const noexcept { return fds_[0] >= 0 && fds_[1] >= 0; }
+    [[nodiscard]] bool cacheMissesAvailable() const noexcept { return fds_[2] >= 0; }
+
+    void start() noexcept { control(true); }
+    void stop() noexcept { control(false); }
+
+    [[nodiscard]] std::uint64_t cycles() const noexcept { return value(0); }
+    [[nodiscard]] std::uint64_t instructions() const noexcept { return value(1); }
+    [[nodiscard]] std::uint64_t cacheMisses() const noexcept { return value(2); }
+
+private:
+    int fds_[3]{-1, -1, -1};
+
+#if defined(__linux__)
+    static int open(std::uint64_t config) noexcept {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    void control(bool enable) noexcept {
+#if defined(__linux__)
+        for (const int fd : fds_) {
+            if (fd >= 0) {
+                ::ioctl(fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#else
+        (void)enable;
+#endif
+    }
+
+    [[nodiscard]] std::uint64_t value(std::size_t index) const noexcept {
+        std::uint64_t count = 0;
+#if defined(__linux__)
+        if (fds_[index] >= 0 && ::read(fds_[index], &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+            count = 0;
+        }
+#else
+        (void)index;
+#endif
+        return count;
+    }
+};
+
+/**
+ * Pin to one CPU so runs are comparable; returns the CPU used or -1
+ */
+int pinToCpu(int requested) noexcept {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return -1;
+    }
+    int cpu = requested;
+    for (int i = 0; cpu < 0 && i < CPU_SETSIZE; ++i) {
+        if (CPU_ISSET(i, &allowed)) {
+            cpu = i;
+        }
+    }
+    cpu_set_t target;
+    CPU_ZERO(&target);
+    CPU_SET(cpu, &target);
+    return ::sched_setaffinity(0, sizeof(target), &target) == 0 ? cpu : -1;
+#else
+    (void)requested;
+    return -1;
+#endif
+}
+
+/**
+ * Reset the kernel's peak-RSS mark so each scenario reports its own peak
+ */
+void resetPeakRss() noexcept {
+#if defined(__linux__)
+    if (std::FILE* file = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+std::uint64_t peakRssKb() {
+#if defined(__linux__)
+    std::ifstream status{"/proc/self/status"};
+    for (std::string line; std::getline(status, line);) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoull(line.substr(6));
+        }
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Everything a scenario run needs
+ */
+struct RunContext {
+    Decoder decoder;
+    Decoder::MessageBuffer batch;
+    LatencyHistogram& batchLatency;
+    std::uint64_t messages{0};
+
+    explicit RunContext(LatencyHistogram& histogram) : batchLatency{histogram} {}
+
+    /**
+     * Decode in fixed batches, timing each batch; calls sink with every decoded batch
+     */
+    template<typename Sink>
+    void decode(const std::vector<std::uint8_t>& feed, Sink&& sink) {
+        const std::size_t batchBytes = BATCH_FRAMES * ProtocolConstants::MESSAGE_SIZE;
+        for (std::size_t offset = 0; offset < feed.size(); offset += batchBytes) {
+            const auto start = std::chrono::steady_clock::now();
+            decoder.decodeFeedInto(feed.data() + offset, std::min(batchBytes, feed.size() - offset), batch);
+            sink(batch);
+            batchLatency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count()));
+            messages += batch.size();
+        }
+    }
+};
+
+struct Scenario {
+    std::string name;
+    std::function<void(RunContext&)> run;
+};
+
+struct ScenarioResult {
+    std::string name;
+    std::uint64_t messages{0};
+    double messagesPerSecond{0.0};       // Median run
+    double bestMessagesPerSecond{0.0};   // Fastest run: noise only ever slows a run down
+    double spreadPercent{0.0};           // (fastest - slowest) / fastest
+    double nsPerMessage{0.0};
+    std::uint64_t p99BatchNs{0};
+    std::uint64_t peakRssKb{0};
+    std::optional<double> ipc;
+    std::optional<double> cacheMissesPerMessage;
+};
+
+/**
+ * Time runs of several scenarios, interleaved round by round
+ *
+ * Interleaving spreads each scenario's runs over the whole measurement, so
+ * a slow phase of the machine (another tenant, thermal throttling) costs
+ * every scenario one run instead of costing one scenario all of them.
+ */
+std::vector<ScenarioResult> measure(const std::vector<const Scenario*>& scenarios, std::size_t runs) {
+    struct State {
+        LatencyHistogram batchLatency;
+        PerfCounters counters;
+        std::vector<double> rates;
+        std::uint64_t messages{0};
+        std::uint64_t peakRssKb{0};
+    };
+    std::vector<State> states(scenarios.size());
+
+    for (std::size_t run = 0; run <= runs; ++run) {
+        for (std::size_t i = 0; i < scenarios.size(); ++i) {
+            auto& state = states[i];
+            RunContext context{state.batchLatency};
+            const bool warmup = run == 0;
+            resetPeakRss();
+            if (!warmup) {
+                state.counters.start();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            scenarios[i]->run(context);
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            state.peakRssKb = std::max(state.peakRssKb, peakRssKb());
+            if (warmup) {
+                state.batchLatency.reset(); // The first run pays for page faults and cold caches
+                continue;
+            }
+            state.counters.stop();
+            state.messages = context.messages;
+            state.rates.push_back(elapsed > 0 ? static_cast<double>(context.messages) / elapsed : 0.0);
+        }
+    }
+
+    std::vector<ScenarioResult> results(scenarios.size());
+    for (std::size_t i = 0; i < scenarios.size(); ++i) {
+        auto& state = states[i];
+        auto& rates = state.rates;
+        auto& result = results[i];
+        result.name = scenarios[i]->name;
+        result.messages = state.messages;
+
+        std::sort(rates.begin(), rates.end());
+        result.messagesPerSecond = rates.empty() ? 0.0 : rates[rates.size() / 2];
+        result.bestMessagesPerSecond = rates.empty() ? 0.0 : rates.back();
+        result.spreadPercent = result.bestMessagesPerSecond > 0
+            ? (rates.back() - rates.front()) / result.bestMessagesPerSecond * 100.0 : 0.0;
+        result.nsPerMessage = result.messagesPerSecond > 0 ? 1e9 / result.messagesPerSecond : 0.0;
+        result.p99BatchNs = state.batchLatency.percentile(0.99);
+        result.peakRssKb = state.peakRssKb;
+
+        const double totalMessages = static_cast<double>(result.messages) * static_cast<double>(runs);
+        const auto& counters = state.counters;
+        if (counters.available() && counters.cycles() > 0) {
+            result.ipc = static_cast<double>(counters.instructions()) / static_cast<double>(counters.cycles());
+        }
+        if (counters.cacheMissesAvailable() && totalMessages > 0) {
+            result.cacheMissesPerMessage = static_cast<double>(counters.cacheMisses()) / totalMessages;
+        }
+    }
+    return results;
+}
+
+/**
+ * Fixed-seed behaviour check run before anything is timed
+ *
+ * A change that makes decoding faster by getting it wrong must fail the
+ * harness, not improve its numbers.
+ */
+struct SelfCheck {
+    std::string name;
+    std::function<std::optional<std::string>()> run;   // What went wrong, nullopt when the check holds
+};
+
+std::string describeStats(const Decoder::DecodingStats& stats, std::uint32_t lastSequence) {
+    std::ostringstream oss;
+    oss << stats.validMessages << " valid, " << stats.errorCount << " errors, " << stats.sequenceGaps << " gaps, "
+        << stats.missingMessages << " missing, last seq " << lastSequence;
+    return oss.str();
+}
+
+/**
+ * Decoding a feed in one go must match decoding half, checkpointing to disk and resuming in a fresh decoder
+ */
+std::optional<std::string> checkCheckpointRoundTrip(const std::vector<std::uint8_t>& feed) {
+    Decoder whole;
+    const auto expectedMessages = whole.decodeFeed(feed).size();
+
+    const std::size_t half = feed.size() / 2 / ProtocolConstants::MESSAGE_SIZE * ProtocolConstants::MESSAGE_SIZE;
+    Decoder first;
+    auto messages = first.decodeFeed(feed.data(), half).size();
+    const auto path = (std::filesystem::temp_directory_path() / "mtbt_selfcheck.ckpt").string();
+    if (!saveCheckpoint(path, first.captureSnapshot())) {
+        return "could not write " + path;
+    }
+    const auto loaded = loadCheckpoint(path);
+    std::filesystem::remove(path);
+    if (!loaded || loaded->captureOffset > feed.size()) {
+        return std::string{"checkpoint did not load back"};
+    }
+
+    Decoder resumed;
+    resumed.restoreSnapshot(*loaded);
+    messages += resumed.decodeFeed(feed.data() + loaded->captureOffset, feed.size() - loaded->captureOffset).size();
+
+    const auto& expected = whole.getStats();
+    const auto& actual = resumed.getStats();
+    const auto expectedLast = whole.captureSnapshot().lastSequence;
+    const auto actualLast = resumed.captureSnapshot().lastSequence;
+    if (messages != expectedMessages || actual.validMessages != expected.validMessages ||
+        actual.errorCount != expected.errorCount || actual.sequenceGaps != expected.sequenceGaps ||
+        actual.missingMessages != expected.missingMessages || actualLast != expectedLast) {
+        return "resumed: " + describeStats(actual, actualLast) + "; uninterrupted: " + describeStats(expected, expectedLast);
+    }
+    return std::nullopt;
+}
+
+/**
+ * Gap accounting: damaged frames are not gaps, dropped frames are, with exact ranges
+ */
+std::optional<std::string> checkSequenceGaps(const std::vector<std::uint8_t>& cleanFeed,
+                                             const std::vector<std::uint8_t>& corruptFeed) {
+    Decoder corrupt;
+    (void)corrupt.decodeFeed(corruptFeed);
+    if (corrupt.getStats().sequenceGaps != 0) {
+        return "corrupt but complete feed: " + describeStats(corrupt.getStats(), corrupt.captureSnapshot().lastSequence);
+    }
+
+    // Drop runs of 1, 5 and 10 frames from the clean feed
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+    constexpr std::pair<std::size_t, std::size_t> DROPS[] = {{1'000, 1}, {2'000, 5}, {3'000, 10}};
+    if (cleanFeed.size() < 4'000 * FRAME) {
+        return std::string{"feed too short for the gap check"};
+    }
+    std::vector<std::uint8_t> dropped;
+    std::vector<Decoder::SequenceGap> expectedGaps;
+    std::size_t kept = 0;
+    for (const auto& [first, count] : DROPS) {
+        dropped.insert(dropped.end(), cleanFeed.begin() + static_cast<std::ptrdiff_t>(kept * FRAME),
+                       cleanFeed.begin() + static_cast<std::ptrdiff_t>(first * FRAME));
+        expectedGaps.push_back({wire::TradeFrame::Sequence::load(cleanFeed.data() + first * FRAME),
+                                wire::TradeFrame::Sequence::load(cleanFeed.data() + (first + count - 1) * FRAME)});
+        kept = first + count;
+    }
+    dropped.insert(dropped.end(), cleanFeed.begin() + static_cast<std::ptrdiff_t>(kept * FRAME), cleanFeed.end());
+
+    Decoder decoder;
+    (void)decoder.decodeFeed(dropped);
+    const auto& gaps = decoder.getGaps();
+    const bool rangesMatch = gaps.size() == expectedGaps.size() &&
+        std::equal(gaps.begin(), gaps.end(), expectedGaps.begin(), [](const auto& a, const auto& b) {
+            return a.firstMissing == b.firstMissing && a.lastMissing == b.lastMissing;
+        });
+    if (!rangesMatch || decoder.getStats().missingMessages != 16) {
+        return "16 frames dropped in 3 runs: " + describeStats(decoder.getStats(), decoder.captureSnapshot().lastSequence);
+    }
+    return std::nullopt;
+}
+
+/**
+ * Index seeks must land where a linear scan for the first intact frame at or past the target does
+ */
+std::optional<std::string> checkIndexSeek(const std::vector<std::uint8_t>& feed) {
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+    const std::size_t frames = feed.size() / FRAME;
+    if (frames < 2) {
+        return std::string{"feed too short for the seek check"};
+    }
+    const auto index = CaptureIndex::build(feed.data(), feed.size());
+
+    const auto firstTrusted = [&](auto&& reachesTarget) -> std::optional<std::uint64_t> {
+        for (std::size_t offset = 0; offset + FRAME <= feed.size(); offset += FRAME) {
+            if (reachesTarget(feed.data() + offset) && Decoder::frameTrusted(feed.data() + offset)) {
+                return offset;
+            }
+        }
+        return std::nullopt;
+    };
+    const auto describe = [](const std::optional<std::uint64_t>& offset) {
+        return offset ? "offset " + std::to_string(*offset) : std::string{"nothing"};
+    };
+
+    // Targets taken from frames spread over the feed, damaged ones included, plus one past the end
+    for (std::size_t i = 0; i <= 16; ++i) {
+        const std::uint8_t* frame = feed.data() + (frames - 1) * i / 16 * FRAME;
+        const std::uint32_t sequence = wire::TradeFrame::Sequence::load(frame) + (i == 16 ? 1 : 0);
+        const std::uint64_t timestamp = wire::TradeFrame::Timestamp::load(frame) + (i == 16 ? 1 : 0);
+
+        Decoder decoder;
+        const auto bySequence = decoder.seekToSequence(index, feed.data(), feed.size(), sequence);
+        const auto expectedSequence = firstTrusted([&](const std::uint8_t* f) {
+            return wire::TradeFrame::Sequence::load(f) >= sequence;
+        });
+        if (bySequence != expectedSequence) {
+            return "seek to seq " + std::to_string(sequence) + " found " + describe(bySequence) + ", scan found " +
+                describe(expectedSequence);
+        }
+        const auto byTimestamp = decoder.seekToTimestamp(index, feed.data(), feed.size(), timestamp);
+        const auto expectedTimestamp = firstTrusted([&](const std::uint8_t* f) {
+            return wire::TradeFrame::Timestamp::load(f) >= timestamp;
+        });
+        if (byTimestamp != expectedTimestamp) {
+            return "seek to ts " + std::to_string(timestamp) + " found " + describe(byTimestamp) + ", scan found " +
+                describe(expectedTimestamp);
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Demultiplexed streams keep their own sequence spaces: every trade delivered once, in order, gaps only where dropped
+ */
+std::optional<std::string> checkStreamDemux(std::uint64_t seed) {
+    constexpr std::uint16_t STREAMS = 4;
+    constexpr std::uint16_t DROP_STREAM = 2;
+    constexpr std::size_t DROP_COUNT = 3;
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = 200'000;
+    simConfig.seed = seed;
+    simConfig.streamCount = STREAMS;
+    const auto feed = FeedSimulator{simConfig}.generateFeed();
+
+    // Drop a run of one stream's frames from the middle of the segment
+    std::vector<std::uint8_t> segment;
+    segment.reserve(feed.size());
+    std::size_t dropped = 0;
+    Decoder::SequenceGap expectedGap{};
+    for (std::size_t offset = 0; offset + FRAME <= feed.size(); offset += FRAME) {
+        const std::uint8_t* frame = feed.data() + offset;
+        if (offset >= feed.size() / 2 && dropped < DROP_COUNT && wire::TradeFrame::StreamId::load(frame) == DROP_STREAM) {
+            const auto sequence = wire::TradeFrame::Sequence::load(frame);
+            expectedGap = {dropped == 0 ? sequence : expectedGap.firstMissing, sequence};
+            ++dropped;
+            continue;
+        }
+        segment.insert(segment.end(), frame, frame + FRAME);
+    }
+
+    // Handlers of one stream run on one thread, so per-stream slots need no locking
+    std::vector<std::uint64_t> delivered(STREAMS, 0);
+    std::vector<std::uint32_t> lastSequence(STREAMS, 0);
+    std::vector<std::uint64_t> outOfOrder(STREAMS, 0);
+    StreamDemux::Config demuxConfig{};
+    demuxConfig.streamCount = STREAMS;
+    demuxConfig.threadCount = 2;
+    StreamDemux demux{demuxConfig, [&](std::uint16_t stream, const TradeMessage& message) {
+        ++delivered[stream];
+        outOfOrder[stream] += message.sequenceNumber <= lastSequence[stream] ? 1 : 0;
+        lastSequence[stream] = message.sequenceNumber;
+    }};
+
+    // Odd chunk size so frames straddle onSegmentData() calls
+    constexpr std::size_t CHUNK = 4'093;
+    for (std::size_t offset = 0; offset < segment.size(); offset += CHUNK) {
+        demux.onSegmentData(segment.data() + offset, std::min(CHUNK, segment.size() - offset));
+    }
+    demux.flush();
+
+    if (demux.getDemuxStats().unroutedFrames != 0) {
+        return std::to_string(demux.getDemuxStats().unroutedFrames) + " frames unrouted";
+    }
+    std::uint64_t total = 0;
+    for (std::uint16_t stream = 0; stream < STREAMS; ++stream) {
+        const auto& stats = demux.getStats(stream);
+        const auto& gaps = demux.getGaps(stream);
+        total += delivered[stream];
+        const bool gapsMatch = stream == DROP_STREAM
+            ? gaps.size() == 1 && gaps[0].firstMissing == expectedGap.firstMissing &&
+                  gaps[0].lastMissing == expectedGap.lastMissing && stats.missingMessages == DROP_COUNT
+            : gaps.empty();
+        if (!gapsMatch || outOfOrder[stream] != 0 || delivered[stream] != stats.validMessages) {
+            return "stream " + std::to_string(stream) + ": " + std::to_string(delivered[stream]) + " delivered, " +
+                std::to_string(outOfOrder[stream]) + " out of order, " + describeStats(stats, lastSequence[stream]);
+        }
+    }
+    if (total != segment.size() / FRAME || dropped != DROP_COUNT) {
+        return std::to_string(total) + " trades delivered of " + std::to_string(segment.size() / FRAME);
+    }
+    return std::nullopt;
+}
+
+/**
+ * KLL quantiles stay within the rank error bound, for one sketch and for a merge of four
+ */
+std::optional<std::string> checkKllErrorBound(std::uint64_t seed) {
+    constexpr std::size_t VALUES = 1'000'000;
+    constexpr std::size_t PARTS = 4;
+    const double bound = 2.0 / KllSketch::DEFAULT_K;
+
+    // Skewed prices in random order, then an ascending run, the order level-0 batching sees worst
+    std::mt19937_64 rng{seed};
+    std::lognormal_distribution<double> price{10.0, 1.0};
+    std::vector<std::uint32_t> values(VALUES);
+    std::generate(values.begin(), values.begin() + VALUES * 3 / 4, [&] {
+        return static_cast<std::uint32_t>(std::min(price(rng), 4e9));
+    });
+    std::iota(values.begin() + VALUES * 3 / 4, values.end(), 0U);
+
+    KllSketch single;
+    std::vector<KllSketch> parts(PARTS);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        single.update(values[i]);
+        parts[i * PARTS / values.size()].update(values[i]);
+    }
+    KllSketch merged;
+    for (const auto& part : parts) {
+        merged.merge(part);
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto n = static_cast<double>(values.size());
+    for (const auto* sketch : {&single, &merged}) {
+        const char* name = sketch == &single ? "single sketch" : "merged sketch";
+        if (sketch->count() != values.size() || sketch->minValue() != values.front() ||
+            sketch->maxValue() != values.back()) {
+            return std::string{name} + ": count, min or max not exact";
+        }
+        // Error is how far q lies outside the exact rank range of the returned value
+        for (int percent = 1; percent <= 99; ++percent) {
+            const double q = percent / 100.0;
+            const auto value = sketch->quantile(q);
+            const auto low = static_cast<double>(std::lower_bound(values.begin(), values.end(), value) - values.begin()) / n;
+            const auto high = static_cast<double>(std::upper_bound(values.begin(), values.end(), value) - values.begin()) / n;
+            const double error = std::max(low - q, q - high);
+            if (error > bound) {
+                std::ostringstream oss;
+                oss << name << ": p" << percent << " rank error " << 100.0 * error << "% over " << 100.0 * bound << "%";
+                return oss.str();
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Run every check and print one line each; false if any failed
+ */
+bool runSelfChecks(const std::vector<SelfCheck>& checks) {
+    bool passed = true;
+    std::cout << "Self-checks:\n";
+    for (const auto& check : checks) {
+        const auto failure = check.run();
+        passed = passed && !failure;
+        std::cout << (failure ? RED : GREEN) << "  " << (failure ? "❌ " : "✅ ") << check.name
+                  << (failure ? ": " + *failure : std::string{}) << RESET << "\n";
+    }
+    std::cout << "\n";
+    return passed;
+}
+
+std::string jsonNumber(const std::optional<double>& value) {
+    if (!value) {
+        return "null";
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << *value;
+    return oss.str();
+}
+
+struct BaselineEntry {
+    std::string name;
+    double bestMessagesPerSecond{0.0};
+    double spreadPercent{0.0};
+};
+
+/**
+ * Read per-scenario best rate and spread from a results file written by this harness
+ *
+ * Version 1 files only have the median rate, which stands in for the best with no spread.
+ */
+std::vector<BaselineEntry> loadBaseline(const std::string& path) {
+    std::ifstream file{path};
+    const std::string text{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    std::vector<BaselineEntry> baseline;
+    const std::string nameKey = "\"name\": \"";
+    for (std::size_t pos = text.find(nameKey); pos != std::string::npos; pos = text.find(nameKey, pos)) {
+        pos += nameKey.size();
+        const auto nameEnd = text.find('"', pos);
+        if (nameEnd == std::string::npos) {
+            break;
+        }
+        // One scenario per line: never pick up a key from the next one
+        const auto lineEnd = std::min(text.find('\n', nameEnd), text.size());
+        const auto number = [&](const std::string& key) -> std::optional<double> {
+            const auto keyPos = text.find("\"" + key + "\": ", nameEnd);
+            if (keyPos >= lineEnd) {
+                return std::nullopt;
+            }
+            try {
+                return std::stod(text.substr(keyPos + key.size() + 4));
+            } catch (const std::exception&) {
+                return std::nullopt;
+            }
+        };
+        const auto best = number("best_msgs_per_sec");
+        const auto median = number("msgs_per_sec");
+        if (!best && !median) {
+            break;
+        }
+        baseline.push_back({text.substr(pos, nameEnd - pos), best.value_or(median.value_or(0.0)),
+                            number("spread_pct").value_or(0.0)});
+    }
+    return baseline;
+}
+
+} // namespace
+
+int runPerfHarness(const PerfHarnessOptions& options) {
+    const int cpu = pinToCpu(options.cpu);
+    const std::size_t runs = std::max<std::size_t>(options.runs, 1);
+
+    std::cout << BOLD << CYAN << "\n⏱️  Performance harness" << RESET << " (seed " << options.seed << ", "
+              << options.messageCount << " messages, " << runs << " runs, CPU "
+              << (cpu >= 0 ? std::to_string(cpu) : std::string{"unpinned"}) << ")\n"
+              << CYAN << "═══════════════════════════════════════════════════════════" << RESET << "\n";
+
+    // Inputs are generated once, outside every timed region
+    FeedSimulator::Config simConfig{};
+    simConfig.messageCount = options.messageCount;
+    simConfig.seed = options.seed;
+    const auto cleanFeed = FeedSimulator{simConfig}.generateFeed();
+
+    simConfig.malformedCount = options.messageCount / 20;
+    const auto corruptFeed = FeedSimulator{simConfig}.generateTestFeed();
+
+    const std::vector<SelfCheck> checks{
+        {"checkpoint_roundtrip", [&] { return checkCheckpointRoundTrip(corruptFeed); }},
+        {"sequence_gaps", [&] { return checkSequenceGaps(cleanFeed, corruptFeed); }},
+        {"index_seek", [&] { return checkIndexSeek(corruptFeed); }},
+        {"stream_demux", [&] { return checkStreamDemux(options.seed); }},
+        {"kll_error_bound", [&] { return checkKllErrorBound(options.seed); }},
+    };
+    if (!runSelfChecks(checks)) {
+        std::cerr << RED << "❌ Self-check failed; not measuring" << RESET << "\n";
+        return 1;
+    }
+
+    const auto csvPath = (std::filesystem::temp_directory_path() / "mtbt_perf.csv").string();
+    const auto ignore = [](const Decoder::MessageBuffer&) {};
+
+    const std::vector<Scenario> scenarios{
+        {"clean", [&](RunContext& context) { context.decode(cleanFeed, ignore); }},
+        {"corrupt_5pct", [&](RunContext& context) { context.decode(corruptFeed, ignore); }},
+        {"checksum", [&](RunContext& context) {
+            context.decoder.setValidationLevel(ValidationLevel::CHECKSUM);
+            context.decode(cleanFeed, ignore);
+        }},
+        {"csv_export", [&](RunContext& context) {
+            std::ofstream csv{csvPath, std::ios::trunc};
+            csv << "Sequence,Symbol,Timestamp,Price(INR),Quantity,Side,Time,Status\n";
+            context.decode(cleanFeed, [&csv](const Decoder::MessageBuffer& batch) {
+                for (const auto& message : batch) {
+                    if (auto line = utils::MessageFormatter::formatMessageAsCsv(message); line) {
+                        csv << *line << "\n";
+                    }
+                }
+            });
+        }},
+        {"streaming_large", [&](RunContext& context) {
+            // 20 passes through one recycled batch buffer: steady state, no output growth
+            for (int pass = 0; pass < 20; ++pass) {
+                context.decode(cleanFeed, ignore);
+            }
+        }},
+    };
+
+    std::vector<const Scenario*> all;
+    for (const auto& scenario : scenarios) {
+        all.push_back(&scenario);
+    }
+    const auto results = measure(all, runs);
+
+    std::cout << std::left << std::setw(18) << "Scenario" << std::setw(14) << "Msgs/s" << std::setw(9) << "Spread" << std::setw(10) << "ns/msg"
+              << std::setw(14) << "p99 batch ns" << std::setw(12) << "Peak RSS" << "IPC\n";
+    for (const auto& result : results) {
+        std::cout << std::fixed << std::setprecision(1) << std::setw(18) << result.name
+                  << std::setw(14) << std::setprecision(0) << result.messagesPerSecond
+                  << std::setw(9) << std::setprecision(1) << (std::to_string(static_cast<int>(result.spreadPercent + 0.5)) + "%")
+                  << std::setw(10) << std::setprecision(1) << result.nsPerMessage
+                  << std::setw(14) << result.p99BatchNs
+                  << std::setw(12) << (std::to_string(result.peakRssKb / 1024) + " MB")
+                  << jsonNumber(result.ipc) << "\n";
+    }
+    std::filesystem::remove(csvPath);
+
+    // JSON, one scenario per line
+    {
+        std::ofstream json{options.outputPath, std::ios::trunc};
+        if (!json.is_open()) {
+            std::cerr << RED << "❌ Failed to write " << options.outputPath << RESET << "\n";
+            return 1;
+        }
+        json << "{\n  \"version\": 2,\n  \"seed\": " << options.seed << ",\n  \"messages\": " << options.messageCount
+             << ",\n  \"runs\": " << runs << ",\n  \"cpu\": " << cpu << ",\n  \"scenarios\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& result = results[i];
+            json << std::fixed << std::setprecision(1)
+                 << "    {\"name\": \"" << result.name << "\", \"messages\": " << result.messages
+                 << ", \"msgs_per_sec\": " << result.messagesPerSecond
+                 << ", \"best_msgs_per_sec\": " << result.bestMessagesPerSecond << ", \"spread_pct\": " << result.spreadPercent
+                 << ", \"ns_per_msg\": " << std::setprecision(2)
+                 << result.nsPerMessage << ", \"p99_batch_ns\": " << result.p99BatchNs
+                 << ", \"batch_messages\": " << BATCH_FRAMES << ", \"peak_rss_kb\": " << result.peakRssKb
+                 << ", \"ipc\": " << jsonNumber(result.ipc)
+                 << ", \"cache_misses_per_msg\": " << jsonNumber(result.cacheMissesPerMessage) << "}"
+                 << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        json << "  ]\n}\n";
+    }
+    std::cout << GREEN << "💾 Results written to " << options.outputPath << RESET << "\n";
+
+    if (!options.baselinePath) {
+        return 0;
+    }
+    const auto baseline = loadBaseline(*options.baselinePath);
+    if (baseline.empty()) {
+        std::cerr << RED << "❌ No usable baseline in " << *options.baselinePath << RESET << "\n";
+        return 1;
+    }
+
+    // Best-of-N against best-of-N. Only the committed baseline's spread widens the allowance, and
+    // only up to a fixed bound, so a noisy run cannot loosen its own gate. Scenarios over the line
+    // are measured again after the first pass and judged on that fresh measurement alone.
+    struct Verdict {
+        const BaselineEntry* baseline{nullptr};
+        double allowed{0.0};
+        double change{0.0};
+        bool rechecked{false};
+    };
+    std::vector<Verdict> verdicts(results.size());
+    std::vector<const Scenario*> suspects;
+    std::vector<std::size_t> suspectIndices;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const auto it = std::find_if(baseline.begin(), baseline.end(),
+                                     [&](const auto& entry) { return entry.name == result.name; });
+        if (it == baseline.end() || it->bestMessagesPerSecond <= 0) {
+            continue;
+        }
+        auto& verdict = verdicts[i];
+        verdict.baseline = &*it;
+        verdict.allowed = options.thresholdPercent + std::min(it->spreadPercent, MAX_SPREAD_ALLOWANCE_PERCENT);
+        verdict.change = (result.bestMessagesPerSecond / it->bestMessagesPerSecond - 1.0) * 100.0;
+        if (verdict.change < -verdict.allowed) {
+            suspects.push_back(&scenarios[i]);
+            suspectIndices.push_back(i);
+        }
+    }
+    if (!suspects.empty()) {
+        std::cout << "\nRe-measuring " << suspects.size() << " scenario(s) below the baseline...\n";
+        const auto rechecks = measure(suspects, runs);
+        for (std::size_t j = 0; j < rechecks.size(); ++j) {
+            auto& verdict = verdicts[suspectIndices[j]];
+            verdict.change = (rechecks[j].bestMessagesPerSecond / verdict.baseline->bestMessagesPerSecond - 1.0) * 100.0;
+            verdict.rechecked = true;
+        }
+    }
+
+    bool regressed = false;
+    std::cout << "\nAgainst " << *options.baselinePath << " (best of " << runs << ", threshold -"
+              << options.thresholdPercent << "% plus up to " << MAX_SPREAD_ALLOWANCE_PERCENT << "% of baseline spread):\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& verdict = verdicts[i];
+        if (!verdict.baseline) {
+            std::cout << YELLOW << "  " << std::setw(18) << results[i].name << "no baseline" << RESET << "\n";
+            continue;
+        }
+        const bool failed = verdict.change < -verdict.allowed;
+        regressed = regressed || failed;
+        std::cout << (failed ? RED : GREEN) << "  " << std::setw(18) << results[i].name << std::showpos
+                  << std::setprecision(1) << verdict.change << "%" << std::noshowpos << " (allowed -" << verdict.allowed << "%)"
+                  << (failed ? "  REGRESSION, confirmed on recheck" : verdict.rechecked ? "  passed on recheck" : "")
+                  << RESET << "\n";
+    }
+    return regressed ? 2 : 0;
+}
+
+} // namespace nse::mtbt::bench
\ No newline at end of file
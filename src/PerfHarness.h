@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace nse::mtbt::bench {
+
+/**
+ * Options for the fixed-seed performance regression harness
+ */
+struct PerfHarnessOptions {
+    std::string outputPath{"perf_results.json"};
+    std::optional<std::string> baselinePath{std::nullopt};  // Previous results to compare against
+    double thresholdPercent{10.0};   // Allowed best-run msg/s drop, plus a bounded part of the baseline's spread
+    std::size_t runs{5};             // Runs per scenario; median, best and spread are reported
+    std::size_t messageCount{1'000'000};
+    std::uint32_t seed{42};
+    int cpu{-1};                     // CPU to pin to; -1 picks the first allowed CPU
+};
+
+/**
+ * Run the self-checks and every scenario, write JSON results and compare with the baseline
+ *
+ * Fixed-seed self-checks (checkpoint round-trip, sequence-gap accounting, ...)
+ * run first; if one fails nothing is timed. Scenarios are compared on their
+ * fastest run. The allowed drop is the threshold plus the baseline's
+ * recorded run-to-run spread, capped at a few percent; the current run's
+ * spread never widens it. A scenario below that line is measured again and
+ * judged on the fresh measurement alone. Returns the process exit code: 0 on
+ * success, 1 if the harness or a self-check failed, 2 if any scenario regressed.
+ */
+[[nodiscard]] int runPerfHarness(const PerfHarnessOptions& options);
+
+} // namespace nse::mtbt::bench
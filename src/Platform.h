@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MTBT_HAVE_AVX2_DISPATCH 1
+#endif
+
+namespace nse::mtbt {
+
+/**
+ * Steady clock reading in nanoseconds, for intervals and cross-thread stamps
+ */
+[[nodiscard]] inline std::uint64_t steadyNowNs() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+/**
+ * Whether the running CPU supports AVX2, probed once per process
+ *
+ * Kernels built with __attribute__((target("avx2"))) are only called when
+ * this is true, so the rest of the binary stays baseline x86-64.
+ */
+[[nodiscard]] inline bool cpuHasAvx2() noexcept {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+#endif
+
+} // namespace nse::mtbt
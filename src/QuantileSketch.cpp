@@ -0,0 +1,325 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace nse::mtbt {
+
+namespace {
+
+// Levels never shrink below this, so tiny upper levels still compact in pairs
+constexpr std::size_t MIN_LEVEL_WIDTH = 8;
+constexpr double CAPACITY_DECAY = 2.0 / 3.0;
+constexpr std::size_t MAX_DEPTH = 64;  // 2^64 inputs; depth beyond this never occurs
+
+// (2/3)^depth, so compaction never calls pow on the update path
+const std::array<double, MAX_DEPTH> DECAY_POWERS = [] {
+    std::array<double, MAX_DEPTH> powers{};
+    double power = 1.0;
+    for (auto& entry : powers) {
+        entry = power;
+        power *= CAPACITY_DECAY;
+    }
+    return powers;
+}();
+
+// Batcher odd-even merge sort network for 16 inputs (63 compare-exchanges)
+static_assert(KllSketch::LEVEL0_BATCH == 16, "BATCH_NETWORK is built for 16 inputs");
+struct CompareExchange {
+    std::uint8_t low;
+    std::uint8_t high;
+};
+constexpr CompareExchange BATCH_NETWORK[] = {
+    {0, 1}, {2, 3}, {0, 2}, {1, 3}, {1, 2}, {4, 5}, {6, 7}, {4, 6}, {5, 7}, {5, 6}, {0, 4}, {2, 6}, {2, 4},
+    {1, 5}, {3, 7}, {3, 5}, {1, 2}, {3, 4}, {5, 6}, {8, 9}, {10, 11}, {8, 10}, {9, 11}, {9, 10}, {12, 13},
+    {14, 15}, {12, 14}, {13, 15}, {13, 14}, {8, 12}, {10, 14}, {10, 12}, {9, 13}, {11, 15}, {11, 13}, {9, 10},
+    {11, 12}, {13, 14}, {0, 8}, {4, 12}, {4, 8}, {2, 10}, {6, 14}, {6, 10}, {2, 4}, {6, 8}, {10, 12}, {1, 9},
+    {5, 13}, {5, 9}, {3, 11}, {7, 15}, {7, 11}, {3, 5}, {7, 9}, {11, 13}, {1, 2}, {3, 4}, {5, 6}, {7, 8},
+    {9, 10}, {11, 12}, {13, 14}};
+
+void compareExchange(std::uint32_t& low, std::uint32_t& high) noexcept {
+    const std::uint32_t a = low;
+    const std::uint32_t b = high;
+    low = a < b ? a : b;
+    high = a < b ? b : a;
+}
+
+template<std::size_t... Step>
+void runBatchNetwork(std::uint32_t* batch, std::index_sequence<Step...>) noexcept {
+    (compareExchange(batch[BATCH_NETWORK[Step].low], batch[BATCH_NETWORK[Step].high]), ...);
+}
+
+/**
+ * Sort one level-0 batch without data-dependent branches
+ *
+ * Prices and sizes arrive in random order, so std::sort's comparisons on
+ * a handful of items mispredict about half the time. The network is
+ * unrolled at compile time into conditional moves on a local copy, about
+ * 4x cheaper per item.
+ */
+void sortBatch(std::uint32_t* values) noexcept {
+    std::uint32_t batch[KllSketch::LEVEL0_BATCH];
+    std::copy(values, values + KllSketch::LEVEL0_BATCH, batch);
+    runBatchNetwork(batch, std::make_index_sequence<std::size(BATCH_NETWORK)>{});
+    std::copy(batch, batch + KllSketch::LEVEL0_BATCH, values);
+}
+
+// Promoted items waiting to be merged into the level above (reused, so compaction does not allocate)
+thread_local std::vector<std::uint32_t> promoteScratch;
+
+} // namespace
+
+KllSketch::KllSketch(std::uint16_t k) : k_{std::max<std::uint16_t>(k, MIN_LEVEL_WIDTH)} {
+    items_.resize(totalCapacity(1));
+    levels_ = {static_cast<std::uint32_t>(items_.size()), static_cast<std::uint32_t>(items_.size())};
+    updateBatching();
+}
+
+std::size_t KllSketch::levelCapacity(std::size_t level, std::size_t height) const noexcept {
+    // The top level gets k; each level below it 2/3 of the one above
+    const auto depth = std::min(height - 1 - level, MAX_DEPTH - 1);
+    const auto width = static_cast<std::size_t>(std::ceil(k_ * DECAY_POWERS[depth]));
+    return std::max(width, MIN_LEVEL_WIDTH);
+}
+
+std::size_t KllSketch::totalCapacity(std::size_t height) const noexcept {
+    std::size_t capacity = 0;
+    for (std::size_t level = 0; level < height; ++level) {
+        capacity += levelCapacity(level, height);
+    }
+    return capacity;
+}
+
+bool KllSketch::flipCoin() noexcept {
+    coinState_ ^= coinState_ << 13;
+    coinState_ ^= coinState_ >> 7;
+    coinState_ ^= coinState_ << 17;
+    return (coinState_ >> 63) != 0;
+}
+
+void KllSketch::addLevel() {
+    // The extra capacity becomes free space at the front of the buffer
+    const std::size_t capacity = totalCapacity(levelCount() + 1);
+    const std::size_t growth = capacity > items_.size() ? capacity - items_.size() : 0;
+    items_.insert(items_.begin(), growth, 0);
+    for (auto& boundary : levels_) {
+        boundary += static_cast<std::uint32_t>(growth);
+    }
+    levels_.push_back(static_cast<std::uint32_t>(items_.size()));
+    updateBatching();
+}
+
+void KllSketch::updateBatching() noexcept {
+    batchLevel0_ = levelCapacity(0, levelCount()) <= LEVEL0_BATCH;
+}
+
+void KllSketch::compactOnce() {
+    // The lowest level at capacity; the top one gets a new level above it first
+    std::size_t level = 0;
+    while (level + 1 < levelCount() && levelSize(level) < levelCapacity(level, levelCount())) {
+        ++level;
+    }
+    // A batched level 0 short of a full batch waits if a level below the top can make room instead
+    if (level == 0 && batchLevel0_ && levelSize(0) < LEVEL0_BATCH) {
+        for (std::size_t upper = 1; upper + 1 < levelCount(); ++upper) {
+            if (levelSize(upper) >= levelCapacity(upper, levelCount())) {
+                level = upper;
+                break;
+            }
+        }
+    }
+    if (level + 1 == levelCount()) {
+        addLevel();
+    }
+
+    const std::size_t begin = levels_[level];
+    const std::size_t end = levels_[level + 1];
+    const std::size_t aboveEnd = levels_[level + 2];
+    if (level == 0 && end - begin == LEVEL0_BATCH) {
+        sortBatch(items_.data() + begin);
+    } else if (level == 0) {
+        std::sort(items_.begin() + begin, items_.begin() + end);
+    }
+
+    // An odd item out stays behind at its own weight; every other remaining item moves up
+    const std::size_t odd = (end - begin) % 2;
+    const std::size_t pairs = (end - begin) / 2;
+    const std::size_t first = begin + odd + (flipCoin() ? 1 : 0);
+    promoteScratch.resize(pairs);
+    for (std::size_t i = 0; i < pairs; ++i) {
+        promoteScratch[i] = items_[first + 2 * i];
+    }
+    // Merging forward into [end - pairs, aboveEnd) never overtakes the unread part of the level above
+    std::size_t out = end - pairs;
+    std::size_t above = end;
+    for (const auto value : promoteScratch) {
+        while (above < aboveEnd && items_[above] < value) {
+            items_[out++] = items_[above++];
+        }
+        items_[out++] = value;
+    }
+
+    // Close the gap: the odd item and every lower level shift up, freeing `pairs` slots at the front
+    std::copy_backward(items_.begin() + levels_[0], items_.begin() + begin + odd, items_.begin() + (end - pairs));
+    for (std::size_t h = 0; h <= level; ++h) {
+        levels_[h] += static_cast<std::uint32_t>(pairs);
+    }
+    levels_[level + 1] = static_cast<std::uint32_t>(end - pairs);
+}
+
+void KllSketch::merge(const KllSketch& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0 || other.minValue_ < minValue_) {
+        minValue_ = other.minValue_;
+    }
+    if (count_ == 0 || other.maxValue_ > maxValue_) {
+        maxValue_ = other.maxValue_;
+    }
+    count_ += other.count_;
+
+    // Combine level by level (upper levels stay sorted), into a buffer big enough for both
+    const std::size_t height = std::max(levelCount(), other.levelCount());
+    std::vector<std::vector<std::uint32_t>> combined(height);
+    std::size_t retained = 0;
+    for (std::size_t level = 0; level < height; ++level) {
+        auto& items = combined[level];
+        for (const KllSketch* sketch : {static_cast<const KllSketch*>(this), &other}) {
+            if (level < sketch->levelCount()) {
+                const auto middle = items.size();
+                items.insert(items.end(), sketch->items_.begin() + sketch->levels_[level],
+                             sketch->items_.begin() + sketch->levels_[level + 1]);
+                if (level > 0) {
+                    std::inplace_merge(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(middle), items.end());
+                }
+            }
+        }
+        retained += items.size();
+    }
+
+    const std::size_t capacity = totalCapacity(height);
+    items_.assign(std::max(capacity, retained), 0);
+    levels_.assign(height + 1, static_cast<std::uint32_t>(items_.size()));
+    for (std::size_t level = height; level-- > 0;) {
+        levels_[level] = static_cast<std::uint32_t>(levels_[level + 1] - combined[level].size());
+        std::copy(combined[level].begin(), combined[level].end(), items_.begin() + levels_[level]);
+    }
+
+    // Compact back within capacity, then drop the surplus free slots
+    while (retainedItems() > totalCapacity(levelCount())) {
+        compactOnce();
+    }
+    const std::size_t surplus = items_.size() - totalCapacity(levelCount());
+    items_.erase(items_.begin(), items_.begin() + static_cast<std::ptrdiff_t>(surplus));
+    for (auto& boundary : levels_) {
+        boundary -= static_cast<std::uint32_t>(surplus);
+    }
+    updateBatching();
+}
+
+std::uint32_t KllSketch::quantile(double q) const {
+    if (count_ == 0 || q <= 0.0) {
+        return minValue_;
+    }
+    if (q >= 1.0) {
+        return maxValue_;
+    }
+
+    // Weighted sorted view: item at level h counts 2^h times
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> weighted;
+    weighted.reserve(retainedItems());
+    for (std::size_t level = 0; level < levelCount(); ++level) {
+        for (auto i = levels_[level]; i < levels_[level + 1]; ++i) {
+            weighted.emplace_back(items_[i], std::uint64_t{1} << level);
+        }
+    }
+    std::sort(weighted.begin(), weighted.end());
+
+    const auto target = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count_)));
+    std::uint64_t cumulative = 0;
+    for (const auto& [value, weight] : weighted) {
+        cumulative += weight;
+        if (cumulative >= target) {
+            return value;
+        }
+    }
+    return maxValue_;
+}
+
+double KllSketch::rank(std::uint32_t value) const noexcept {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    std::uint64_t below = 0;
+    for (std::size_t level = 0; level < levelCount(); ++level) {
+        for (auto i = levels_[level]; i < levels_[level + 1]; ++i) {
+            below += items_[i] <= value ? std::uint64_t{1} << level : 0;
+        }
+    }
+    return static_cast<double>(below) / static_cast<double>(count_);
+}
+
+void QuantileTable::merge(const QuantileTable& other) {
+    for (std::size_t otherId = 0; otherId < other.sketches_.size(); ++otherId) {
+        const auto id = symbols_.getOrAssign(other.tokenAt(otherId));
+        if (id >= sketches_.size()) {
+            sketches_.push_back(Sketches{KllSketch{k_}, KllSketch{k_}});
+            touched_.push_back(version_);
+        }
+        sketches_[id].price.merge(other.sketches_[otherId].price);
+        sketches_[id].quantity.merge(other.sketches_[otherId].quantity);
+        touched_[id] = version_;
+    }
+}
+
+void QuantileTable::syncFrom(const QuantileTable& source, std::uint64_t since) {
+    if (since == 0 || k_ != source.k_) {
+        *this = source;
+        return;
+    }
+    // Ids are dense and never reassigned, so a longer source only added symbols
+    if (symbols_.size() != source.symbols_.size()) {
+        symbols_ = source.symbols_;
+    }
+    sketches_.resize(source.sketches_.size(), Sketches{KllSketch{k_}, KllSketch{k_}});
+    for (std::size_t id = 0; id < sketches_.size(); ++id) {
+        if (source.touched_[id] > since) {
+            sketches_[id] = source.sketches_[id];
+        }
+    }
+    touched_ = source.touched_;
+    version_ = source.version_;
+}
+
+std::size_t QuantileTable::memoryBytes() const noexcept {
+    std::size_t bytes = sizeof(*this);
+    for (const auto& sketches : sketches_) {
+        bytes += sketches.price.memoryBytes() + sketches.quantity.memoryBytes();
+    }
+    return bytes;
+}
+
+QuantileTracker::QuantileTracker(Config config)
+    : config_{config}, table_{config.k}, published_{std::make_unique<QuantileTable>(config.k)},
+      spare_{std::make_unique<QuantileTable>(config.k)} {}
+
+void QuantileTracker::publish() {
+    sincePublish_ = 0;
+    const std::uint64_t version = table_.seal();
+    spare_->syncFrom(table_, spareVersion_);
+    spare_ = published_.exchange(std::move(spare_));
+    spareVersion_ = std::exchange(publishedVersion_, version);
+}
+
+QuantileTable QuantileTracker::rotate() {
+    publish();
+    // Neither buffer derives from the next window's table
+    spareVersion_ = 0;
+    publishedVersion_ = 0;
+    return std::exchange(table_, QuantileTable{config_.k});
+}
+
+} // namespace nse::mtbt
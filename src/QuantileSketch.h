@@ -0,0 +1,240 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "Rcu.h"
+#include "SymbolIndex.h"
+#include <cstdint>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * KLL streaming quantile sketch over 32-bit values (prices in paisa, quantities)
+ *
+ * Items live in levels of geometrically shrinking capacity packed into one
+ * buffer (free space first, then level 0, 1, ...); an item at level h
+ * stands for 2^h inputs. When the buffer is full, the lowest full level is
+ * compacted: every other item (random offset) is merged into the sorted
+ * level above. Memory stays O(k) however many values arrive, and the rank
+ * error is about 1.7/k with high probability. Two sketches merge by
+ * combining levels and compacting, so per-thread or per-window sketches
+ * combine without loss beyond that bound. Minimum and maximum are exact.
+ *
+ * Once the sketch is deep enough that level 0's capacity is at most
+ * LEVEL0_BATCH, level 0 is compacted in batches of exactly that many items
+ * (a full buffer compacts a higher level at capacity first), so its sort
+ * is a fixed branch-free network. Any level at capacity may be compacted,
+ * so the error bound is unchanged.
+ */
+class KllSketch {
+public:
+    static constexpr std::uint16_t DEFAULT_K = 200;
+    static constexpr std::size_t LEVEL0_BATCH = 16;   // Level-0 items sorted by the fixed network
+
+    explicit KllSketch(std::uint16_t k = DEFAULT_K);
+
+    /**
+     * Add one value (amortized O(1); compaction sorts one level)
+     */
+    void update(std::uint32_t value) {
+        if (count_ == 0 || value < minValue_) {
+            minValue_ = value;
+        }
+        if (count_ == 0 || value > maxValue_) {
+            maxValue_ = value;
+        }
+        ++count_;
+        if (levels_[0] == 0) {
+            compactOnce();
+        }
+        items_[--levels_[0]] = value;
+        if (batchLevel0_ && levels_[1] - levels_[0] == LEVEL0_BATCH) {
+            compactOnce();
+        }
+    }
+
+    /**
+     * Fold another sketch in (its k is ignored; this sketch's k bounds the result)
+     */
+    void merge(const KllSketch& other);
+
+    /**
+     * Approximate value at normalized rank q in [0, 1]; q <= 0 and q >= 1 are the exact min and max
+     */
+    [[nodiscard]] std::uint32_t quantile(double q) const;
+
+    /**
+     * Approximate fraction of inputs <= value
+     */
+    [[nodiscard]] double rank(std::uint32_t value) const noexcept;
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+    [[nodiscard]] std::uint32_t minValue() const noexcept { return minValue_; }
+    [[nodiscard]] std::uint32_t maxValue() const noexcept { return maxValue_; }
+    [[nodiscard]] std::uint16_t k() const noexcept { return k_; }
+
+    /**
+     * Items currently stored (bounded by roughly 3k)
+     */
+    [[nodiscard]] std::size_t retainedItems() const noexcept { return items_.size() - levels_[0]; }
+    [[nodiscard]] std::size_t memoryBytes() const noexcept {
+        return sizeof(*this) + items_.capacity() * sizeof(std::uint32_t) + levels_.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    std::vector<std::uint32_t> items_;   // Free slots, then level 0 (unsorted), then levels 1.. (sorted)
+    std::vector<std::uint32_t> levels_;  // Level h is [levels_[h], levels_[h + 1]); back() == items_.size()
+    std::uint64_t count_{0};
+    std::uint64_t coinState_{0x9E3779B97F4A7C15ULL};
+    std::uint32_t minValue_{0};
+    std::uint32_t maxValue_{0};
+    std::uint16_t k_;
+    bool batchLevel0_{false};   // Level 0's capacity is at most LEVEL0_BATCH
+
+    [[nodiscard]] std::size_t levelCount() const noexcept { return levels_.size() - 1; }
+    [[nodiscard]] std::size_t levelSize(std::size_t level) const noexcept { return levels_[level + 1] - levels_[level]; }
+    [[nodiscard]] std::size_t levelCapacity(std::size_t level, std::size_t height) const noexcept;
+    [[nodiscard]] std::size_t totalCapacity(std::size_t height) const noexcept;
+    void compactOnce();
+    void addLevel();
+    void updateBatching() noexcept;
+    bool flipCoin() noexcept;
+};
+
+/**
+ * Price and quantity sketches for every symbol seen, in a flat array by dense symbol id
+ */
+class QuantileTable {
+public:
+    struct Sketches {
+        KllSketch price;
+        KllSketch quantity;
+    };
+
+    explicit QuantileTable(std::uint16_t k = KllSketch::DEFAULT_K) : k_{k} {}
+
+    void add(const TradeMessage& message) {
+        const auto id = symbols_.getOrAssign(message.symbolToken);
+        if (id == SymbolIndex::INVALID_ID) {
+            return;
+        }
+        if (id >= sketches_.size()) {
+            sketches_.push_back(Sketches{KllSketch{k_}, KllSketch{k_}});
+            touched_.push_back(version_);
+        }
+        sketches_[id].price.update(message.priceInPaisa);
+        sketches_[id].quantity.update(message.quantity);
+        touched_[id] = version_;
+    }
+
+    /**
+     * Fold in another table, e.g. another worker's or an earlier window's
+     */
+    void merge(const QuantileTable& other);
+
+    /**
+     * Close the current version and return it; later changes are stamped with the next one
+     */
+    std::uint64_t seal() noexcept { return version_++; }
+
+    /**
+     * Become a copy of source, given that this table already matched it at version `since`
+     *
+     * Only symbols changed after `since` are copied (0 copies everything),
+     * and their sketches reuse the storage already allocated here.
+     */
+    void syncFrom(const QuantileTable& source, std::uint64_t since);
+
+    /**
+     * Sketches of one token, nullptr if it never traded
+     */
+    [[nodiscard]] const Sketches* find(std::uint32_t token) const noexcept {
+        const auto id = symbols_.find(token);
+        return id == SymbolIndex::INVALID_ID ? nullptr : &sketches_[id];
+    }
+
+    [[nodiscard]] std::size_t symbolCount() const noexcept { return sketches_.size(); }
+    [[nodiscard]] std::uint32_t tokenAt(std::size_t id) const noexcept { return symbols_.tokenOf(static_cast<std::uint32_t>(id)); }
+    [[nodiscard]] const Sketches& sketchesAt(std::size_t id) const noexcept { return sketches_[id]; }
+    [[nodiscard]] std::size_t memoryBytes() const noexcept;
+
+private:
+    SymbolIndex symbols_;
+    std::vector<Sketches> sketches_;
+    std::vector<std::uint64_t> touched_;   // Per symbol: version_ at its last change
+    std::uint64_t version_{1};
+    std::uint16_t k_;
+};
+
+/**
+ * Live per-symbol quantiles: updated by one ingest thread, readable from any thread
+ *
+ * The ingest thread owns a working table and publishes it RCU-style every
+ * publishInterval trades; readers pin the latest copy and query it while
+ * ingest continues. Publishing double-buffers: the copy retired by the
+ * previous publish is brought up to date with only the symbols traded
+ * since it was current, then swapped in, so its cost follows the active
+ * symbols rather than the whole table. Windows are cut with rotate() and
+ * combined with QuantileTable::merge().
+ */
+class QuantileTracker {
+public:
+    struct Config {
+        std::uint16_t k{KllSketch::DEFAULT_K};
+        std::uint64_t publishInterval{1 << 16};  // Trades between snapshots (0 = only explicit publish())
+
+        Config() = default;
+    };
+
+    QuantileTracker() : QuantileTracker(Config{}) {}
+    explicit QuantileTracker(Config config);
+
+    QuantileTracker(const QuantileTracker&) = delete;
+    QuantileTracker& operator=(const QuantileTracker&) = delete;
+
+    void onTrade(const TradeMessage& message) {
+        table_.add(message);
+        if (++sincePublish_ == config_.publishInterval) {
+            publish();
+        }
+    }
+
+    template<typename Container>
+    void onTrades(const Container& messages) {
+        for (const auto& message : messages) {
+            onTrade(message);
+        }
+    }
+
+    /**
+     * Make everything ingested so far visible to snapshot() readers
+     */
+    void publish();
+
+    /**
+     * Pin the latest published table (any thread; keep the guard short, publish() waits for it)
+     */
+    [[nodiscard]] RcuPointer<QuantileTable>::ReadGuard snapshot() const noexcept { return published_.read(); }
+
+    /**
+     * End the current window: publish it, hand it back and start an empty one
+     */
+    [[nodiscard]] QuantileTable rotate();
+
+    /**
+     * The working table (ingest thread only)
+     */
+    [[nodiscard]] const QuantileTable& table() const noexcept { return table_; }
+
+private:
+    Config config_;
+    QuantileTable table_;
+    RcuPointer<QuantileTable> published_;
+    std::unique_ptr<QuantileTable> spare_;     // Retired copy, refreshed and swapped in by publish()
+    std::uint64_t spareVersion_{0};            // Working-table version spare_ last matched (0 = none)
+    std::uint64_t publishedVersion_{0};
+    std::uint64_t sincePublish_{0};
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace nse::mtbt {
+
+/**
+ * RCU-style published pointer: wait-free reads, copy-and-swap updates
+ *
+ * Readers pin the current object with two counter increments and never
+ * block. Writers publish a replacement, flip the reader epoch and wait for
+ * the previous epoch's readers to leave before freeing the old object.
+ */
+template<typename T>
+class RcuPointer {
+public:
+    /**
+     * Keeps the object it was created from alive until destroyed
+     */
+    class ReadGuard {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard(ReadGuard&& other) noexcept : counter_{other.counter_}, value_{other.value_} {
+            other.counter_ = nullptr;
+        }
+        ReadGuard& operator=(ReadGuard&&) = delete;
+        ~ReadGuard() {
+            if (counter_) {
+                counter_->fetch_sub(1, std::memory_order_release);
+            }
+        }
+        
+        [[nodiscard]] const T* get() const noexcept { return value_; }
+        [[nodiscard]] const T& operator*() const noexcept { return *value_; }
+        [[nodiscard]] const T* operator->() const noexcept { return value_; }
+        
+    private:
+        friend class RcuPointer;
+        ReadGuard(std::atomic<std::uint32_t>* counter, const T* value) noexcept : counter_{counter}, value_{value} {}
+        
+        std::atomic<std::uint32_t>* counter_;
+        const T* value_;
+    };
+
+    explicit RcuPointer(std::unique_ptr<T> initial) : current_{initial.release()} {}
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    ~RcuPointer() { delete current_.load(std::memory_order_acquire); }
+
+    /**
+     * Pin the current object (never blocks)
+     */
+    [[nodiscard]] ReadGuard read() const noexcept {
+        for (;;) {
+            const std::uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+            auto& counter = readers_[epoch & 1];
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            // Re-check so a writer flipping past us is guaranteed to wait on our counter
+            if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+                return ReadGuard{&counter, current_.load(std::memory_order_seq_cst)};
+            }
+            counter.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Publish a replacement; blocks the caller (never readers) until the old object is unreachable
+     */
+    void update(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock{writerMutex_};
+        publishLocked(std::move(next));
+    }
+
+    /**
+     * Publish a replacement and hand back the old object once no reader can reach it
+     *
+     * Lets a writer double-buffer: refresh the returned object and exchange it back in later.
+     */
+    [[nodiscard]] std::unique_ptr<T> exchange(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock{writerMutex_};
+        return std::unique_ptr<T>{retireLocked(std::move(next))};
+    }
+
+    /**
+     * Copy the current object, let the caller modify it, then publish the copy
+     */
+    template<typename Mutate>
+    void modify(Mutate&& mutate) {
+        std::lock_guard<std::mutex> lock{writerMutex_};
+        // Only writers free objects, so the current one is stable under the writer lock
+        auto copy = std::make_unique<T>(*current_.load(std::memory_order_acquire));
+        mutate(*copy);
+        publishLocked(std::move(copy));
+    }
+
+private:
+    std::atomic<T*> current_;
+    mutable std::atomic<std::uint32_t> epoch_{0};
+    mutable std::atomic<std::uint32_t> readers_[2]{};
+    std::mutex writerMutex_;
+
+    void publishLocked(std::unique_ptr<T> next) {
+        delete retireLocked(std::move(next));
+    }
+
+    T* retireLocked(std::unique_ptr<T> next) {
+        T* previous = current_.exchange(next.release(), std::memory_order_seq_cst);
+        const std::uint32_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        while (readers_[epoch & 1].load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+        return previous;
+    }
+};
+
+} // namespace nse::mtbt
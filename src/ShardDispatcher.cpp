@@ -0,0 +1,176 @@
+#include "ShardDispatcher.h"
+#include <algorithm>
+#include <numeric>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nse::mtbt {
+
+ShardDispatcher::ShardDispatcher(Config config, Handler handler)
+    : config_{std::move(config)}, handler_{std::move(handler)} {
+    config_.shardCount = std::clamp<std::size_t>(config_.shardCount, 1, UNASSIGNED - 1);
+    
+    const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    shards_.reserve(config_.shardCount);
+    for (std::size_t i = 0; i < config_.shardCount; ++i) {
+        shards_.push_back(std::make_unique<Shard>(config_.queueCapacity));
+    }
+    for (std::size_t i = 0; i < config_.shardCount; ++i) {
+        auto& shard = *shards_[i];
+        shard.worker = std::thread{[this, i] { runWorker(i); }};
+        if (config_.pinThreads) {
+            shard.cpu = pinToCpu(shard.worker, (config_.firstCpu + i) % cores);
+        }
+    }
+}
+
+ShardDispatcher::~ShardDispatcher() {
+    flush();
+    stopping_.store(true, std::memory_order_release);
+    for (auto& shard : shards_) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+}
+
+void ShardDispatcher::dispatch(const TradeMessage& message) {
+    const std::uint32_t id = symbolId(message.symbolToken);
+    const std::size_t index = (id == SymbolIndex::INVALID_ID) ? defaultShard(message.symbolToken) : shardOfSymbol_[id];
+    auto& shard = *shards_[index];
+    
+    if (!shard.queue.tryPush(message)) {
+        shard.producerStalls.fetch_add(1, std::memory_order_relaxed);
+        do {
+            std::this_thread::yield();
+        } while (!shard.queue.tryPush(message));
+    }
+    shard.dispatched.fetch_add(1, std::memory_order_relaxed);
+    
+    const std::size_t depth = shard.queue.size();
+    if (depth > shard.maxQueueDepth.load(std::memory_order_relaxed)) {
+        shard.maxQueueDepth.store(depth, std::memory_order_relaxed);
+    }
+    
+    if (id != SymbolIndex::INVALID_ID) {
+        ++loadOfSymbol_[id];
+    }
+    if (config_.rebalanceInterval > 0 && ++sinceRebalance_ >= config_.rebalanceInterval) {
+        rebalance();
+    }
+}
+
+void ShardDispatcher::flush() const noexcept {
+    for (const auto& shard : shards_) {
+        while (shard->processed.load(std::memory_order_acquire) != shard->dispatched.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ShardDispatcher::rebalance() {
+    sinceRebalance_ = 0;
+    if (symbols_.size() == 0) {
+        return;
+    }
+    
+    // Longest-processing-time greedy: heaviest symbol goes to the lightest shard
+    std::vector<std::uint32_t> order(symbols_.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return loadOfSymbol_[a] > loadOfSymbol_[b];
+    });
+    
+    std::vector<std::uint64_t> shardLoad(shards_.size(), 0);
+    std::vector<std::uint16_t> assignment(symbols_.size(), UNASSIGNED);
+    for (const std::uint32_t id : order) {
+        const auto lightest = std::min_element(shardLoad.begin(), shardLoad.end()) - shardLoad.begin();
+        assignment[id] = static_cast<std::uint16_t>(lightest);
+        // Idle symbols still count once so they spread out instead of piling onto one shard
+        shardLoad[static_cast<std::size_t>(lightest)] += std::max<std::uint64_t>(loadOfSymbol_[id], 1);
+    }
+    
+    // Drain in-flight trades before any token changes owner
+    flush();
+    shardOfSymbol_ = std::move(assignment);
+    std::fill(loadOfSymbol_.begin(), loadOfSymbol_.end(), 0);
+}
+
+std::size_t ShardDispatcher::shardFor(std::uint32_t token) {
+    const std::uint32_t id = symbolId(token);
+    return (id == SymbolIndex::INVALID_ID) ? defaultShard(token) : shardOfSymbol_[id];
+}
+
+std::vector<ShardDispatcher::ShardStats> ShardDispatcher::getShardStats() const {
+    std::vector<ShardStats> result(shards_.size());
+    for (std::size_t i = 0; i < shards_.size(); ++i) {
+        const auto& shard = *shards_[i];
+        auto& stats = result[i];
+        stats.dispatched = shard.dispatched.load(std::memory_order_relaxed);
+        stats.processed = shard.processed.load(std::memory_order_relaxed);
+        stats.producerStalls = shard.producerStalls.load(std::memory_order_relaxed);
+        stats.queueDepth = shard.queue.size();
+        stats.maxQueueDepth = shard.maxQueueDepth.load(std::memory_order_relaxed);
+        stats.cpu = shard.cpu;
+    }
+    for (const auto owner : shardOfSymbol_) {
+        ++result[owner].ownedTokens;
+    }
+    return result;
+}
+
+std::size_t ShardDispatcher::defaultShard(std::uint32_t token) const noexcept {
+    if (config_.mode == PartitionMode::RANGE) {
+        const std::uint64_t clamped = std::min(token, config_.rangeMaxToken - 1);
+        return static_cast<std::size_t>(clamped * shards_.size() / config_.rangeMaxToken);
+    }
+    // Fibonacci hashing spreads clustered token values evenly
+    const std::uint64_t hash = static_cast<std::uint64_t>(token) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>((hash >> 32) % shards_.size());
+}
+
+std::uint32_t ShardDispatcher::symbolId(std::uint32_t token) {
+    const std::uint32_t id = symbols_.getOrAssign(token);
+    if (id != SymbolIndex::INVALID_ID && id >= shardOfSymbol_.size()) {
+        shardOfSymbol_.push_back(static_cast<std::uint16_t>(defaultShard(token)));
+        loadOfSymbol_.push_back(0);
+    }
+    return id;
+}
+
+void ShardDispatcher::runWorker(std::size_t index) {
+    auto& shard = *shards_[index];
+    TradeMessage message;
+    
+    for (;;) {
+        if (shard.queue.tryPop(message)) {
+            handler_(index, message);
+            shard.processed.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+int ShardDispatcher::pinToCpu(std::thread& thread, std::size_t cpu) noexcept {
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) == 0) {
+        return static_cast<int>(cpu);
+    }
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+    return -1;
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SpscQueue.h"
+#include "SymbolIndex.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Fans decoded trades out to pinned worker threads, partitioned by symbol token
+ *
+ * Every token is owned by exactly one shard, so per-symbol state (books,
+ * bars, risk) is only ever touched by one core. dispatch() must be called
+ * from a single producer thread.
+ */
+class ShardDispatcher {
+public:
+    /**
+     * Token-to-shard partitioning strategy
+     */
+    enum class PartitionMode : std::uint8_t {
+        HASH = 0,   // Multiplicative hash of the token
+        RANGE = 1   // Contiguous token ranges up to rangeMaxToken
+    };
+
+    /**
+     * Dispatcher configuration
+     */
+    struct Config {
+        std::size_t shardCount{4};
+        std::size_t queueCapacity{1 << 16};
+        PartitionMode mode{PartitionMode::HASH};
+        std::uint32_t rangeMaxToken{1 << 16};
+        bool pinThreads{true};
+        std::size_t firstCpu{1};                  // Shard i is pinned to (firstCpu + i) % cores
+        std::uint64_t rebalanceInterval{0};       // Rebalance every N messages (0 = manual only)
+        
+        Config() = default;
+    };
+
+    /**
+     * Per-shard load report
+     */
+    struct ShardStats {
+        std::uint64_t dispatched{0};
+        std::uint64_t processed{0};
+        std::uint64_t producerStalls{0};  // Pushes that found the queue full
+        std::size_t queueDepth{0};
+        std::size_t maxQueueDepth{0};
+        std::size_t ownedTokens{0};
+        int cpu{-1};                      // Pinned core, -1 if unpinned
+    };
+
+    /**
+     * Called on the owning worker thread for every trade of a shard
+     */
+    using Handler = std::function<void(std::size_t shard, const TradeMessage& message)>;
+
+    ShardDispatcher(Config config, Handler handler);
+
+    ShardDispatcher(const ShardDispatcher&) = delete;
+    ShardDispatcher& operator=(const ShardDispatcher&) = delete;
+
+    /**
+     * Drain all queues and join the workers
+     */
+    ~ShardDispatcher();
+
+    /**
+     * Route one trade to its shard (spins while that shard's queue is full)
+     */
+    void dispatch(const TradeMessage& message);
+
+    /**
+     * Route a decoded batch
+     */
+    void dispatch(const std::vector<TradeMessage>& messages) {
+        for (const auto& message : messages) {
+            dispatch(message);
+        }
+    }
+
+    /**
+     * Block until every queued trade has been handled
+     */
+    void flush() const noexcept;
+
+    /**
+     * Reassign tokens so observed load is spread evenly (greedy, heaviest first)
+     *
+     * Queues are drained before ownership moves, so a token is never in
+     * flight on two shards at once.
+     */
+    void rebalance();
+
+    /**
+     * Shard currently owning a token
+     */
+    [[nodiscard]] std::size_t shardFor(std::uint32_t token);
+
+    [[nodiscard]] std::vector<ShardStats> getShardStats() const;
+    [[nodiscard]] const Config& getConfig() const noexcept { return config_; }
+
+private:
+    /**
+     * Worker-owned queue plus counters, isolated on its own cache lines
+     */
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        explicit Shard(std::size_t capacity) : queue{capacity} {}
+        
+        SpscQueue<TradeMessage> queue;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> processed{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> dispatched{0};
+        std::atomic<std::uint64_t> producerStalls{0};
+        std::atomic<std::size_t> maxQueueDepth{0};
+        int cpu{-1};
+        std::thread worker;
+    };
+
+    static constexpr std::uint16_t UNASSIGNED = 0xFFFF;
+
+    Config config_;
+    Handler handler_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> stopping_{false};
+    
+    // Producer-thread state
+    SymbolIndex symbols_;
+    std::vector<std::uint16_t> shardOfSymbol_;     // Dense symbol id -> shard
+    std::vector<std::uint64_t> loadOfSymbol_;      // Messages since last rebalance
+    std::uint64_t sinceRebalance_{0};
+
+    [[nodiscard]] std::size_t defaultShard(std::uint32_t token) const noexcept;
+    [[nodiscard]] std::uint32_t symbolId(std::uint32_t token);
+    void runWorker(std::size_t index);
+    static int pinToCpu(std::thread& thread, std::size_t cpu) noexcept;
+};
+
+} // namespace nse::mtbt
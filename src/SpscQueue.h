@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Destructive-interference size used to keep hot atomics apart
+ */
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Bounded single-producer/single-consumer ring buffer
+ *
+ * Head and tail live on separate cache lines and each side caches the
+ * other's index, so the common case touches no shared line at all.
+ */
+template<typename T>
+class SpscQueue {
+public:
+    /**
+     * Capacity is rounded up to a power of two
+     */
+    explicit SpscQueue(std::size_t capacity) : slots_(roundUpPow2(capacity)), mask_{slots_.size() - 1} {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * Producer side; false when the ring is full
+     */
+    [[nodiscard]] bool tryPush(const T& value) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side; false when the ring is empty
+     */
+    [[nodiscard]] bool tryPop(T& value) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        value = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Approximate number of queued items (safe from any thread)
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return slots_.size(); }
+
+private:
+    std::vector<T> slots_;
+    const std::size_t mask_;
+    
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0}; // Written by consumer
+    std::size_t cachedTail_{0};                                 // Consumer's view of tail
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{0}; // Written by producer
+    std::size_t cachedHead_{0};                                 // Producer's view of head
+
+    [[nodiscard]] static std::size_t roundUpPow2(std::size_t value) noexcept {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,169 @@
+#include "StatsExport.h"
+#include "Platform.h"
+#include <new>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr int MAX_READ_RETRIES = 1000;
+
+} // namespace
+
+std::optional<StatsExporter> StatsExporter::create(const std::string& name) {
+#if defined(__linux__)
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    if (::ftruncate(fd, sizeof(Layout)) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    void* region = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        return std::nullopt;
+    }
+    
+    StatsExporter exporter;
+    exporter.layout_ = new (region) Layout{};
+    exporter.layout_->writerPid = static_cast<std::int64_t>(::getpid());
+    exporter.layout_->version = LAYOUT_VERSION;
+    // Magic last: readers treat the segment as valid only once it is set
+    std::atomic_thread_fence(std::memory_order_release);
+    exporter.layout_->magic = LAYOUT_MAGIC;
+    return exporter;
+#else
+    (void)name;
+    return std::nullopt;
+#endif
+}
+
+std::optional<StatsExporter> StatsExporter::attach(const std::string& name) {
+#if defined(__linux__)
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    void* region = ::mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        return std::nullopt;
+    }
+    
+    StatsExporter exporter;
+    exporter.layout_ = static_cast<Layout*>(region);
+    if (exporter.layout_->magic != LAYOUT_MAGIC || exporter.layout_->version != LAYOUT_VERSION) {
+        return std::nullopt; // Destructor unmaps
+    }
+    return exporter;
+#else
+    (void)name;
+    return std::nullopt;
+#endif
+}
+
+StatsExporter::StatsExporter(StatsExporter&& other) noexcept : layout_{other.layout_} {
+    other.layout_ = nullptr;
+}
+
+StatsExporter& StatsExporter::operator=(StatsExporter&& other) noexcept {
+    if (this != &other) {
+        release();
+        layout_ = other.layout_;
+        other.layout_ = nullptr;
+    }
+    return *this;
+}
+
+StatsExporter::~StatsExporter() {
+    release();
+}
+
+void StatsExporter::release() noexcept {
+#if defined(__linux__)
+    if (layout_) {
+        ::munmap(layout_, sizeof(Layout));
+    }
+#endif
+    layout_ = nullptr;
+}
+
+bool StatsExporter::unlink(const std::string& name) noexcept {
+#if defined(__linux__)
+    return ::shm_unlink(name.c_str()) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void StatsExporter::publish(const Decoder::DecodingStats& stats, std::uint64_t batchMessages,
+                            std::uint64_t batchBytes) noexcept {
+    store(Counter::DECODED_MESSAGES, stats.decodedMessages + batchMessages);
+    store(Counter::VALID_MESSAGES, stats.validMessages);
+    store(Counter::ERROR_COUNT, stats.errorCount);
+    store(Counter::CRC_ERRORS, stats.crcErrors);
+    store(Counter::PROTOCOL_ERRORS, stats.protocolErrors);
+    store(Counter::BYTES_PROCESSED, stats.bytesProcessed + batchBytes);
+    store(Counter::SEQUENCE_GAPS, stats.sequenceGaps);
+    store(Counter::MISSING_MESSAGES, stats.missingMessages);
+    store(Counter::FILTERED_MESSAGES, stats.filteredMessages);
+    store(Counter::LIMIT_VIOLATIONS, stats.limitViolations);
+    layout_->heartbeatNs.store(steadyNowNs(), std::memory_order_release);
+}
+
+void StatsExporter::recordLatency(std::uint64_t nanoseconds) noexcept {
+    auto& layout = *layout_;
+    auto& bucket = layout.latencyBuckets[LatencyHistogram::bucketFor(nanoseconds)];
+    auto& batches = layout.counters[static_cast<std::size_t>(Counter::BATCHES)].value;
+    
+    // Single writer: plain load/store pairs, no read-modify-write needed
+    const std::uint32_t sequence = layout.latencySequence.load(std::memory_order_relaxed);
+    layout.latencySequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    layout.latencyCount.store(layout.latencyCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    layout.latencySumNs.store(layout.latencySumNs.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+    layout.latencySequence.store(sequence + 2, std::memory_order_release);
+    
+    batches.store(batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::optional<StatsExporter::Snapshot> StatsExporter::read() const noexcept {
+    const auto& layout = *layout_;
+    Snapshot snapshot;
+    snapshot.heartbeatNs = layout.heartbeatNs.load(std::memory_order_acquire);
+    snapshot.writerPid = layout.writerPid;
+    for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+        snapshot.counters[i] = layout.counters[i].value.load(std::memory_order_relaxed);
+    }
+    
+    // Seqlock read: copy, then confirm no write overlapped the copy. The retry
+    // cap keeps a reader from spinning forever on a writer that died mid-update.
+    for (int attempt = 0; attempt < MAX_READ_RETRIES; ++attempt) {
+        const std::uint32_t before = layout.latencySequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;
+        }
+        snapshot.latencyCount = layout.latencyCount.load(std::memory_order_relaxed);
+        snapshot.latencySumNs = layout.latencySumNs.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+            snapshot.latencyBuckets[i] = layout.latencyBuckets[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (layout.latencySequence.load(std::memory_order_relaxed) == before) {
+            return snapshot;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace nse::mtbt
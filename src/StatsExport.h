@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Decoder.h"
+#include "LatencyHistogram.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <optional>
+#include <string>
+
+namespace nse::mtbt {
+
+/**
+ * Live decoder counters published in a POSIX shared-memory segment (/dev/shm)
+ *
+ * The decoding thread is the only writer: counters are relaxed atomic
+ * stores on their own cache lines and the latency histogram is guarded by
+ * a seqlock, so external readers never stall the decoder (they retry
+ * instead). Linux only; open() returns nullopt elsewhere.
+ */
+class StatsExporter {
+public:
+    static constexpr std::uint32_t LAYOUT_MAGIC = 0x5354544D; // "MTTS"
+    static constexpr std::uint32_t LAYOUT_VERSION = 2;
+    static constexpr const char* DEFAULT_NAME = "/nse_mtbt_stats";
+
+    /**
+     * Exported counters, in shared-memory slot order
+     */
+    enum class Counter : std::size_t {
+        DECODED_MESSAGES = 0,
+        VALID_MESSAGES,
+        ERROR_COUNT,
+        CRC_ERRORS,
+        PROTOCOL_ERRORS,
+        BYTES_PROCESSED,
+        SEQUENCE_GAPS,
+        MISSING_MESSAGES,
+        FILTERED_MESSAGES,
+        LIMIT_VIOLATIONS,
+        BATCHES,
+        COUNT
+    };
+
+    static constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::COUNT);
+
+    /**
+     * One counter per cache line so readers polling one never disturb another
+     */
+    struct alignas(CACHE_LINE_SIZE) PaddedCounter {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    /**
+     * Shared-memory layout (shared with the reader tool; bump LAYOUT_VERSION on change)
+     */
+    struct Layout {
+        std::uint32_t magic{0};
+        std::uint32_t version{0};
+        std::int64_t writerPid{0};
+        std::atomic<std::uint64_t> heartbeatNs{0};   // Steady-clock time of the last publish
+        PaddedCounter counters[COUNTER_COUNT];
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> latencySequence{0}; // Odd while writing
+        std::atomic<std::uint64_t> latencyCount{0};
+        std::atomic<std::uint64_t> latencySumNs{0};
+        std::atomic<std::uint64_t> latencyBuckets[LatencyHistogram::BUCKET_COUNT];
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared-memory counters must be lock-free");
+
+    /**
+     * Consistent copy of the exported values
+     */
+    struct Snapshot {
+        std::uint64_t heartbeatNs{0};
+        std::int64_t writerPid{0};
+        std::uint64_t counters[COUNTER_COUNT]{};
+        std::uint64_t latencyCount{0};
+        std::uint64_t latencySumNs{0};
+        LatencyHistogram::Counts latencyBuckets{};
+        
+        [[nodiscard]] std::uint64_t get(Counter counter) const noexcept {
+            return counters[static_cast<std::size_t>(counter)];
+        }
+    };
+
+    /**
+     * Create (or re-initialize) the named segment for writing
+     */
+    [[nodiscard]] static std::optional<StatsExporter> create(const std::string& name = DEFAULT_NAME);
+
+    /**
+     * Attach read-only to an existing segment
+     */
+    [[nodiscard]] static std::optional<StatsExporter> attach(const std::string& name = DEFAULT_NAME);
+
+    StatsExporter(const StatsExporter&) = delete;
+    StatsExporter& operator=(const StatsExporter&) = delete;
+    StatsExporter(StatsExporter&& other) noexcept;
+    StatsExporter& operator=(StatsExporter&& other) noexcept;
+    ~StatsExporter();
+
+    /**
+     * Publish decoder counters, adding the in-flight batch progress (writer only)
+     */
+    void publish(const Decoder::DecodingStats& stats, std::uint64_t batchMessages = 0,
+                 std::uint64_t batchBytes = 0) noexcept;
+
+    /**
+     * Record one batch decode latency (writer only)
+     */
+    void recordLatency(std::uint64_t nanoseconds) noexcept;
+
+    /**
+     * Copy the current values; retries while the writer is mid-update
+     *
+     * Returns nullopt when no untorn latency histogram could be copied within
+     * MAX_READ_RETRIES (a busy or dead writer); callers retry later or skip.
+     */
+    [[nodiscard]] std::optional<Snapshot> read() const noexcept;
+
+    /**
+     * Remove the named segment from /dev/shm
+     */
+    static bool unlink(const std::string& name = DEFAULT_NAME) noexcept;
+
+private:
+    StatsExporter() = default;
+
+    Layout* layout_{nullptr};
+
+    void store(Counter counter, std::uint64_t value) noexcept {
+        layout_->counters[static_cast<std::size_t>(counter)].value.store(value, std::memory_order_relaxed);
+    }
+    void release() noexcept;
+};
+
+} // namespace nse::mtbt
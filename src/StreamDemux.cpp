@@ -0,0 +1,193 @@
+#include "StreamDemux.h"
+#include <algorithm>
+#include <cstring>
+
+namespace nse::mtbt {
+
+StreamDemux::StreamDemux(Config config, TradeHandler handler)
+    : config_{std::move(config)}, handler_{std::move(handler)} {
+    config_.streamCount = std::clamp<std::size_t>(config_.streamCount, 1, std::size_t{1} << 16);
+    config_.batchMessages = std::max<std::size_t>(config_.batchMessages, 1);
+    const bool inlineDecode = config_.threadCount == 0;
+    const std::size_t workerCount = inlineDecode ? 1 : config_.threadCount;
+
+    fills_.resize(config_.streamCount);
+    slots_.resize(config_.streamCount);
+    std::vector<std::size_t> streamsOnWorker(workerCount, 0);
+    for (std::size_t stream = 0; stream < config_.streamCount; ++stream) {
+        const std::size_t assigned = stream < config_.streamThreads.size() ? config_.streamThreads[stream] : stream;
+        fills_[stream].worker = static_cast<std::uint16_t>(assigned % workerCount);
+        ++streamsOnWorker[fills_[stream].worker];
+
+        slots_[stream].decoder.setValidationLevel(config_.validationLevel);
+        slots_[stream].decoder.setInstrumentLimits(config_.instrumentLimits);
+        slots_[stream].decoder.setSubscriptionFilter(config_.subscriptionFilter);
+        slots_[stream].decoder.setMaxSequenceJump(config_.maxSequenceJump);
+    }
+
+    // Every stream may hold one batch while it fills; the spares keep the threads busy
+    workers_.reserve(workerCount);
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        const std::size_t batchCount = streamsOnWorker[i] + std::max<std::size_t>(config_.batchesInFlight, 1);
+        auto& worker = *workers_.emplace_back(std::make_unique<Worker>(batchCount));
+        for (std::uint32_t batch = 0; batch < batchCount; ++batch) {
+            worker.batches[batch].bytes.resize(config_.batchMessages * ProtocolConstants::MESSAGE_SIZE);
+            (void)worker.free.tryPush(batch);
+        }
+        if (!inlineDecode) {
+            worker.thread = std::thread{[this, &worker] { runWorker(worker); }};
+        }
+    }
+}
+
+StreamDemux::~StreamDemux() {
+    flush();
+    stopping_.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void StreamDemux::decodeBatch(Batch& batch) {
+    auto& slot = slots_[batch.stream];
+    slot.decoder.decodeFeedInto(batch.bytes.data(), batch.frames * ProtocolConstants::MESSAGE_SIZE, slot.messages);
+    if (handler_) {
+        for (const auto& message : slot.messages) {
+            handler_(batch.stream, message);
+        }
+    }
+}
+
+void StreamDemux::runWorker(Worker& worker) {
+    std::uint32_t batch = 0;
+    for (;;) {
+        if (worker.ready.tryPop(batch)) {
+            decodeBatch(worker.batches[batch]);
+            (void)worker.free.tryPush(batch);  // Never full: both queues hold the whole pool
+            worker.completed.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+        if (stopping_.load(std::memory_order_relaxed)) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void StreamDemux::submit(std::uint16_t stream) {
+    auto& fill = fills_[stream];
+    auto& worker = *workers_[fill.worker];
+    auto& batch = worker.batches[fill.batch];
+    batch.stream = stream;
+    batch.frames = fill.frames;
+    fill.frames = 0;
+    fill.holdsBatch = false;
+    ++demuxStats_.batches;
+
+    if (!worker.thread.joinable()) {
+        decodeBatch(batch);
+        (void)worker.free.tryPush(fill.batch);
+        return;
+    }
+    ++worker.submitted;
+    (void)worker.ready.tryPush(fill.batch);
+}
+
+void StreamDemux::appendFrame(std::uint16_t stream, const std::uint8_t* frame) {
+    auto& fill = fills_[stream];
+    if (!fill.holdsBatch) {
+        auto& worker = *workers_[fill.worker];
+        if (!worker.free.tryPop(fill.batch)) {
+            ++demuxStats_.producerStalls;
+            while (!worker.free.tryPop(fill.batch)) {
+                std::this_thread::yield();
+            }
+        }
+        fill.holdsBatch = true;
+    }
+
+    auto& batch = workers_[fill.worker]->batches[fill.batch];
+    std::memcpy(batch.bytes.data() + fill.frames * ProtocolConstants::MESSAGE_SIZE, frame,
+                ProtocolConstants::MESSAGE_SIZE);
+    if (++fill.frames == config_.batchMessages) {
+        submit(stream);
+    }
+}
+
+void StreamDemux::routeFrame(const std::uint8_t* frame) {
+    ++demuxStats_.segmentFrames;
+    const auto stream = wire::TradeFrame::StreamId::load(frame);
+    if (stream >= fills_.size()) {
+        ++demuxStats_.unroutedFrames;
+        return;
+    }
+    appendFrame(stream, frame);
+}
+
+void StreamDemux::onSegmentData(const std::uint8_t* data, std::size_t size) {
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+
+    // Complete a frame split across the previous chunk
+    if (segmentPartialBytes_ > 0) {
+        const std::size_t take = std::min(FRAME - segmentPartialBytes_, size);
+        std::memcpy(segmentPartial_.data() + segmentPartialBytes_, data, take);
+        segmentPartialBytes_ += take;
+        data += take;
+        size -= take;
+        if (segmentPartialBytes_ < FRAME) {
+            return;
+        }
+        routeFrame(segmentPartial_.data());
+        segmentPartialBytes_ = 0;
+    }
+
+    for (; size >= FRAME; data += FRAME, size -= FRAME) {
+        routeFrame(data);
+    }
+    std::memcpy(segmentPartial_.data(), data, size);
+    segmentPartialBytes_ = size;
+}
+
+void StreamDemux::onStreamData(std::uint16_t stream, const std::uint8_t* data, std::size_t size) {
+    constexpr std::size_t FRAME = ProtocolConstants::MESSAGE_SIZE;
+    if (stream >= fills_.size()) {
+        return;
+    }
+    auto& fill = fills_[stream];
+
+    if (fill.partialBytes > 0) {
+        const std::size_t take = std::min(FRAME - fill.partialBytes, size);
+        std::memcpy(fill.partial.data() + fill.partialBytes, data, take);
+        fill.partialBytes = static_cast<std::uint8_t>(fill.partialBytes + take);
+        data += take;
+        size -= take;
+        if (fill.partialBytes < FRAME) {
+            return;
+        }
+        fill.partialBytes = 0;
+        appendFrame(stream, fill.partial.data());  // Copies the frame before partial is reused
+    }
+
+    for (; size >= FRAME; data += FRAME, size -= FRAME) {
+        appendFrame(stream, data);
+    }
+    std::memcpy(fill.partial.data(), data, size);
+    fill.partialBytes = static_cast<std::uint8_t>(size);
+}
+
+void StreamDemux::flush() {
+    for (std::size_t stream = 0; stream < fills_.size(); ++stream) {
+        if (fills_[stream].holdsBatch && fills_[stream].frames > 0) {
+            submit(static_cast<std::uint16_t>(stream));
+        }
+    }
+    for (auto& worker : workers_) {
+        while (worker->completed.load(std::memory_order_acquire) != worker->submitted) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Decoder.h"
+#include "SpscQueue.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Demultiplexes a segment's frames into independently sequenced streams
+ *
+ * Frames are routed by their stream id into per-stream batches; each stream
+ * has its own Decoder (expected sequence, stats, gaps), owned by exactly one
+ * decoder thread, so streams never contend with each other. Per-stream state
+ * lives in two flat arrays indexed by stream id: producer-side fill state
+ * (current batch, partial frame) and worker-side decoder slots, kept apart so
+ * the producer never writes a line a worker reads. The on*Data() calls and
+ * flush() must come from a single producer thread.
+ */
+class StreamDemux {
+public:
+    struct Config {
+        std::size_t streamCount{16};
+        std::size_t threadCount{1};                 // Decoder threads; 0 decodes inline on the caller
+        std::vector<std::size_t> streamThreads{};   // Stream -> thread (empty: stream % threadCount)
+        std::size_t batchMessages{1024};
+        std::size_t batchesInFlight{4};             // Spare batches per thread beyond one per stream
+        ValidationLevel validationLevel{ValidationLevel::STRICT};
+        const InstrumentLimits* instrumentLimits{nullptr};  // Shared by all stream decoders
+        const SubscriptionFilter* subscriptionFilter{nullptr};  // Shared by all stream decoders
+        std::uint32_t maxSequenceJump{Decoder::DEFAULT_MAX_SEQUENCE_JUMP};
+
+        Config() = default;
+    };
+
+    /**
+     * Producer-side routing counters
+     */
+    struct DemuxStats {
+        std::uint64_t segmentFrames{0};   // Frames seen by onSegmentData()
+        std::uint64_t unroutedFrames{0};  // Stream id outside [0, streamCount) (corrupt or foreign)
+        std::uint64_t producerStalls{0};  // Waits for a decoder thread to free a batch
+        std::uint64_t batches{0};         // Batches handed to decoders
+    };
+
+    /**
+     * Called on the stream's decoder thread for every valid trade, in stream order
+     */
+    using TradeHandler = std::function<void(std::uint16_t stream, const TradeMessage& message)>;
+
+    StreamDemux(Config config, TradeHandler handler);
+
+    /**
+     * Flush, then join the decoder threads
+     */
+    ~StreamDemux();
+
+    StreamDemux(const StreamDemux&) = delete;
+    StreamDemux& operator=(const StreamDemux&) = delete;
+
+    /**
+     * Route interleaved frames of the whole segment by their stream id
+     *
+     * Chunks may split frames anywhere; the tail is carried to the next call.
+     */
+    void onSegmentData(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Feed one stream's own transport (e.g. its multicast group); chunks may split frames
+     */
+    void onStreamData(std::uint16_t stream, const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Decode every buffered frame and wait until all handlers have run
+     */
+    void flush();
+
+    /**
+     * Decoder statistics of one stream (consistent after flush())
+     */
+    [[nodiscard]] const Decoder::DecodingStats& getStats(std::uint16_t stream) const noexcept {
+        return slots_[stream].decoder.getStats();
+    }
+
+    /**
+     * Sequence gaps of one stream (consistent after flush())
+     */
+    [[nodiscard]] const std::vector<Decoder::SequenceGap>& getGaps(std::uint16_t stream) const noexcept {
+        return slots_[stream].decoder.getGaps();
+    }
+
+    [[nodiscard]] std::size_t streamCount() const noexcept { return fills_.size(); }
+    [[nodiscard]] std::size_t threadCount() const noexcept { return config_.threadCount; }
+    [[nodiscard]] std::size_t threadOf(std::uint16_t stream) const noexcept { return fills_[stream].worker; }
+    [[nodiscard]] const DemuxStats& getDemuxStats() const noexcept { return demuxStats_; }
+
+private:
+    /**
+     * Frames of one stream, copied out of the segment
+     */
+    struct Batch {
+        std::uint16_t stream{0};
+        std::uint32_t frames{0};
+        std::vector<std::uint8_t> bytes;
+    };
+
+    /**
+     * Producer-owned per-stream state
+     */
+    struct Fill {
+        std::uint32_t batch{0};
+        std::uint32_t frames{0};
+        std::uint16_t worker{0};
+        std::uint8_t partialBytes{0};
+        bool holdsBatch{false};
+        std::array<std::uint8_t, ProtocolConstants::MESSAGE_SIZE> partial{};
+    };
+
+    /**
+     * Worker-owned per-stream state, one cache-line-aligned slot per stream
+     */
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        Decoder decoder;
+        Decoder::MessageBuffer messages;
+    };
+
+    /**
+     * One decoder thread (or the caller, inline) and its batch pool
+     */
+    struct Worker {
+        explicit Worker(std::size_t batchCount) : batches(batchCount), ready{batchCount}, free{batchCount} {}
+
+        std::vector<Batch> batches;
+        SpscQueue<std::uint32_t> ready;   // Filled batches, producer -> worker
+        SpscQueue<std::uint32_t> free;    // Decoded batches, worker -> producer
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> completed{0};
+        std::uint64_t submitted{0};       // Producer only
+        std::thread thread;
+    };
+
+    Config config_;
+    TradeHandler handler_;
+    std::vector<Fill> fills_;
+    std::vector<Slot> slots_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    DemuxStats demuxStats_{};
+    std::array<std::uint8_t, ProtocolConstants::MESSAGE_SIZE> segmentPartial_{};
+    std::size_t segmentPartialBytes_{0};
+    std::atomic<bool> stopping_{false};
+
+    void appendFrame(std::uint16_t stream, const std::uint8_t* frame);
+    void routeFrame(const std::uint8_t* frame);
+    void submit(std::uint16_t stream);
+    void decodeBatch(Batch& batch);
+    void runWorker(Worker& worker);
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,107 @@
+#include "SubscriptionFilter.h"
+#include "Platform.h"
+#include "SymbolIndex.h"
+#include <bitset>
+
+namespace nse::mtbt {
+
+namespace {
+
+std::uint32_t loadToken(const std::uint8_t* frame) noexcept {
+    return wire::TradeFrame::SymbolToken::load(frame);
+}
+
+std::uint32_t testFramesScalar(const SubscriptionFilter::Bitmap& bitmap, const std::uint8_t* frames, std::size_t count) noexcept {
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (bitmap.test(loadToken(frames + i * ProtocolConstants::MESSAGE_SIZE))) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+/**
+ * Gather 8 tokens at 40-byte stride, then gather and test their bitmap words
+ */
+__attribute__((target("avx2")))
+std::uint32_t testFramesAvx2(const SubscriptionFilter::Bitmap& bitmap, const std::uint8_t* frames) noexcept {
+    constexpr int STRIDE = static_cast<int>(ProtocolConstants::MESSAGE_SIZE);
+    const __m256i frameOffsets = _mm256_setr_epi32(0, STRIDE, 2 * STRIDE, 3 * STRIDE,
+                                                   4 * STRIDE, 5 * STRIDE, 6 * STRIDE, 7 * STRIDE);
+    const auto* tokenBase = reinterpret_cast<const int*>(frames + ProtocolConstants::OFFSET_SYMBOL_TOKEN);
+    const __m256i tokens = _mm256_i32gather_epi32(tokenBase, frameOffsets, 1);
+    
+    // Word index fits in 27 bits, so a signed compare bounds-checks it
+    const __m256i wordIndex = _mm256_srli_epi32(tokens, 5);
+    const __m256i inRange = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(bitmap.wordCount())), wordIndex);
+    const __m256i words = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(),
+                                                      reinterpret_cast<const int*>(bitmap.words()),
+                                                      wordIndex, inRange, 4);
+    
+    const __m256i bits = _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_and_si256(tokens, _mm256_set1_epi32(31)));
+    const __m256i missing = _mm256_cmpeq_epi32(_mm256_and_si256(words, bits), _mm256_setzero_si256());
+    return ~static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(missing))) & 0xFFu;
+}
+#endif
+
+} // namespace
+
+SubscriptionFilter::Bitmap::Bitmap(const std::vector<std::uint32_t>& tokens) {
+    for (const auto token : tokens) {
+        set(token);
+    }
+}
+
+void SubscriptionFilter::Bitmap::set(std::uint32_t token) {
+    if (token >= SymbolIndex::MAX_TOKEN) {
+        return;
+    }
+    const std::size_t word = token >> 5;
+    if (word >= words_.size()) {
+        words_.resize(word + 1, 0);
+    }
+    words_[word] |= 1u << (token & 31);
+}
+
+void SubscriptionFilter::Bitmap::clear(std::uint32_t token) noexcept {
+    const std::size_t word = token >> 5;
+    if (word < words_.size()) {
+        words_[word] &= ~(1u << (token & 31));
+    }
+}
+
+std::size_t SubscriptionFilter::Bitmap::count() const noexcept {
+    std::size_t total = 0;
+    for (const auto word : words_) {
+        total += std::bitset<32>{word}.count();
+    }
+    return total;
+}
+
+SubscriptionFilter::SubscriptionFilter(const std::vector<std::uint32_t>& tokens)
+    : bitmap_{std::make_unique<Bitmap>(tokens)} {}
+
+void SubscriptionFilter::setSubscriptions(const std::vector<std::uint32_t>& tokens) {
+    bitmap_.update(std::make_unique<Bitmap>(tokens));
+}
+
+void SubscriptionFilter::subscribe(std::uint32_t token) {
+    bitmap_.modify([token](Bitmap& bitmap) { bitmap.set(token); });
+}
+
+void SubscriptionFilter::unsubscribe(std::uint32_t token) {
+    bitmap_.modify([token](Bitmap& bitmap) { bitmap.clear(token); });
+}
+
+std::uint32_t SubscriptionFilter::testFrames(const Bitmap& bitmap, const std::uint8_t* frames, std::size_t count) noexcept {
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+    if (count == BATCH_FRAMES && cpuHasAvx2()) {
+        return testFramesAvx2(bitmap, frames);
+    }
+#endif
+    return testFramesScalar(bitmap, frames, count);
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "Rcu.h"
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Token subscription set consulted before a frame is parsed
+ *
+ * The decoder peeks only at the 4-byte token of each frame and tests it
+ * against a dense bitset, eight frames per AVX2 pass where the CPU supports
+ * it. Subscriptions are swapped RCU-style, so they can change at runtime
+ * while decoding continues without locks.
+ */
+class SubscriptionFilter {
+public:
+    /**
+     * Immutable dense bitset over the token space
+     */
+    class Bitmap {
+    public:
+        Bitmap() = default;
+        explicit Bitmap(const std::vector<std::uint32_t>& tokens);
+        
+        [[nodiscard]] bool test(std::uint32_t token) const noexcept {
+            const std::size_t word = token >> 5;
+            return word < words_.size() && ((words_[word] >> (token & 31)) & 1u);
+        }
+        
+        void set(std::uint32_t token);
+        void clear(std::uint32_t token) noexcept;
+        [[nodiscard]] std::size_t count() const noexcept;
+        
+        [[nodiscard]] const std::uint32_t* words() const noexcept { return words_.data(); }
+        [[nodiscard]] std::size_t wordCount() const noexcept { return words_.size(); }
+        
+    private:
+        std::vector<std::uint32_t> words_;
+    };
+
+    /**
+     * Start with the given subscriptions (empty = nothing passes)
+     */
+    explicit SubscriptionFilter(const std::vector<std::uint32_t>& tokens = {});
+
+    /**
+     * Replace the whole subscription set
+     */
+    void setSubscriptions(const std::vector<std::uint32_t>& tokens);
+
+    void subscribe(std::uint32_t token);
+    void unsubscribe(std::uint32_t token);
+
+    /**
+     * Pin the current bitmap for the duration of a batch
+     */
+    [[nodiscard]] RcuPointer<Bitmap>::ReadGuard acquire() const noexcept { return bitmap_.read(); }
+
+    /**
+     * Test up to 8 consecutive frames; bit i of the result is set if frame i is subscribed
+     */
+    [[nodiscard]] static std::uint32_t testFrames(const Bitmap& bitmap, const std::uint8_t* frames, std::size_t count) noexcept;
+
+    /**
+     * Number of frames testFrames() handles per call
+     */
+    static constexpr std::size_t BATCH_FRAMES = 8;
+
+private:
+    RcuPointer<Bitmap> bitmap_;
+};
+
+} // namespace nse::mtbt
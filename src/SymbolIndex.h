@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Maps sparse NSE tokens to dense ids so per-symbol state can live in flat arrays
+ *
+ * Lookups are a single indexed load. Not thread-safe: ids are assigned by
+ * one owner thread, typically the decoding thread.
+ */
+class SymbolIndex {
+public:
+    static constexpr std::uint32_t INVALID_ID = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t MAX_TOKEN = 1u << 22; // Well above the NSE token range
+
+    /**
+     * Dense id for a token, assigning the next id on first sight
+     */
+    [[nodiscard]] std::uint32_t getOrAssign(std::uint32_t token) {
+        if (token >= MAX_TOKEN) {
+            return INVALID_ID;
+        }
+        if (token >= tokenToId_.size()) {
+            tokenToId_.resize(std::max<std::size_t>(token + 1, tokenToId_.size() * 2), INVALID_ID);
+        }
+        auto& id = tokenToId_[token];
+        if (id == INVALID_ID) {
+            id = static_cast<std::uint32_t>(idToToken_.size());
+            idToToken_.push_back(token);
+        }
+        return id;
+    }
+
+    /**
+     * Dense id for a known token, INVALID_ID otherwise
+     */
+    [[nodiscard]] std::uint32_t find(std::uint32_t token) const noexcept {
+        return token < tokenToId_.size() ? tokenToId_[token] : INVALID_ID;
+    }
+
+    [[nodiscard]] std::uint32_t tokenOf(std::uint32_t id) const noexcept { return idToToken_[id]; }
+    [[nodiscard]] std::size_t size() const noexcept { return idToToken_.size(); }
+
+    /**
+     * Pre-size the lookup table so steady-state lookups never reallocate
+     */
+    void reserveTokens(std::uint32_t maxToken) {
+        if (maxToken < MAX_TOKEN && maxToken >= tokenToId_.size()) {
+            tokenToId_.resize(maxToken + 1, INVALID_ID);
+        }
+    }
+
+private:
+    std::vector<std::uint32_t> tokenToId_;
+    std::vector<std::uint32_t> idToToken_;
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,388 @@
+#include "TcpPublisher.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <cerrno>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr std::size_t MAX_IOV = 64;              // Batches gathered into one send
+constexpr std::size_t MAX_EVENTS = 64;
+constexpr int LISTEN_BACKLOG = 128;
+constexpr std::uint64_t SHUTDOWN_GRACE_NS = 1'000'000'000;
+
+} // namespace
+
+/**
+ * Event-loop-owned connection state
+ */
+struct TcpPublisher::Client {
+    int fd{-1};
+    bool zeroCopy{false};
+    bool writeArmed{false};                // EPOLLOUT registered: the socket buffer was full
+    std::deque<Batch> queue;
+    std::size_t sentOfFront{0};            // Bytes of queue.front() already on the wire
+    std::size_t queuedBytes{0};            // Unsent bytes across the queue
+    std::uint32_t nextZeroCopyId{0};       // Kernel numbers MSG_ZEROCOPY sends per socket from 0
+    std::deque<std::pair<std::uint32_t, Batch>> awaitingCompletion;  // Pinned until the kernel releases them
+};
+
+TcpPublisher::TcpPublisher(Config config)
+    : config_{std::move(config)},
+      open_(wire::BatchHeader::SIZE + std::max<std::size_t>(config_.batchMessages, 1) * ProtocolConstants::MESSAGE_SIZE),
+      openBytes_{wire::BatchHeader::SIZE},
+      handoff_{config_.handoffBatches} {
+    config_.batchMessages = std::max<std::size_t>(config_.batchMessages, 1);
+#if defined(__linux__)
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    const int one = 1;
+    bool ok = listenFd_ >= 0 && epollFd_ >= 0 && wakeFd_ >= 0 &&
+              ::inet_pton(AF_INET, config_.bindAddress.c_str(), &address.sin_addr) == 1 &&
+              ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) == 0 &&
+              ::bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 &&
+              ::listen(listenFd_, LISTEN_BACKLOG) == 0;
+
+    socklen_t length = sizeof(address);
+    ok = ok && ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length) == 0;
+    for (const int fd : {listenFd_, wakeFd_}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ok = ok && ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    if (!ok) {
+        for (int* fd : {&listenFd_, &epollFd_, &wakeFd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+            }
+            *fd = -1;
+        }
+        return;
+    }
+    port_ = ntohs(address.sin_port);
+    loop_ = std::thread{&TcpPublisher::runLoop, this};
+#endif
+}
+
+TcpPublisher::~TcpPublisher() {
+#if defined(__linux__)
+    if (!listening()) {
+        return;
+    }
+    flush();
+    stopping_.store(true, std::memory_order_release);
+    wake();
+    loop_.join();
+    ::close(listenFd_);
+    ::close(epollFd_);
+    ::close(wakeFd_);
+#endif
+}
+
+void TcpPublisher::flush() {
+    if (openCount_ == 0) {
+        return;
+    }
+    messages_ += openCount_;
+    if (listening()) {
+        wire::BatchHeader::Magic::store(open_.data(), wire::BatchHeader::MAGIC);
+        wire::BatchHeader::Count::store(open_.data(), static_cast<std::uint32_t>(openCount_));
+        wire::BatchHeader::Batch::store(open_.data(), nextBatch_);
+        wire::BatchHeader::SendTime::store(open_.data(), steadyNowNs());
+
+        // Clients never slow this down: only a starved event loop can fill the handoff
+        const Batch batch = std::make_shared<const std::vector<std::uint8_t>>(open_.begin(), open_.begin() + openBytes_);
+        if (!handoff_.tryPush(batch)) {
+            ++handoffStalls_;
+            do {
+                wake();
+                std::this_thread::yield();
+            } while (!handoff_.tryPush(batch));
+        }
+        wake();
+    }
+    ++nextBatch_;
+    openCount_ = 0;
+    openBytes_ = wire::BatchHeader::SIZE;
+}
+
+TcpPublisher::Stats TcpPublisher::getStats() const noexcept {
+    Stats stats;
+    stats.messages = messages_;
+    stats.batches = nextBatch_;
+    stats.bytesSent = bytesSent_.load(std::memory_order_relaxed);
+    stats.sendCalls = sendCalls_.load(std::memory_order_relaxed);
+    stats.handoffStalls = handoffStalls_;
+    stats.accepted = accepted_.load(std::memory_order_relaxed);
+    stats.slowDisconnects = slowDisconnects_.load(std::memory_order_relaxed);
+    stats.closedByClient = closedByClient_.load(std::memory_order_relaxed);
+    stats.clients = clients_.load(std::memory_order_acquire);
+    return stats;
+}
+
+void TcpPublisher::wake() noexcept {
+#if defined(__linux__)
+    const std::uint64_t one = 1;
+    (void)!::write(wakeFd_, &one, sizeof(one));
+#endif
+}
+
+void TcpPublisher::runLoop() {
+#if defined(__linux__)
+    std::unordered_map<int, Client> clients;
+
+    const auto closeClient = [&](int fd) {
+        ::close(fd);  // Also drops it from the epoll set
+        clients.erase(fd);
+        clients_.store(clients.size(), std::memory_order_release);
+    };
+
+    const auto armWrite = [&](Client& client, bool armed) {
+        if (client.writeArmed != armed) {
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | (armed ? EPOLLOUT : 0u);
+            event.data.fd = client.fd;
+            ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, client.fd, &event);
+            client.writeArmed = armed;
+        }
+    };
+
+    // Gather as much of the queue as fits in one call; false when the connection is dead
+    const auto sendQueued = [&](Client& client) {
+        while (!client.queue.empty()) {
+            iovec iov[MAX_IOV];
+            const std::size_t parts = std::min(client.queue.size(), MAX_IOV);
+            for (std::size_t i = 0; i < parts; ++i) {
+                const std::size_t skip = i == 0 ? client.sentOfFront : 0;
+                iov[i].iov_base = const_cast<std::uint8_t*>(client.queue[i]->data() + skip);
+                iov[i].iov_len = client.queue[i]->size() - skip;
+            }
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = parts;
+            const int flags = MSG_DONTWAIT | MSG_NOSIGNAL | (client.zeroCopy ? MSG_ZEROCOPY : 0);
+            const ssize_t sent = ::sendmsg(client.fd, &message, flags);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    armWrite(client, true);
+                    return true;
+                }
+                if (errno == ENOBUFS && client.zeroCopy) {
+                    client.zeroCopy = false;  // Out of optmem for pinned pages; copy from now on
+                    continue;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            sendCalls_.fetch_add(1, std::memory_order_relaxed);
+            bytesSent_.fetch_add(static_cast<std::uint64_t>(sent), std::memory_order_relaxed);
+
+            // Pages handed to the kernel stay pinned until it reports this send complete
+            if (client.zeroCopy) {
+                std::size_t covered = 0;
+                for (std::size_t i = 0; i < parts && covered < static_cast<std::size_t>(sent); ++i) {
+                    client.awaitingCompletion.emplace_back(client.nextZeroCopyId, client.queue[i]);
+                    covered += iov[i].iov_len;
+                }
+                ++client.nextZeroCopyId;
+            }
+
+            auto remaining = static_cast<std::size_t>(sent);
+            client.queuedBytes -= remaining;
+            while (remaining > 0) {
+                const std::size_t left = client.queue.front()->size() - client.sentOfFront;
+                if (remaining < left) {
+                    client.sentOfFront += remaining;
+                    break;
+                }
+                remaining -= left;
+                client.queue.pop_front();
+                client.sentOfFront = 0;
+            }
+        }
+        armWrite(client, false);
+        return true;
+    };
+
+    // MSG_ZEROCOPY completions arrive on the error queue as [lo, hi] ranges of send ids
+    const auto reapCompletions = [&](Client& client) {
+        for (;;) {
+            char control[128];
+            msghdr message{};
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            if (::recvmsg(client.fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                return;
+            }
+            for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+                if (header->cmsg_level != SOL_IP || header->cmsg_type != IP_RECVERR) {
+                    continue;
+                }
+                sock_extended_err error{};
+                std::memcpy(&error, CMSG_DATA(header), sizeof(error));
+                if (error.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                    continue;
+                }
+                while (!client.awaitingCompletion.empty() &&
+                       static_cast<std::int32_t>(client.awaitingCompletion.front().first - error.ee_data) <= 0) {
+                    client.awaitingCompletion.pop_front();
+                }
+            }
+        }
+    };
+
+    const auto acceptClients = [&] {
+        for (;;) {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            Client client;
+            client.fd = fd;
+            client.zeroCopy = config_.zeroCopy && ::setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = fd;
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+                ::close(fd);
+                continue;
+            }
+            clients.emplace(fd, std::move(client));
+            clients_.store(clients.size(), std::memory_order_release);
+            accepted_.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // Queue every sealed batch on every client (dropping the ones too far behind), then send
+    const auto fanOut = [&] {
+        std::uint64_t counter = 0;
+        (void)!::read(wakeFd_, &counter, sizeof(counter));
+        Batch batch;
+        while (handoff_.tryPop(batch)) {
+            for (auto it = clients.begin(); it != clients.end();) {
+                auto& client = it->second;
+                if (client.queuedBytes + batch->size() > config_.maxQueuedBytes) {
+                    slowDisconnects_.fetch_add(1, std::memory_order_relaxed);
+                    ::close(client.fd);
+                    it = clients.erase(it);
+                    continue;
+                }
+                client.queue.push_back(batch);
+                client.queuedBytes += batch->size();
+                ++it;
+            }
+        }
+        clients_.store(clients.size(), std::memory_order_release);
+
+        std::vector<int> dead;
+        for (auto& [fd, client] : clients) {
+            if (!client.writeArmed && !sendQueued(client)) {
+                dead.push_back(fd);
+            }
+        }
+        for (const int fd : dead) {
+            closeClient(fd);
+        }
+    };
+
+    epoll_event events[MAX_EVENTS];
+    std::uint64_t deadline = 0;
+    for (;;) {
+        if (stopping_.load(std::memory_order_acquire)) {
+            if (deadline == 0) {
+                deadline = steadyNowNs() + SHUTDOWN_GRACE_NS;
+            }
+            const bool drained = handoff_.empty() && std::all_of(clients.begin(), clients.end(), [](const auto& entry) {
+                return entry.second.queue.empty();
+            });
+            if (drained || steadyNowNs() >= deadline) {
+                break;
+            }
+        }
+
+        const int ready = ::epoll_wait(epollFd_, events, MAX_EVENTS, deadline == 0 ? -1 : 10);
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            const auto mask = events[i].events;
+            if (fd == listenFd_) {
+                acceptClients();
+                continue;
+            }
+            if (fd == wakeFd_) {
+                fanOut();
+                continue;
+            }
+
+            const auto found = clients.find(fd);
+            if (found == clients.end()) {
+                continue;  // Closed earlier in this batch of events
+            }
+            auto& client = found->second;
+            const bool zeroCopyErrors = client.zeroCopy || !client.awaitingCompletion.empty();
+            if ((mask & EPOLLERR) != 0 && zeroCopyErrors) {
+                reapCompletions(client);
+                int error = 0;
+                socklen_t length = sizeof(error);
+                if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+                    closeClient(fd);
+                    continue;
+                }
+            }
+            if ((mask & (EPOLLHUP | EPOLLRDHUP)) != 0 || ((mask & EPOLLERR) != 0 && !zeroCopyErrors)) {
+                closedByClient_.fetch_add(1, std::memory_order_relaxed);
+                closeClient(fd);
+                continue;
+            }
+            if ((mask & EPOLLIN) != 0) {
+                // Subscribers never send; anything readable is either noise or end of stream
+                char discard[256];
+                const ssize_t received = ::recv(fd, discard, sizeof(discard), MSG_DONTWAIT);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    closedByClient_.fetch_add(1, std::memory_order_relaxed);
+                    closeClient(fd);
+                    continue;
+                }
+            }
+            if ((mask & EPOLLOUT) != 0 && !sendQueued(client)) {
+                closeClient(fd);
+            }
+        }
+    }
+
+    for (const auto& [fd, client] : clients) {
+        ::close(fd);
+    }
+    clients_.store(0, std::memory_order_release);
+#endif
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Streams decoded trades to TCP subscribers in batches (see wire::BatchHeader)
+ *
+ * The decode thread packs trades into batches of 40-byte frames and hands
+ * each sealed batch to one epoll event-loop thread, which owns every
+ * connection. A batch is shared by all clients' send queues and goes out
+ * with one writev (or MSG_ZEROCOPY sendmsg) per client per wakeup. A
+ * client whose queue grows past maxQueuedBytes is disconnected, so a slow
+ * consumer never holds back the others or the decoder. Linux only;
+ * listening() is false elsewhere.
+ */
+class TcpPublisher {
+public:
+    struct Config {
+        std::string bindAddress{"127.0.0.1"};
+        std::uint16_t port{0};                     // 0 = any free port (see port())
+        std::size_t batchMessages{256};            // Frames per batch before publish() seals it
+        std::size_t maxQueuedBytes{16 << 20};      // Per-client backlog before it is dropped as slow
+        std::size_t handoffBatches{1024};          // Sealed batches in flight to the event loop
+        bool zeroCopy{false};                      // MSG_ZEROCOPY sends (pays off for large batches on a real NIC)
+
+        Config() = default;
+    };
+
+    struct Stats {
+        std::uint64_t messages{0};        // Trades published
+        std::uint64_t batches{0};         // Batches sealed
+        std::uint64_t bytesSent{0};       // Summed over clients
+        std::uint64_t sendCalls{0};       // writev/sendmsg calls
+        std::uint64_t handoffStalls{0};   // Seals that waited for the event loop
+        std::uint64_t accepted{0};
+        std::uint64_t slowDisconnects{0};
+        std::uint64_t closedByClient{0};
+        std::size_t clients{0};           // Currently connected
+    };
+
+    TcpPublisher() : TcpPublisher(Config{}) {}
+    explicit TcpPublisher(Config config);
+
+    TcpPublisher(const TcpPublisher&) = delete;
+    TcpPublisher& operator=(const TcpPublisher&) = delete;
+
+    /**
+     * Seal the open batch, let the event loop drain what it can and close every connection
+     */
+    ~TcpPublisher();
+
+    /**
+     * Append one trade (decode thread only); seals the batch when it is full
+     */
+    void publish(const TradeMessage& message) {
+        TradeCodec::serialize(message, open_.data() + openBytes_);
+        openBytes_ += ProtocolConstants::MESSAGE_SIZE;
+        if (++openCount_ == config_.batchMessages) {
+            flush();
+        }
+    }
+
+    template<typename Container>
+    void publish(const Container& messages) {
+        for (const auto& message : messages) {
+            publish(message);
+        }
+    }
+
+    /**
+     * Seal the open batch now, even if it is not full (decode thread only; call at the end of each decode burst)
+     */
+    void flush();
+
+    [[nodiscard]] bool listening() const noexcept { return listenFd_ >= 0; }
+    [[nodiscard]] std::uint16_t port() const noexcept { return port_; }
+    [[nodiscard]] std::size_t clientCount() const noexcept { return clients_.load(std::memory_order_acquire); }
+    [[nodiscard]] Stats getStats() const noexcept;  // Decode thread
+    [[nodiscard]] const Config& getConfig() const noexcept { return config_; }
+
+private:
+    using Batch = std::shared_ptr<const std::vector<std::uint8_t>>;
+    struct Client;
+
+    Config config_;
+    int listenFd_{-1};
+    int epollFd_{-1};
+    int wakeFd_{-1};
+    std::uint16_t port_{0};
+
+    // Decode-thread state
+    std::vector<std::uint8_t> open_;
+    std::size_t openBytes_{0};
+    std::size_t openCount_{0};
+    std::uint64_t nextBatch_{0};
+    std::uint64_t messages_{0};
+    std::uint64_t handoffStalls_{0};
+
+    SpscQueue<Batch> handoff_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::size_t> clients_{0};
+
+    // Event-loop counters, read by getStats()
+    std::atomic<std::uint64_t> bytesSent_{0};
+    std::atomic<std::uint64_t> sendCalls_{0};
+    std::atomic<std::uint64_t> accepted_{0};
+    std::atomic<std::uint64_t> slowDisconnects_{0};
+    std::atomic<std::uint64_t> closedByClient_{0};
+
+    std::thread loop_;
+
+    void wake() noexcept;
+    void runLoop();
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,157 @@
+#include "TcpSubscriber.h"
+#include <cstring>
+#include <utility>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt {
+
+namespace {
+
+constexpr std::size_t RECEIVE_BUFFER_BYTES = 1 << 20;
+constexpr std::uint32_t MAX_BATCH_MESSAGES = (RECEIVE_BUFFER_BYTES - wire::BatchHeader::SIZE) / ProtocolConstants::MESSAGE_SIZE;
+
+} // namespace
+
+TcpSubscriber::TcpSubscriber(int fd) : fd_{fd}, buffer_(RECEIVE_BUFFER_BYTES) {}
+
+std::optional<TcpSubscriber> TcpSubscriber::connect(const std::string& host, std::uint16_t port) {
+#if defined(__linux__)
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* resolved = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &resolved) != 0) {
+        return std::nullopt;
+    }
+    int fd = -1;
+    for (const addrinfo* candidate = resolved; candidate != nullptr && fd < 0; candidate = candidate->ai_next) {
+        fd = ::socket(candidate->ai_family, candidate->ai_socktype | SOCK_CLOEXEC, candidate->ai_protocol);
+        if (fd >= 0 && ::connect(fd, candidate->ai_addr, candidate->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(resolved);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return TcpSubscriber{fd};
+#else
+    (void)host;
+    (void)port;
+    return std::nullopt;
+#endif
+}
+
+TcpSubscriber::TcpSubscriber(TcpSubscriber&& other) noexcept
+    : fd_{std::exchange(other.fd_, -1)},
+      buffer_{std::move(other.buffer_)},
+      readOffset_{other.readOffset_},
+      writeOffset_{other.writeOffset_},
+      lastBatch_{other.lastBatch_},
+      lastSendTimeNs_{other.lastSendTimeNs_},
+      stats_{other.stats_} {}
+
+TcpSubscriber& TcpSubscriber::operator=(TcpSubscriber&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = std::exchange(other.fd_, -1);
+        buffer_ = std::move(other.buffer_);
+        readOffset_ = other.readOffset_;
+        writeOffset_ = other.writeOffset_;
+        lastBatch_ = other.lastBatch_;
+        lastSendTimeNs_ = other.lastSendTimeNs_;
+        stats_ = other.stats_;
+    }
+    return *this;
+}
+
+TcpSubscriber::~TcpSubscriber() {
+    close();
+}
+
+void TcpSubscriber::close() noexcept {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+}
+
+bool TcpSubscriber::fill(bool wait) {
+#if defined(__linux__)
+    if (fd_ < 0) {
+        return false;
+    }
+    // Slide the partial batch to the front so a whole one always fits
+    if (readOffset_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + readOffset_, writeOffset_ - readOffset_);
+        writeOffset_ -= readOffset_;
+        readOffset_ = 0;
+    }
+    for (;;) {
+        const ssize_t received = ::recv(fd_, buffer_.data() + writeOffset_, buffer_.size() - writeOffset_,
+                                        wait ? 0 : MSG_DONTWAIT);
+        if (received > 0) {
+            writeOffset_ += static_cast<std::size_t>(received);
+            stats_.bytes += static_cast<std::uint64_t>(received);
+            return true;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        close();
+        return false;
+    }
+#else
+    (void)wait;
+    return false;
+#endif
+}
+
+const std::uint8_t* TcpSubscriber::nextBatch(std::uint32_t& count) noexcept {
+    const std::size_t available = writeOffset_ - readOffset_;
+    if (available < wire::BatchHeader::SIZE) {
+        return nullptr;
+    }
+    const std::uint8_t* header = buffer_.data() + readOffset_;
+    count = wire::BatchHeader::Count::load(header);
+    if (wire::BatchHeader::Magic::load(header) != wire::BatchHeader::MAGIC || count > MAX_BATCH_MESSAGES) {
+        ++stats_.protocolErrors;
+        close();
+        readOffset_ = writeOffset_ = 0;
+        return nullptr;
+    }
+    const std::size_t batchBytes = wire::BatchHeader::SIZE + std::size_t{count} * ProtocolConstants::MESSAGE_SIZE;
+    if (available < batchBytes) {
+        return nullptr;
+    }
+
+    const auto batch = wire::BatchHeader::Batch::load(header);
+    if (stats_.batches > 0 && batch != lastBatch_ + 1) {
+        ++stats_.batchGaps;
+    }
+    lastBatch_ = batch;
+    lastSendTimeNs_ = wire::BatchHeader::SendTime::load(header);
+    ++stats_.batches;
+    stats_.messages += count;
+    readOffset_ += batchBytes;
+    return header + wire::BatchHeader::SIZE;
+}
+
+} // namespace nse::mtbt
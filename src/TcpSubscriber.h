@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Client side of TcpPublisher: connects, reassembles batches and hands out trades
+ *
+ * receive() reads whatever the socket has (waiting for it, or not), then
+ * calls the handler for every trade of every complete batch. Batch numbers
+ * are checked for continuity, and each batch's send time is kept so callers
+ * can measure publish-to-receive latency. Linux only; connect() returns
+ * nullopt elsewhere.
+ */
+class TcpSubscriber {
+public:
+    struct Stats {
+        std::uint64_t messages{0};
+        std::uint64_t batches{0};
+        std::uint64_t bytes{0};
+        std::uint64_t batchGaps{0};         // Batch number jumps after the first batch
+        std::uint64_t protocolErrors{0};    // Bad magic or oversized count (the connection is closed)
+    };
+
+    [[nodiscard]] static std::optional<TcpSubscriber> connect(const std::string& host, std::uint16_t port);
+
+    TcpSubscriber(const TcpSubscriber&) = delete;
+    TcpSubscriber& operator=(const TcpSubscriber&) = delete;
+    TcpSubscriber(TcpSubscriber&& other) noexcept;
+    TcpSubscriber& operator=(TcpSubscriber&& other) noexcept;
+    ~TcpSubscriber();
+
+    /**
+     * Deliver every complete buffered batch to handler(const TradeMessage&)
+     *
+     * With wait set, blocks until at least one batch is complete or the
+     * publisher goes away. Returns the number of trades delivered; 0 with
+     * connected() false means the stream has ended.
+     */
+    template<typename Handler>
+    std::size_t receive(Handler&& handler, bool wait = true) {
+        std::size_t delivered = 0;
+        do {
+            if (!fill(wait && delivered == 0)) {
+                break;
+            }
+            std::uint32_t count = 0;
+            while (const std::uint8_t* frame = nextBatch(count)) {
+                for (std::uint32_t i = 0; i < count; ++i, frame += ProtocolConstants::MESSAGE_SIZE) {
+                    handler(TradeCodec::parse(frame));
+                }
+                delivered += count;
+            }
+        } while (wait && delivered == 0 && connected());
+        return delivered;
+    }
+
+    /**
+     * Close the connection; the publisher sees the client leave
+     */
+    void close() noexcept;
+
+    [[nodiscard]] bool connected() const noexcept { return fd_ >= 0; }
+    [[nodiscard]] int fd() const noexcept { return fd_; }   // For callers multiplexing many subscribers
+    [[nodiscard]] std::uint64_t lastBatch() const noexcept { return lastBatch_; }
+    [[nodiscard]] std::uint64_t lastSendTimeNs() const noexcept { return lastSendTimeNs_; }
+    [[nodiscard]] const Stats& getStats() const noexcept { return stats_; }
+
+private:
+    explicit TcpSubscriber(int fd);
+
+    int fd_{-1};
+    std::vector<std::uint8_t> buffer_;
+    std::size_t readOffset_{0};
+    std::size_t writeOffset_{0};
+    std::uint64_t lastBatch_{0};
+    std::uint64_t lastSendTimeNs_{0};
+    Stats stats_;
+
+    /**
+     * Read what the socket has into the buffer; false once the connection is gone
+     */
+    bool fill(bool wait);
+
+    /**
+     * Frames of the next complete batch, nullptr when none is buffered
+     */
+    [[nodiscard]] const std::uint8_t* nextBatch(std::uint32_t& count) noexcept;
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,90 @@
+#include "TraceLogger.h"
+#include <chrono>
+#include <iomanip>
+
+namespace nse::mtbt {
+
+namespace {
+
+std::string_view eventName(TraceLogger::Event event) noexcept {
+    switch (event) {
+        case TraceLogger::Event::DECODED: return "DECODED";
+        case TraceLogger::Event::INVALID: return "INVALID";
+        case TraceLogger::Event::PROTOCOL_ERROR: return "PROTOCOL_ERROR";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace
+
+TraceLogger::TraceLogger(Config config)
+    : config_{std::move(config)}, output_{config_.path, std::ios::trunc}, ring_{config_.ringCapacity} {
+    config_.sampleEvery = std::max<std::uint64_t>(config_.sampleEvery, 1);
+    sampleCounter_ = config_.sampleEvery - 1; // Trace the first eligible frame
+    worker_ = std::thread{[this] { run(); }};
+}
+
+TraceLogger::~TraceLogger() {
+    stopping_.store(true, std::memory_order_release);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    output_ << "# " << writtenCount() << " frames traced, " << droppedCount() << " dropped (ring full)\n";
+}
+
+void TraceLogger::run() {
+    Record entry;
+    for (;;) {
+        if (ring_.tryPop(entry)) {
+            format(entry);
+            written_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            // Producer has stopped: whatever is left is final
+            while (ring_.tryPop(entry)) {
+                format(entry);
+                written_.fetch_add(1, std::memory_order_relaxed);
+            }
+            output_.flush();
+            return;
+        }
+        // Idle: back off rather than spin on a core the decoder may need
+        std::this_thread::sleep_for(std::chrono::microseconds{200});
+    }
+}
+
+void TraceLogger::format(const Record& entry) {
+    output_ << "[" << eventName(entry.event) << "] offset " << entry.captureOffset << "\n"
+            << "  Raw bytes:    " << BinaryUtils::toHex(entry.frame, entry.length) << "\n";
+    if (entry.length < ProtocolConstants::MESSAGE_SIZE) {
+        output_ << "  Truncated frame (" << static_cast<unsigned>(entry.length) << " bytes)\n\n";
+        return;
+    }
+    
+    const TradeMessage message = TradeCodec::parse(entry.frame);
+    const auto rejection = [&]() -> std::string {
+        switch (entry.reason) {
+            case Reason::NONE: return "Unknown error";
+            // Field rules are a pure function of the frame, so re-running them names the same rule
+            case Reason::FIELD_RULES: return message.validate().errorMessage.value_or("Unknown error");
+            case Reason::INSTRUMENT_LIMITS: return "Outside instrument limits";
+            case Reason::CHECKSUM: return "CRC32 mismatch";
+            case Reason::FORMAT: return "Malformed frame";
+        }
+        return "Unknown error";
+    };
+    
+    output_ << "  Token bytes:  " << BinaryUtils::toHex(entry.frame + ProtocolConstants::OFFSET_SYMBOL_TOKEN, 4) << "\n"
+            << "  Token binary: " << BinaryUtils::toBinary(message.symbolToken) << "\n"
+            << "  Symbol:       " << message.getSymbolName() << " (" << message.symbolToken << ")\n"
+            << "  Fields:       SEQ=" << message.sequenceNumber << " TS=" << message.timestamp
+            << " PRICE=₹" << std::fixed << std::setprecision(2) << message.getPriceInRupees()
+            << " QTY=" << message.quantity << " SIDE=" << formatTradeSide(message.side) << "\n";
+    if (entry.event != Event::DECODED) {
+        output_ << "  Rejected:     " << rejection() << "\n";
+    }
+    output_ << "\n";
+}
+
+} // namespace nse::mtbt
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace nse::mtbt {
+
+/**
+ * Asynchronous frame tracer for the decode loop
+ *
+ * The hot path only copies the raw frame and an event id into a lock-free
+ * ring (dropping, never blocking, when it is full). A background thread
+ * does the expensive part: hex dumps, bit fields, symbol lookup and file I/O.
+ * Sampling keeps the ring small on full-rate feeds.
+ */
+class TraceLogger {
+public:
+    enum class Event : std::uint8_t {
+        DECODED = 0,         // Parsed and valid
+        INVALID = 1,         // Parsed but failed validation
+        PROTOCOL_ERROR = 2   // Could not be parsed at this byte offset
+    };
+
+    /**
+     * Why the decoder rejected a frame, as decided on the hot path
+     */
+    enum class Reason : std::uint8_t {
+        NONE = 0,              // Not rejected
+        FIELD_RULES = 1,       // TradeMessage::validate() failed
+        INSTRUMENT_LIMITS = 2, // Passed the exchange rules, outside the symbol's limits
+        CHECKSUM = 3,          // CRC32 mismatch at CHECKSUM level
+        FORMAT = 4             // Frame layout check failed
+    };
+
+    struct Config {
+        std::string path;                 // Trace output file
+        std::size_t ringCapacity{1 << 14};
+        std::uint64_t sampleEvery{1};     // Trace every Nth eligible frame
+        bool errorsOnly{false};           // Skip DECODED frames entirely
+
+        Config() = default;
+    };
+
+    /**
+     * One traced frame as captured by the hot path
+     */
+    struct alignas(CACHE_LINE_SIZE) Record {
+        std::uint64_t captureOffset{0};
+        Event event{Event::DECODED};
+        Reason reason{Reason::NONE};
+        std::uint8_t length{0};
+        std::uint8_t frame[ProtocolConstants::MESSAGE_SIZE]{};
+    };
+
+    explicit TraceLogger(Config config);
+    ~TraceLogger();
+
+    TraceLogger(const TraceLogger&) = delete;
+    TraceLogger& operator=(const TraceLogger&) = delete;
+
+    [[nodiscard]] bool isOpen() const noexcept { return output_.is_open(); }
+
+    /**
+     * Hot path: sample, copy up to one frame, enqueue
+     */
+    void record(Event event, Reason reason, std::uint64_t captureOffset, const std::uint8_t* data, std::size_t available) noexcept {
+        if (config_.errorsOnly && event == Event::DECODED) {
+            return;
+        }
+        if (++sampleCounter_ < config_.sampleEvery) {
+            return;
+        }
+        sampleCounter_ = 0;
+        
+        Record entry;
+        entry.captureOffset = captureOffset;
+        entry.event = event;
+        entry.reason = reason;
+        entry.length = static_cast<std::uint8_t>(std::min<std::size_t>(available, ProtocolConstants::MESSAGE_SIZE));
+        std::memcpy(entry.frame, data, entry.length);
+        if (!ring_.tryPush(entry)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] std::uint64_t writtenCount() const noexcept { return written_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t droppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    Config config_;
+    std::ofstream output_;
+    SpscQueue<Record> ring_;
+    std::uint64_t sampleCounter_{0};      // Producer-only
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread worker_;
+
+    void run();
+    void format(const Record& entry);
+};
+
+} // namespace nse::mtbt
@@ -0,0 +1,293 @@
+#include "TradeHistory.h"
+#include "Platform.h"
+#include <algorithm>
+#include <limits>
+
+namespace nse::mtbt {
+
+namespace {
+
+void merge(TradeHistory::Aggregate& into, std::uint64_t trades, std::uint64_t volume, VwapNumerator priceVolume,
+           std::uint32_t high, std::uint32_t low) noexcept {
+    if (trades == 0) {
+        return;
+    }
+    into.high = into.tradeCount == 0 ? high : std::max(into.high, high);
+    into.low = into.tradeCount == 0 ? low : std::min(into.low, low);
+    into.tradeCount += trades;
+    into.volume += volume;
+    into.priceVolume += priceVolume;
+}
+
+/**
+ * Scalar range scan over delta columns; the reference for the AVX2 version
+ */
+void scanScalar(const std::uint32_t* timestamps, const std::int16_t* prices, const std::uint32_t* quantities,
+                std::size_t count, std::uint32_t fromDelta, std::uint32_t toDelta, std::uint32_t basePrice,
+                TradeHistory::Aggregate& result) noexcept {
+    std::uint64_t trades = 0;
+    std::uint64_t volume = 0;
+    VwapNumerator priceVolume = 0;
+    std::uint32_t high = 0;
+    std::uint32_t low = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (timestamps[i] < fromDelta || timestamps[i] > toDelta) {
+            continue;
+        }
+        const auto price = static_cast<std::uint32_t>(static_cast<std::int64_t>(basePrice) + prices[i]);
+        const std::uint32_t quantity = quantities[i] & 0x7FFF'FFFFu;
+        ++trades;
+        volume += quantity;
+        priceVolume += static_cast<std::uint64_t>(price) * quantity;
+        high = std::max(high, price);
+        low = std::min(low, price);
+    }
+    merge(result, trades, volume, priceVolume, high, low);
+}
+
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+/**
+ * 8 trades per step: range mask from the timestamp column, then masked sums and min/max
+ */
+__attribute__((target("avx2")))
+void scanAvx2(const std::uint32_t* timestamps, const std::int16_t* prices, const std::uint32_t* quantities,
+              std::size_t count, std::uint32_t fromDelta, std::uint32_t toDelta, std::uint32_t basePrice,
+              TradeHistory::Aggregate& result) noexcept {
+    // Unsigned compares via the sign-flip trick
+    const __m256i signFlip = _mm256_set1_epi32(static_cast<int>(0x8000'0000u));
+    const __m256i lower = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(fromDelta)), signFlip);
+    const __m256i upper = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(toDelta)), signFlip);
+    const __m256i quantityMask = _mm256_set1_epi32(0x7FFF'FFFF);
+    const __m256i base = _mm256_set1_epi32(static_cast<int>(basePrice));
+
+    __m256i volume = _mm256_setzero_si256();        // 4 x u64
+    __m256i priceVolume = _mm256_setzero_si256();   // 4 x u64, flushed per block (fits: 1024 * 1e14)
+    __m256i high = _mm256_setzero_si256();
+    __m256i low = _mm256_set1_epi32(-1);
+    std::uint64_t trades = 0;
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i ts = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps + i)), signFlip);
+        const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lower, ts), _mm256_cmpgt_epi32(ts, upper));
+        const __m256i inside = _mm256_xor_si256(outside, _mm256_set1_epi32(-1));
+        const int laneMask = _mm256_movemask_ps(_mm256_castsi256_ps(inside));
+        if (laneMask == 0) {
+            continue;
+        }
+        trades += static_cast<std::uint64_t>(__builtin_popcount(static_cast<unsigned>(laneMask)));
+
+        const __m256i quantity = _mm256_and_si256(
+            _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(quantities + i)), quantityMask), inside);
+        const __m256i price = _mm256_add_epi32(base, _mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(prices + i))));
+
+        volume = _mm256_add_epi64(volume, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(quantity)));
+        volume = _mm256_add_epi64(volume, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(quantity, 1)));
+        priceVolume = _mm256_add_epi64(priceVolume, _mm256_mul_epu32(price, quantity));
+        priceVolume = _mm256_add_epi64(priceVolume, _mm256_mul_epu32(_mm256_srli_epi64(price, 32),
+                                                                     _mm256_srli_epi64(quantity, 32)));
+        high = _mm256_max_epu32(high, _mm256_and_si256(price, inside));
+        low = _mm256_min_epu32(low, _mm256_or_si256(price, outside));
+    }
+
+    alignas(32) std::uint64_t volumeLanes[4];
+    alignas(32) std::uint64_t priceVolumeLanes[4];
+    alignas(32) std::uint32_t highLanes[8];
+    alignas(32) std::uint32_t lowLanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(volumeLanes), volume);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(priceVolumeLanes), priceVolume);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(highLanes), high);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lowLanes), low);
+
+    merge(result, trades,
+          volumeLanes[0] + volumeLanes[1] + volumeLanes[2] + volumeLanes[3],
+          static_cast<VwapNumerator>(priceVolumeLanes[0]) + priceVolumeLanes[1] + priceVolumeLanes[2] + priceVolumeLanes[3],
+          *std::max_element(highLanes, highLanes + 8), *std::min_element(lowLanes, lowLanes + 8));
+
+    scanScalar(timestamps + i, prices + i, quantities + i, count - i, fromDelta, toDelta, basePrice, result);
+}
+#endif
+
+} // namespace
+
+void TradeHistory::Block::resize(std::uint32_t newCapacity) {
+    auto grownWords = std::unique_ptr<std::uint32_t[]>(new std::uint32_t[3 * std::size_t{newCapacity}]);
+    auto grownPrices = std::unique_ptr<std::int16_t[]>(new std::int16_t[newCapacity]);
+    if (count > 0) {
+        for (std::size_t column = 0; column < 3; ++column) {
+            std::copy_n(words.get() + column * capacity, count, grownWords.get() + column * newCapacity);
+        }
+        std::copy_n(prices.get(), count, grownPrices.get());
+    }
+    words = std::move(grownWords);
+    prices = std::move(grownPrices);
+    capacity = newCapacity;
+}
+
+TradeMessage TradeHistory::Block::decode(std::uint32_t symbolToken, std::size_t i) const noexcept {
+    const std::uint32_t quantity = quantityAndSide()[i];
+    TradeMessage message;
+    message.sequenceNumber = baseSequence + sequenceDelta()[i];
+    message.symbolToken = symbolToken;
+    message.timestamp = baseTimestamp + timestampDelta()[i];
+    message.priceInPaisa = static_cast<std::uint32_t>(static_cast<std::int64_t>(basePrice) + priceDelta()[i]);
+    message.quantity = quantity & ~SELL_BIT;
+    message.side = (quantity & SELL_BIT) ? TradeSide::SELL : TradeSide::BUY;
+    return message;
+}
+
+void TradeHistory::append(const TradeMessage& message) {
+    const std::uint32_t symbolId = symbols_.getOrAssign(message.symbolToken);
+    if (symbolId == SymbolIndex::INVALID_ID || message.quantity >= SELL_BIT) {
+        return;
+    }
+    if (symbolId >= chains_.size()) {
+        chains_.resize(symbolId + 1);
+    }
+    auto& chain = chains_[symbolId];
+
+    // Seal the tail block when it is full or this trade's deltas do not fit
+    Block* tail = chain.empty() ? nullptr : &chain.back();
+    const std::int64_t priceDelta = tail ? static_cast<std::int64_t>(message.priceInPaisa) - tail->basePrice : 0;
+    const bool fits = tail && tail->count < BLOCK_TRADES &&
+                      message.timestamp >= tail->baseTimestamp &&
+                      message.timestamp - tail->baseTimestamp <= std::numeric_limits<std::uint32_t>::max() &&
+                      priceDelta >= std::numeric_limits<std::int16_t>::min() &&
+                      priceDelta <= std::numeric_limits<std::int16_t>::max();
+    if (!fits) {
+        // A block sealed early keeps only what it holds
+        if (tail && tail->count < tail->capacity) {
+            tail->resize(tail->count);
+        }
+        Block& block = chain.emplace_back();
+        block.baseTimestamp = message.timestamp;
+        block.basePrice = message.priceInPaisa;
+        block.baseSequence = message.sequenceNumber;
+        block.minTimestamp = message.timestamp;
+        block.maxTimestamp = message.timestamp;
+        block.resize(INITIAL_BLOCK_TRADES);
+    } else if (tail->count == tail->capacity) {
+        tail->resize(std::min<std::uint32_t>(tail->capacity * 2, BLOCK_TRADES));
+    }
+
+    Block& block = chain.back();
+    const std::uint32_t i = block.count++;
+    block.timestampDelta()[i] = static_cast<std::uint32_t>(message.timestamp - block.baseTimestamp);
+    block.sequenceDelta()[i] = message.sequenceNumber - block.baseSequence;
+    block.priceDelta()[i] = static_cast<std::int16_t>(static_cast<std::int64_t>(message.priceInPaisa) - block.basePrice);
+    block.quantityAndSide()[i] = message.quantity | (message.side == TradeSide::SELL ? SELL_BIT : 0u);
+    block.minTimestamp = std::min(block.minTimestamp, message.timestamp);
+    block.maxTimestamp = std::max(block.maxTimestamp, message.timestamp);
+    merge(block.totals, 1, message.quantity, static_cast<VwapNumerator>(message.priceInPaisa) * message.quantity,
+          message.priceInPaisa, message.priceInPaisa);
+    ++trades_;
+}
+
+const TradeHistory::Chain* TradeHistory::chainFor(std::uint32_t token) const noexcept {
+    const std::uint32_t symbolId = symbols_.find(token);
+    return symbolId < chains_.size() ? &chains_[symbolId] : nullptr;
+}
+
+std::size_t TradeHistory::lastTrades(std::uint32_t token, std::size_t count, std::vector<TradeMessage>& out) const {
+    const Chain* chain = chainFor(token);
+    if (!chain) {
+        return 0;
+    }
+
+    // Find the block holding the first wanted trade, then decode forwards
+    std::size_t blockIndex = chain->size();
+    std::size_t skip = 0;
+    std::size_t available = 0;
+    while (blockIndex > 0 && available < count) {
+        --blockIndex;
+        available += (*chain)[blockIndex].count;
+    }
+    if (available > count) {
+        skip = available - count;
+    }
+
+    const std::size_t before = out.size();
+    out.reserve(before + std::min(count, available));
+    for (; blockIndex < chain->size(); ++blockIndex) {
+        const Block& block = (*chain)[blockIndex];
+        for (std::size_t i = skip; i < block.count; ++i) {
+            out.push_back(block.decode(token, i));
+        }
+        skip = 0;
+    }
+    return out.size() - before;
+}
+
+std::size_t TradeHistory::tradesBetween(std::uint32_t token, std::uint64_t from, std::uint64_t to,
+                                        std::vector<TradeMessage>& out) const {
+    const Chain* chain = chainFor(token);
+    if (!chain || from > to) {
+        return 0;
+    }
+    const std::size_t before = out.size();
+    for (const Block& block : *chain) {
+        if (block.maxTimestamp < from || block.minTimestamp > to) {
+            continue;
+        }
+        for (std::size_t i = 0; i < block.count; ++i) {
+            const std::uint64_t timestamp = block.baseTimestamp + block.timestampDelta()[i];
+            if (timestamp >= from && timestamp <= to) {
+                out.push_back(block.decode(token, i));
+            }
+        }
+    }
+    return out.size() - before;
+}
+
+void TradeHistory::aggregateBlock(const Block& block, std::uint64_t from, std::uint64_t to, Aggregate& result) noexcept {
+    // Range in block-relative units, clamped to what the delta column can hold
+    const std::uint32_t fromDelta = from <= block.baseTimestamp ? 0
+        : static_cast<std::uint32_t>(std::min<std::uint64_t>(from - block.baseTimestamp, std::numeric_limits<std::uint32_t>::max()));
+    const std::uint32_t toDelta = static_cast<std::uint32_t>(
+        std::min<std::uint64_t>(to - block.baseTimestamp, std::numeric_limits<std::uint32_t>::max()));
+
+#if defined(MTBT_HAVE_AVX2_DISPATCH)
+    if (cpuHasAvx2()) {
+        scanAvx2(block.timestampDelta(), block.priceDelta(), block.quantityAndSide(), block.count,
+                 fromDelta, toDelta, block.basePrice, result);
+        return;
+    }
+#endif
+    scanScalar(block.timestampDelta(), block.priceDelta(), block.quantityAndSide(), block.count,
+               fromDelta, toDelta, block.basePrice, result);
+}
+
+TradeHistory::Aggregate TradeHistory::aggregate(std::uint32_t token, std::uint64_t from, std::uint64_t to) const {
+    Aggregate result;
+    const Chain* chain = chainFor(token);
+    if (!chain || from > to) {
+        return result;
+    }
+    for (const Block& block : *chain) {
+        if (block.maxTimestamp < from || block.minTimestamp > to) {
+            continue;
+        }
+        if (block.minTimestamp >= from && block.maxTimestamp <= to) {
+            const auto& totals = block.totals;
+            merge(result, totals.tradeCount, totals.volume, totals.priceVolume, totals.high, totals.low);
+        } else {
+            aggregateBlock(block, from, to, result);
+        }
+    }
+    return result;
+}
+
+TradeHistory::Stats TradeHistory::getStats() const noexcept {
+    Stats stats;
+    stats.trades = trades_;
+    for (const auto& chain : chains_) {
+        stats.blocks += chain.size();
+        for (const Block& block : chain) {
+            stats.bytesAllocated += sizeof(Block) + std::uint64_t{block.capacity} * BYTES_PER_TRADE;
+        }
+    }
+    return stats;
+}
+
+} // namespace nse::mtbt
\ No newline at end of file
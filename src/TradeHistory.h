@@ -0,0 +1,128 @@
+#pragma once
+
+#include "BarAggregator.h"
+#include "MessageTypes.h"
+#include "SymbolIndex.h"
+#include <memory>
+#include <vector>
+
+namespace nse::mtbt {
+
+/**
+ * Compact per-symbol trade history for strategy queries
+ *
+ * Each symbol owns a chain of append-only columnar blocks. Timestamps,
+ * prices and sequence numbers are stored as deltas from the block's base
+ * values (14 bytes per trade instead of 32); a trade whose deltas do not
+ * fit seals the block and starts a new one. Block columns start small and
+ * double up to BLOCK_TRADES, and sealing trims them to the trades they
+ * hold, so sparse or volatile symbols do not pay for a full block per
+ * handful of trades. Blocks keep running totals, so range aggregates
+ * touch only the (at most two) partially covered blocks, which are
+ * scanned with AVX2 where the CPU has it.
+ */
+class TradeHistory {
+public:
+    static constexpr std::size_t BLOCK_TRADES = 1024;
+    static constexpr std::size_t INITIAL_BLOCK_TRADES = 4;
+
+    /**
+     * Aggregate over a time range
+     */
+    struct Aggregate {
+        std::uint64_t tradeCount{0};
+        std::uint64_t volume{0};
+        VwapNumerator priceVolume{0};
+        std::uint32_t high{0};
+        std::uint32_t low{0};
+
+        [[nodiscard]] double vwapInPaisa() const noexcept {
+            return volume > 0 ? static_cast<double>(priceVolume) / static_cast<double>(volume) : 0.0;
+        }
+    };
+
+    struct Stats {
+        std::uint64_t trades{0};
+        std::uint64_t blocks{0};
+        std::uint64_t bytesAllocated{0};   // Block headers and column capacity, including unfilled tails
+
+        [[nodiscard]] double bytesPerTrade() const noexcept {
+            return trades > 0 ? static_cast<double>(bytesAllocated) / static_cast<double>(trades) : 0.0;
+        }
+    };
+
+    TradeHistory() = default;
+
+    void append(const TradeMessage& message);
+
+    template<typename Container>
+    void onTrades(const Container& messages) {
+        for (const auto& message : messages) {
+            append(message);
+        }
+    }
+
+    /**
+     * Most recent trades of a token, oldest first; returns how many were written
+     */
+    std::size_t lastTrades(std::uint32_t token, std::size_t count, std::vector<TradeMessage>& out) const;
+
+    /**
+     * Trades of a token with from <= timestamp <= to, in arrival order
+     */
+    std::size_t tradesBetween(std::uint32_t token, std::uint64_t from, std::uint64_t to,
+                              std::vector<TradeMessage>& out) const;
+
+    /**
+     * Volume, VWAP numerator and high/low of a token for from <= timestamp <= to
+     */
+    [[nodiscard]] Aggregate aggregate(std::uint32_t token, std::uint64_t from, std::uint64_t to) const;
+
+    [[nodiscard]] Stats getStats() const noexcept;
+
+private:
+    static constexpr std::uint32_t SELL_BIT = 0x8000'0000u;
+
+    static constexpr std::size_t BYTES_PER_TRADE = 3 * sizeof(std::uint32_t) + sizeof(std::int16_t);
+
+    /**
+     * Up to BLOCK_TRADES trades of one symbol, column by column
+     */
+    struct Block {
+        std::uint64_t baseTimestamp{0};
+        std::uint32_t basePrice{0};
+        std::uint32_t baseSequence{0};
+        std::uint32_t count{0};
+        std::uint32_t capacity{0};
+        std::uint64_t minTimestamp{0};
+        std::uint64_t maxTimestamp{0};
+        Aggregate totals{};
+
+        // Timestamp, sequence and quantity (sell flag in the top bit) columns back to back
+        std::unique_ptr<std::uint32_t[]> words;
+        std::unique_ptr<std::int16_t[]> prices;
+
+        [[nodiscard]] std::uint32_t* timestampDelta() const noexcept { return words.get(); }
+        [[nodiscard]] std::uint32_t* sequenceDelta() const noexcept { return words.get() + capacity; }
+        [[nodiscard]] std::uint32_t* quantityAndSide() const noexcept { return words.get() + 2 * std::size_t{capacity}; }
+        [[nodiscard]] std::int16_t* priceDelta() const noexcept { return prices.get(); }
+
+        /**
+         * Move the columns to storage for exactly newCapacity trades (>= count)
+         */
+        void resize(std::uint32_t newCapacity);
+
+        [[nodiscard]] TradeMessage decode(std::uint32_t symbolToken, std::size_t i) const noexcept;
+    };
+
+    using Chain = std::vector<Block>;
+
+    SymbolIndex symbols_;
+    std::vector<Chain> chains_;   // Per dense symbol id
+    std::uint64_t trades_{0};
+
+    [[nodiscard]] const Chain* chainFor(std::uint32_t token) const noexcept;
+    static void aggregateBlock(const Block& block, std::uint64_t from, std::uint64_t to, Aggregate& result) noexcept;
+};
+
+} // namespace nse::mtbt
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "TradeRing.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nse::mtbt {
+
+std::optional<TradeRing> TradeRing::create(const std::string& name, std::size_t capacity) {
+#if defined(__linux__)
+    std::uint64_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    const std::size_t bytes = segmentBytes(rounded);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    void* region = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        return std::nullopt;
+    }
+    
+    TradeRing ring;
+    ring.mappedBytes_ = bytes;
+    ring.mask_ = rounded - 1;
+    ring.header_ = new (region) Header{};
+    ring.slots_ = new (static_cast<std::uint8_t*>(region) + sizeof(Header)) Slot[rounded];
+    ring.header_->capacity = rounded;
+    ring.header_->version = LAYOUT_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    ring.header_->magic = LAYOUT_MAGIC;
+    return ring;
+#else
+    (void)name;
+    (void)capacity;
+    return std::nullopt;
+#endif
+}
+
+std::optional<TradeRing> TradeRing::attach(const std::string& name) {
+#if defined(__linux__)
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto bytes = static_cast<std::size_t>(info.st_size);
+    void* region = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        return std::nullopt;
+    }
+    
+    TradeRing ring;
+    ring.mappedBytes_ = bytes;
+    ring.header_ = static_cast<Header*>(region);
+    ring.slots_ = reinterpret_cast<Slot*>(static_cast<std::uint8_t*>(region) + sizeof(Header));
+    if (ring.header_->magic != LAYOUT_MAGIC || ring.header_->version != LAYOUT_VERSION ||
+        segmentBytes(ring.header_->capacity) > bytes) {
+        return std::nullopt;
+    }
+    ring.mask_ = ring.header_->capacity - 1;
+    ring.next_ = ring.header_->published.load(std::memory_order_acquire);
+    return ring;
+#else
+    (void)name;
+    return std::nullopt;
+#endif
+}
+
+bool TradeRing::unlink(const std::string& name) noexcept {
+#if defined(__linux__)
+    return ::shm_unlink(name.c_str()) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+TradeRing::TradeRing(TradeRing&& other) noexcept
+    : header_{other.header_}, slots_{other.slots_}, mappedBytes_{other.mappedBytes_},
+      mask_{other.mask_}, next_{other.next_}, lost_{other.lost_} {
+    other.header_ = nullptr;
+    other.slots_ = nullptr;
+}
+
+TradeRing& TradeRing::operator=(TradeRing&& other) noexcept {
+    if (this != &other) {
+        release();
+        header_ = other.header_;
+        slots_ = other.slots_;
+        mappedBytes_ = other.mappedBytes_;
+        mask_ = other.mask_;
+        next_ = other.next_;
+        lost_ = other.lost_;
+        other.header_ = nullptr;
+        other.slots_ = nullptr;
+    }
+    return *this;
+}
+
+TradeRing::~TradeRing() {
+    release();
+}
+
+void TradeRing::release() noexcept {
+#if defined(__linux__)
+    if (header_) {
+        ::munmap(header_, mappedBytes_);
+    }
+#endif
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+void TradeRing::publish(const TradeMessage& message) noexcept {
+    std::uint64_t words[PAYLOAD_WORDS]{};
+    std::memcpy(words, &message, sizeof(TradeMessage));
+    
+    const std::uint64_t number = next_++;
+    Slot& slot = slots_[number & mask_];
+    slot.sequence.store(2 * number + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+        slot.payload[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * number + 2, std::memory_order_release);
+    header_->published.store(number + 1, std::memory_order_release);
+}
+
+TradeRing::PollResult TradeRing::poll(TradeMessage& message) noexcept {
+    const Slot& slot = slots_[next_ & mask_];
+    const std::uint64_t expected = 2 * next_ + 2;
+    
+    for (;;) {
+        const std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before < expected - 1) {
+            return PollResult::EMPTY;  // Not written yet
+        }
+        if (before > expected) {
+            // Lapped: jump to the oldest message that is still guaranteed intact
+            const std::uint64_t published = header_->published.load(std::memory_order_acquire);
+            const std::uint64_t oldest = published > capacity() / 2 ? published - capacity() / 2 : 0;
+            const std::uint64_t resume = std::max(oldest, next_ + 1);
+            lost_ += resume - next_;
+            next_ = resume;
+            return PollResult::OVERRUN;
+        }
+        if (before != expected) {
+            continue;  // Writer is mid-update on this slot
+        }
+        
+        std::uint64_t words[PAYLOAD_WORDS];
+        for (std::size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+            words[i] = slot.payload[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            continue;  // Overwritten while copying; re-evaluate
+        }
+        
+        std::memcpy(&message, words, sizeof(TradeMessage));
+        ++next_;
+        return PollResult::MESSAGE;
+    }
+}
+
+} // namespace nse::mtbt
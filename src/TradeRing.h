@@ -0,0 +1,111 @@
+#pragma once
+
+#include "MessageTypes.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace nse::mtbt {
+
+/**
+ * Shared-memory broadcast ring of decoded trades (one writer, any number of readers)
+ *
+ * Every slot carries its own seqlock sequence, so the writer never waits
+ * on readers: it simply overwrites the oldest slot. Readers consume at
+ * their own pace and detect when the writer has lapped them. The writer
+ * marks the end of its stream with close(), so readers know to stop once
+ * they have caught up. Linux only; create()/attach() return nullopt elsewhere.
+ */
+class TradeRing {
+public:
+    static constexpr std::uint32_t LAYOUT_MAGIC = 0x474E524D; // "MRNG"
+    static constexpr std::uint32_t LAYOUT_VERSION = 2;
+    static constexpr std::size_t PAYLOAD_WORDS = (sizeof(TradeMessage) + 7) / 8;
+
+    static_assert(std::is_trivially_copyable_v<TradeMessage>, "ring slots copy trades as raw words");
+
+    /**
+     * One trade per cache line; sequence is 2n+1 while message n is written, 2n+2 once complete
+     */
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> payload[PAYLOAD_WORDS];
+    };
+
+    /**
+     * Segment header; slots follow on the next cache line
+     */
+    struct alignas(CACHE_LINE_SIZE) Header {
+        std::uint32_t magic{0};
+        std::uint32_t version{0};
+        std::uint64_t capacity{0};
+        std::atomic<std::uint32_t> closed{0};                              // Set once the writer is done
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> published{0}; // Messages written so far
+    };
+
+    /**
+     * Outcome of a reader poll
+     */
+    enum class PollResult : std::uint8_t {
+        MESSAGE = 0,   // A trade was copied out
+        EMPTY = 1,     // Caught up with the writer
+        OVERRUN = 2    // Writer lapped this reader; skipped ahead (see lostMessages())
+    };
+
+    /**
+     * Create the named segment for writing; capacity is rounded up to a power of two
+     */
+    [[nodiscard]] static std::optional<TradeRing> create(const std::string& name, std::size_t capacity);
+
+    /**
+     * Attach as a reader, starting at the next message the writer publishes
+     */
+    [[nodiscard]] static std::optional<TradeRing> attach(const std::string& name);
+
+    static bool unlink(const std::string& name) noexcept;
+
+    TradeRing(const TradeRing&) = delete;
+    TradeRing& operator=(const TradeRing&) = delete;
+    TradeRing(TradeRing&& other) noexcept;
+    TradeRing& operator=(TradeRing&& other) noexcept;
+    ~TradeRing();
+
+    /**
+     * Writer: append one trade (wait-free)
+     */
+    void publish(const TradeMessage& message) noexcept;
+
+    /**
+     * Writer: no more trades will follow
+     */
+    void close() noexcept { header_->closed.store(1, std::memory_order_release); }
+
+    /**
+     * Reader: copy out the next trade if one is available
+     */
+    [[nodiscard]] PollResult poll(TradeMessage& message) noexcept;
+
+    [[nodiscard]] std::uint64_t published() const noexcept { return header_->published.load(std::memory_order_acquire); }
+    [[nodiscard]] std::uint64_t lostMessages() const noexcept { return lost_; }
+    [[nodiscard]] bool closed() const noexcept { return header_->closed.load(std::memory_order_acquire) != 0; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return static_cast<std::size_t>(mask_ + 1); }
+
+private:
+    TradeRing() = default;
+
+    Header* header_{nullptr};
+    Slot* slots_{nullptr};
+    std::size_t mappedBytes_{0};
+    std::uint64_t mask_{0};
+    std::uint64_t next_{0};   // Writer: next message number; reader: next to consume
+    std::uint64_t lost_{0};
+
+    [[nodiscard]] static std::size_t segmentBytes(std::uint64_t capacity) noexcept {
+        return sizeof(Header) + capacity * sizeof(Slot);
+    }
+    void release() noexcept;
+};
+
+} // namespace nse::mtbt
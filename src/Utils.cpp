@@ -1,4 +1,5 @@
 #include "Utils.h"
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -73,10 +74,162 @@ std::string MessageFormatter::formatStats(const Decoder::DecodingStats& stats) {
         oss << colors::RED << "❌ Processing errors:   " << colors::RESET << stats.errorCount << "\n";
     }
     
+    if (stats.filteredMessages > 0) {
+        oss << colors::BLUE << "🔎 Filtered (unsubscribed):" << colors::RESET << " " << stats.filteredMessages << "\n";
+    }
+    
+    if (stats.limitViolations > 0) {
+        oss << colors::RED << "🚧 Outside instrument limits:" << colors::RESET << " " << stats.limitViolations << "\n";
+    }
+    
+    if (stats.sequenceGaps > 0) {
+        oss << colors::YELLOW << "🕳️  Sequence gaps:      " << colors::RESET << stats.sequenceGaps
+            << " (" << stats.missingMessages << " messages missing)\n";
+    }
+    
+    if (stats.suspectSequences > 0) {
+        oss << colors::YELLOW << "❓ Suspect sequences:   " << colors::RESET << stats.suspectSequences
+            << " (implausible jumps, not counted as gaps)\n";
+    }
+    
     if (stats.truncatedBytes > 0) {
         oss << colors::YELLOW << "⚠️  Truncated bytes:    " << colors::RESET << stats.truncatedBytes << "\n";
     }
     
+    if (stats.outputAllocations + stats.outputBufferReuses > 0) {
+        oss << colors::MAGENTA << "🧠 Output buffers:       " << colors::RESET << stats.outputAllocations
+            << " grown (" << stats.outputBytesAllocated << " bytes), " << stats.outputBufferReuses << " reused\n";
+    }
+    
+    return oss.str();
+}
+
+std::string MessageFormatter::formatBar(const Bar& bar) {
+    std::ostringstream oss;
+    oss << std::left
+        << std::setw(10) << SymbolRegistry::getSymbolOrToken(bar.symbolToken)
+        << " | " << std::setw(4) << (bar.interval >= 60'000'000 ? std::to_string(bar.interval / 60'000'000) + "m"
+                                                                 : std::to_string(bar.interval / 1'000'000) + "s")
+        << " | T" << bar.startTime
+        << " | O " << formatPrice(bar.open) << " H " << formatPrice(bar.high)
+        << " L " << formatPrice(bar.low) << " C " << formatPrice(bar.close)
+        << " | Vol " << bar.volume
+        << " | VWAP " << colors::GREEN << "₹" << std::fixed << std::setprecision(2)
+        << bar.vwapInPaisa() / 100.0 << colors::RESET
+        << " | " << bar.tradeCount << " trades";
+    return oss.str();
+}
+
+std::string MessageFormatter::formatQuantiles(std::uint32_t symbolToken, const QuantileTable::Sketches& sketches) {
+    const auto& price = sketches.price;
+    const auto& quantity = sketches.quantity;
+    std::ostringstream oss;
+    oss << std::left
+        << std::setw(10) << SymbolRegistry::getSymbolOrToken(symbolToken)
+        << " | " << std::setw(8) << price.count() << " trades"
+        << " | Qty p1 " << quantity.quantile(0.01) << " p50 " << quantity.quantile(0.5)
+        << " p99 " << quantity.quantile(0.99)
+        << " | Px " << formatPrice(price.minValue()) << " [p1 " << formatPrice(price.quantile(0.01))
+        << " p99 " << formatPrice(price.quantile(0.99)) << "] " << formatPrice(price.maxValue());
+    return oss.str();
+}
+
+std::string MessageFormatter::formatConflated(const Conflator::SymbolState& state) {
+    const auto& last = state.lastTrade;
+    std::ostringstream oss;
+    oss << std::left
+        << std::setw(10) << SymbolRegistry::getSymbolOrToken(last.symbolToken)
+        << " | Last " << formatPrice(last.priceInPaisa) << " x " << std::setw(6) << last.quantity
+        << " " << formatTradeSide(last.side) << " #" << last.sequenceNumber
+        << " | Vol " << state.cumulativeVolume
+        << " | VWAP " << colors::GREEN << "₹" << std::fixed << std::setprecision(2)
+        << state.vwapInPaisa() / 100.0 << colors::RESET
+        << " | " << state.tradeCount << " trades";
+    return oss.str();
+}
+
+std::string MessageFormatter::formatIndexLevel(const std::string& name, double level) {
+    std::ostringstream oss;
+    oss << std::left << std::setw(14) << name << " | "
+        << (level >= 1000.0 ? colors::GREEN : colors::RED)
+        << std::fixed << std::setprecision(2) << level << colors::RESET;
+    return oss.str();
+}
+
+std::string MessageFormatter::formatArenaStats(const ArenaResource::Stats& stats) {
+    std::ostringstream oss;
+    oss << colors::MAGENTA << "🧱 Arena:                " << colors::RESET
+        << stats.peakBytesUsed << "/" << stats.capacityBytes << " bytes peak, "
+        << stats.allocations << " allocations"
+        << (stats.hugePagesActive ? ", huge pages" : "");
+    if (stats.upstreamAllocations > 0) {
+        oss << colors::YELLOW << ", " << stats.upstreamAllocations << " overflowed to heap" << colors::RESET;
+    }
+    oss << "\n";
+    return oss.str();
+}
+
+std::string MessageFormatter::formatStreamStats(const StreamDemux& demux) {
+    std::ostringstream oss;
+    
+    oss << colors::BOLD << colors::BLUE << "\n🔀 Streams (" << demux.streamCount() << " on "
+        << std::max<std::size_t>(demux.threadCount(), 1) << " decoder threads)" << colors::RESET << "\n"
+        << colors::CYAN << "═══════════════════════════════════════════════════════════" 
+        << colors::RESET << "\n";
+    
+    for (std::size_t stream = 0; stream < demux.streamCount(); ++stream) {
+        const auto id = static_cast<std::uint16_t>(stream);   // streamCount() <= 65536
+        const auto& stats = demux.getStats(id);
+        oss << std::left
+            << "Stream " << std::setw(3) << stream
+            << " | Thread: " << std::setw(2) << demux.threadOf(id)
+            << " | Valid: " << std::setw(9) << stats.validMessages
+            << " | Errors: " << std::setw(6) << stats.errorCount
+            << " | Gaps: " << stats.sequenceGaps << " (" << stats.missingMessages << " missing)";
+        if (!demux.getGaps(id).empty()) {
+            const auto& first = demux.getGaps(id).front();
+            oss << colors::YELLOW << " | First gap: " << first.firstMissing << "-" << first.lastMissing << colors::RESET;
+        }
+        oss << "\n";
+    }
+    
+    const auto& demuxStats = demux.getDemuxStats();
+    if (demuxStats.unroutedFrames > 0) {
+        oss << colors::YELLOW << "⚠️  Unrouted frames (bad stream id): " << demuxStats.unroutedFrames
+            << colors::RESET << "\n";
+    }
+    
+    return oss.str();
+}
+
+std::string MessageFormatter::formatShardStats(const std::vector<ShardDispatcher::ShardStats>& shards) {
+    std::ostringstream oss;
+    
+    std::uint64_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard.processed;
+    }
+    
+    oss << colors::BOLD << colors::BLUE << "\n🧵 Shard Load" << colors::RESET << "\n"
+        << colors::CYAN << "═══════════════════════════════════════════════════════════" 
+        << colors::RESET << "\n";
+    
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        const auto& shard = shards[i];
+        const double share = total > 0 ? 100.0 * static_cast<double>(shard.processed) / static_cast<double>(total) : 0.0;
+        oss << std::left
+            << "Shard " << std::setw(3) << i
+            << " | CPU: " << std::setw(3) << (shard.cpu >= 0 ? std::to_string(shard.cpu) : "-")
+            << " | Tokens: " << std::setw(4) << shard.ownedTokens
+            << " | Msgs: " << std::setw(9) << shard.processed
+            << " (" << std::fixed << std::setprecision(1) << std::setw(5) << share << "%)"
+            << " | Backlog: " << shard.queueDepth << " (peak " << shard.maxQueueDepth << ")";
+        if (shard.producerStalls > 0) {
+            oss << colors::YELLOW << " | Stalls: " << shard.producerStalls << colors::RESET;
+        }
+        oss << "\n";
+    }
+    
     return oss.str();
 }
 
@@ -2,6 +2,12 @@
 
 #include "MessageTypes.h"
 #include "Decoder.h"
+#include "ShardDispatcher.h"
+#include "StreamDemux.h"
+#include "ArenaResource.h"
+#include "BarAggregator.h"
+#include "QuantileSketch.h"
+#include "Conflator.h"
 #include <string>
 #include <vector>
 #include <optional>
@@ -43,6 +49,41 @@ public:
      */
     [[nodiscard]] static std::string formatStats(const Decoder::DecodingStats& stats);
 
+    /**
+     * Format one OHLCV bar
+     */
+    [[nodiscard]] static std::string formatBar(const Bar& bar);
+    
+    /**
+     * Format a symbol's quantity quantiles and price range
+     */
+    [[nodiscard]] static std::string formatQuantiles(std::uint32_t symbolToken, const QuantileTable::Sketches& sketches);
+    
+    /**
+     * Format a symbol's conflated state: last trade, cumulative volume and VWAP
+     */
+    [[nodiscard]] static std::string formatConflated(const Conflator::SymbolState& state);
+    
+    /**
+     * Format an index name and level
+     */
+    [[nodiscard]] static std::string formatIndexLevel(const std::string& name, double level);
+
+    /**
+     * Format arena allocator statistics
+     */
+    [[nodiscard]] static std::string formatArenaStats(const ArenaResource::Stats& stats);
+
+    /**
+     * Format per-shard load and queue depth
+     */
+    [[nodiscard]] static std::string formatShardStats(const std::vector<ShardDispatcher::ShardStats>& shards);
+
+    /**
+     * Format per-stream decoding and gap statistics of a demultiplexed segment
+     */
+    [[nodiscard]] static std::string formatStreamStats(const StreamDemux& demux);
+
     /**
      * Format price with currency symbol
      */
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace nse::mtbt::wire {
+
+enum class Endian : std::uint8_t {
+    LITTLE,
+    BIG
+};
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr Endian HOST_ENDIAN = Endian::BIG;
+#else
+inline constexpr Endian HOST_ENDIAN = Endian::LITTLE;
+#endif
+
+/**
+ * Reverse the bytes of an unsigned integer
+ */
+template<typename T>
+[[nodiscard]] constexpr T byteswap(T value) noexcept {
+    static_assert(std::is_unsigned_v<T>, "byteswap needs an unsigned integer");
+    if constexpr (sizeof(T) == 1) {
+        return value;
+#if defined(__GNUC__)
+    } else if constexpr (sizeof(T) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(T) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(T) == 8) {
+        return __builtin_bswap64(value);
+#endif
+    } else {
+        T result = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            result = static_cast<T>((result << 8) | ((value >> (i * 8)) & 0xFF));
+        }
+        return result;
+    }
+}
+
+/**
+ * Unaligned load of a T stored in the given byte order
+ */
+template<typename T, Endian Order = Endian::LITTLE>
+[[nodiscard]] inline T load(const std::uint8_t* bytes) noexcept {
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    if constexpr (Order != HOST_ENDIAN) {
+        value = byteswap(value);
+    }
+    return value;
+}
+
+/**
+ * Unaligned store of a T in the given byte order
+ */
+template<typename T, Endian Order = Endian::LITTLE>
+inline void store(std::uint8_t* bytes, T value) noexcept {
+    if constexpr (Order != HOST_ENDIAN) {
+        value = byteswap(value);
+    }
+    std::memcpy(bytes, &value, sizeof(T));
+}
+
+/**
+ * One fixed-position field: wire type, byte offset and byte order
+ *
+ * load/store compile to a single unaligned access, plus a byteswap only
+ * when the wire order differs from the host's.
+ */
+template<typename T, std::size_t Offset, Endian Order = Endian::LITTLE>
+struct Field {
+    static_assert(std::is_unsigned_v<T>, "wire fields are unsigned integers");
+
+    using Type = T;
+    static constexpr std::size_t OFFSET = Offset;
+    static constexpr std::size_t WIDTH = sizeof(T);
+    static constexpr std::size_t END = Offset + sizeof(T);
+    static constexpr Endian ORDER = Order;
+
+    [[nodiscard]] static T load(const std::uint8_t* frame) noexcept {
+        return wire::load<T, Order>(frame + Offset);
+    }
+
+    static void store(std::uint8_t* frame, T value) noexcept {
+        wire::store<T, Order>(frame + Offset, value);
+    }
+};
+
+/**
+ * Default member <-> wire conversion: a plain cast
+ */
+struct CastConversion {
+    template<typename Member, typename Wire>
+    [[nodiscard]] static constexpr Member fromWire(Wire value) noexcept { return static_cast<Member>(value); }
+
+    template<typename Wire, typename Member>
+    [[nodiscard]] static constexpr Wire toWire(Member value) noexcept { return static_cast<Wire>(value); }
+};
+
+template<typename T>
+struct MemberPointerTraits;
+
+template<typename Class, typename Value>
+struct MemberPointerTraits<Value Class::*> {
+    using ClassType = Class;
+    using ValueType = Value;
+};
+
+/**
+ * Binds a message member to a wire field
+ */
+template<auto Member, typename WireField, typename Conversion = CastConversion>
+struct Bind {
+    using FieldType = WireField;
+    using ValueType = typename MemberPointerTraits<decltype(Member)>::ValueType;
+
+    template<typename Message>
+    static void parse(const std::uint8_t* frame, Message& message) noexcept {
+        message.*Member = Conversion::template fromWire<ValueType>(WireField::load(frame));
+    }
+
+    template<typename Message>
+    static void serialize(const Message& message, std::uint8_t* frame) noexcept {
+        WireField::store(frame, Conversion::template toWire<typename WireField::Type>(message.*Member));
+    }
+};
+
+/**
+ * A message layout: parse/serialize are generated from the bindings
+ */
+template<typename Message, typename... Bindings>
+struct Codec {
+    static constexpr std::size_t END = [] {
+        std::size_t end = 0;
+        ((end = Bindings::FieldType::END > end ? Bindings::FieldType::END : end), ...);
+        return end;
+    }();
+
+    static void parse(const std::uint8_t* frame, Message& message) noexcept {
+        (Bindings::parse(frame, message), ...);
+    }
+
+    [[nodiscard]] static Message parse(const std::uint8_t* frame) noexcept {
+        Message message;
+        parse(frame, message);
+        return message;
+    }
+
+    static void serialize(const Message& message, std::uint8_t* frame) noexcept {
+        (Bindings::serialize(message, frame), ...);
+    }
+};
+
+/**
+ * True when no two fields share a byte (checked at compile time per layout)
+ */
+template<typename... Fields>
+[[nodiscard]] constexpr bool fieldsDisjoint() noexcept {
+    constexpr std::size_t offsets[] = {Fields::OFFSET...};
+    constexpr std::size_t ends[] = {Fields::END...};
+    for (std::size_t i = 0; i < sizeof...(Fields); ++i) {
+        for (std::size_t j = i + 1; j < sizeof...(Fields); ++j) {
+            if (offsets[i] < ends[j] && offsets[j] < ends[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * NSE MTBT trade frame (40 bytes, little-endian)
+ */
+struct TradeFrame {
+    static constexpr std::size_t SIZE = 40;
+
+    using Sequence = Field<std::uint32_t, 0>;
+    using SymbolToken = Field<std::uint32_t, 4>;
+    using Timestamp = Field<std::uint64_t, 8>;
+    using Price = Field<std::uint32_t, 16>;
+    using Quantity = Field<std::uint32_t, 20>;
+    using Side = Field<std::uint8_t, 24>;
+    using StreamId = Field<std::uint16_t, 26>;   // Sequence space; 0 in single-stream feeds
+    using Checksum = Field<std::uint32_t, 36>;   // CRC32 of bytes [0, Checksum::OFFSET)
+
+    static_assert(fieldsDisjoint<Sequence, SymbolToken, Timestamp, Price, Quantity, Side, StreamId, Checksum>(),
+                  "TradeFrame fields overlap");
+    static_assert(Checksum::END == SIZE, "checksum must close the frame");
+};
+
+/**
+ * TCP publisher batch header (24 bytes, little-endian); Count TradeFrames follow it
+ */
+struct BatchHeader {
+    static constexpr std::size_t SIZE = 24;
+    static constexpr std::uint32_t MAGIC = 0x5442544D;  // "MTBT"
+
+    using Magic = Field<std::uint32_t, 0>;
+    using Count = Field<std::uint32_t, 4>;
+    using Batch = Field<std::uint64_t, 8>;      // Publisher batch number, consecutive on a connection
+    using SendTime = Field<std::uint64_t, 16>;  // Publisher steady clock (ns) when the batch was sealed
+
+    static_assert(fieldsDisjoint<Magic, Count, Batch, SendTime>(), "BatchHeader fields overlap");
+    static_assert(SendTime::END == SIZE, "send time must close the header");
+};
+
+} // namespace nse::mtbt::wire
\ No newline at end of file
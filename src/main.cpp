@@ -1,13 +1,34 @@
 #include "FeedSimulator.h"
 #include "Decoder.h"
 #include "Utils.h"
+#include "Checkpoint.h"
+#include "CaptureFile.h"
+#include "CaptureIndex.h"
+#include "EventTracer.h"
+#include "MergeReplay.h"
+#include "StreamDemux.h"
+#include "SubscriptionFilter.h"
+#include "InstrumentLimits.h"
+#include "ArenaResource.h"
+#include "AsyncReader.h"
+#include "StatsExport.h"
+#include "TradeRing.h"
+#include "TcpPublisher.h"
+#include "TraceLogger.h"
+#include "Benchmarks.h"
+#include "PerfHarness.h"
+#include "IndexEngine.h"
+#include "QuantileSketch.h"
+#include "Conflator.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <chrono>
+#include <thread>
 #include <vector>
 #include <iomanip>
 #include <optional>
+#include <sstream>
 
 namespace nse::mtbt::app {
 
@@ -23,9 +44,45 @@ struct ApplicationConfig {
     std::string outputPath{"decoded_output.csv"};
     std::optional<std::uint32_t> randomSeed{std::nullopt};
     ValidationLevel validationLevel{ValidationLevel::STRICT};
+    std::optional<std::string> inputPath{std::nullopt};
+    std::optional<std::uint64_t> seekTimestamp{std::nullopt};
+    std::optional<std::uint32_t> seekSequence{std::nullopt};
+    std::uint32_t maxSequenceJump{Decoder::DEFAULT_MAX_SEQUENCE_JUMP};
+    std::vector<std::string> mergePaths{};
+    bool asyncIo{false};
+    std::optional<std::string> tracePath{std::nullopt};
+    std::uint64_t traceEvery{1};
+    bool traceErrorsOnly{false};
+    std::optional<std::string> traceEventsPath{std::nullopt};
+    std::optional<std::string> recordPath{std::nullopt};
+    std::optional<std::string> checkpointPath{std::nullopt};
+    std::uint64_t checkpointInterval{100'000};
+    std::size_t shardCount{0};
+    bool rebalanceShards{false};
+    bool skewedSymbols{false};
+    std::size_t streamCount{0};
+    std::size_t streamThreads{1};
+    std::vector<std::uint32_t> subscriptions{};
+    std::optional<std::string> limitsPath{std::nullopt};
+    std::size_t arenaMegabytes{0};
+    bool hugePages{false};
+    std::size_t batchMessages{0};
+    std::optional<std::string> statsSegment{std::nullopt};
+    std::optional<std::string> ringSegment{std::nullopt};
+    std::optional<std::uint16_t> tcpPort{std::nullopt};
+    std::string tcpBind{"127.0.0.1"};
+    std::size_t tcpSubscribers{1};
+    std::uint64_t tcpWaitMs{30'000};
+    std::optional<std::string> benchmark{std::nullopt};
+    std::optional<bench::PerfHarnessOptions> perfHarness{std::nullopt};
+    bool showBars{false};
+    bool showQuantiles{false};
+    bool showConflated{false};
+    std::optional<std::string> indicesPath{std::nullopt};
     
     [[nodiscard]] bool isValid() const noexcept {
-        return messageCount > 0 && messageCount <= 1'000'000 && !outputPath.empty();
+        return messageCount > 0 && messageCount <= 1'000'000 && !outputPath.empty() &&
+               checkpointInterval > 0 && shardCount <= 256 && streamCount <= 65'535 && streamThreads <= 256;
     }
 };
 
@@ -50,12 +107,92 @@ void printUsage(const std::string& programName) noexcept {
               << "     Include malformed messages for testing\n"
               << "  " << colors::YELLOW << "--seed N" << colors::RESET 
               << "          Set random seed for reproducibility\n"
+              << "  " << colors::YELLOW << "--input PATH" << colors::RESET 
+              << "       Decode a recorded capture file instead of simulating\n"
+              << "  " << colors::YELLOW << "--record PATH" << colors::RESET 
+              << "      Save the generated feed as a capture file\n"
+              << "  " << colors::YELLOW << "--async-io" << colors::RESET 
+              << "         Stream --input through io_uring O_DIRECT reads (from the start)\n"
+              << "  " << colors::YELLOW << "--merge LIST" << colors::RESET 
+              << "       Replay several captures merged by timestamp (comma-separated)\n"
+              << "  " << colors::YELLOW << "--seek-time T" << colors::RESET 
+              << "      Start --input at the first trade with timestamp >= T (µs)\n"
+              << "  " << colors::YELLOW << "--seek-seq S" << colors::RESET 
+              << "       Start --input at the first trade with sequence >= S\n"
+              << "  " << colors::YELLOW << "--max-seq-jump N" << colors::RESET 
+              << "   Sequence jumps above N are suspect until confirmed (default: 100000)\n"
+              << "  " << colors::YELLOW << "--checkpoint PATH" << colors::RESET 
+              << "  Checkpoint decoder state; resume --input from it on restart\n"
+              << "  " << colors::YELLOW << "--checkpoint-every N" << colors::RESET 
+              << " Checkpoint interval in messages (default: 100000)\n"
+              << "  " << colors::YELLOW << "--subscribe LIST" << colors::RESET 
+              << "   Only decode these symbols/tokens (comma-separated)\n"
+              << "  " << colors::YELLOW << "--limits FILE" << colors::RESET 
+              << "      Per-instrument price bands, tick and lot sizes (reloaded on change)\n"
+              << "  " << colors::YELLOW << "--arena MB" << colors::RESET 
+              << "         Decode into a pre-faulted arena of MB megabytes\n"
+              << "  " << colors::YELLOW << "--huge-pages" << colors::RESET 
+              << "       Back the arena with 2 MB huge pages where available\n"
+              << "  " << colors::YELLOW << "--batch N" << colors::RESET 
+              << "          Decode in batches of N messages (default: whole input)\n"
+              << "  " << colors::YELLOW << "--export-stats NAME" << colors::RESET 
+              << " Publish live counters to shared memory (e.g. /nse_mtbt_stats)\n"
+              << "  " << colors::YELLOW << "--publish-ring NAME" << colors::RESET 
+              << " Broadcast trades on a shared-memory ring as batches decode\n"
+              << "  " << colors::YELLOW << "--publish-tcp PORT" << colors::RESET 
+              << "  Stream decoded trades to TCP subscribers (binary batches)\n"
+              << "  " << colors::YELLOW << "--tcp-bind ADDR" << colors::RESET 
+              << "     Address to listen on for --publish-tcp (default 127.0.0.1)\n"
+              << "  " << colors::YELLOW << "--tcp-subscribers N" << colors::RESET 
+              << " Subscribers to wait for before decoding (default 1)\n"
+              << "  " << colors::YELLOW << "--tcp-wait-ms N" << colors::RESET 
+              << "     Give up waiting for them after N ms and publish anyway (default 30000)\n"
+              << "  " << colors::YELLOW << "--bench NAME" << colors::RESET 
+              << "       Run a benchmark (see below; --count sets its size)\n"
+              << "  " << colors::YELLOW << "--perf FILE" << colors::RESET 
+              << "        Run the pinned fixed-seed perf scenarios, write JSON results\n"
+              << "  " << colors::YELLOW << "--perf-baseline FILE" << colors::RESET 
+              << " Fail (exit 2) if msg/s drops beyond --perf-threshold PCT (default 10)\n"
+              << "  " << colors::YELLOW << "--perf-runs N" << colors::RESET 
+              << "      Runs per scenario, best run gated (default 5); --perf-cpu N pins\n"
+              << "  " << colors::YELLOW << "--bars" << colors::RESET 
+              << "             Aggregate 1s/1m OHLCV+VWAP bars per symbol\n"
+              << "  " << colors::YELLOW << "--quantiles" << colors::RESET 
+              << "        Per-symbol quantity quantiles and price range from streaming sketches\n"
+              << "  " << colors::YELLOW << "--conflate" << colors::RESET 
+              << "          Latest trade and cumulative volume per symbol (conflated view)\n"
+              << "  " << colors::YELLOW << "--indices FILE" << colors::RESET 
+              << "     Compute free-float indices from a constituent weights file\n"
+              << "  " << colors::YELLOW << "--trace FILE" << colors::RESET 
+              << "       Write binary decoding details to FILE from a background thread\n"
+              << "  " << colors::YELLOW << "--trace-every N" << colors::RESET 
+              << "    Trace every Nth frame (default: 1)\n"
+              << "  " << colors::YELLOW << "--trace-errors" << colors::RESET 
+              << "     Trace only invalid and unparseable frames\n"
+              << "  " << colors::YELLOW << "--trace-events FILE" << colors::RESET 
+              << " Write hot-path scope timings as Chrome trace JSON (build with -DMTBT_ENABLE_TRACING)\n"
+              << "  " << colors::YELLOW << "--shards N" << colors::RESET 
+              << "         Fan decoded trades out to N pinned worker threads\n"
+              << "  " << colors::YELLOW << "--rebalance" << colors::RESET 
+              << "        Periodically rebalance shards by observed symbol load\n"
+              << "  " << colors::YELLOW << "--skewed" << colors::RESET 
+              << "           Simulate volume concentrated in a few symbols\n"
+              << "  " << colors::YELLOW << "--streams N" << colors::RESET 
+              << "        Demultiplex N independently sequenced streams, up to 65535 (simulates an N-stream segment)\n"
+              << "  " << colors::YELLOW << "--stream-threads T" << colors::RESET 
+              << "  Decode the streams on T threads (default: 1)\n"
               << "  " << colors::YELLOW << "--help" << colors::RESET 
               << "            Show this help message\n\n"
+              << colors::BOLD << "Benchmarks:\n" << colors::RESET;
+    for (const auto& line : bench::listBenchmarks()) {
+        std::cout << "  " << line << "\n";
+    }
+    std::cout << "\n"
               << colors::BOLD << "Examples:\n" << colors::RESET
               << "  " << programName << " --count 10000 --csv\n"
               << "  " << programName << " --test-errors --seed 42\n"
-              << "  " << programName << " --count 100 --output trades.csv\n";
+              << "  " << programName << " --count 100 --output trades.csv\n"
+              << "  " << programName << " --input day.cap --checkpoint day.ckpt\n";
 }
 
 /**
@@ -95,21 +232,203 @@ void printUsage(const std::string& programName) noexcept {
                 std::cerr << "❌ Error: Invalid seed value\n";
                 return std::nullopt;
             }
+        } else if (arg == "--bars") {
+            config.showBars = true;
+        } else if (arg == "--quantiles") {
+            config.showQuantiles = true;
+        } else if (arg == "--conflate") {
+            config.showConflated = true;
+        } else if (arg == "--indices" && i + 1 < argc) {
+            config.indicesPath = argv[++i];
+        } else if (arg == "--rebalance") {
+            config.rebalanceShards = true;
+        } else if (arg == "--skewed") {
+            config.skewedSymbols = true;
+        } else if ((arg == "--streams" || arg == "--stream-threads") && i + 1 < argc) {
+            try {
+                const auto value = static_cast<std::size_t>(std::stoul(argv[++i]));
+                (arg == "--streams" ? config.streamCount : config.streamThreads) = value;
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid stream count\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--shards" && i + 1 < argc) {
+            try {
+                config.shardCount = static_cast<std::size_t>(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid shard count\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--publish-ring" && i + 1 < argc) {
+            config.ringSegment = argv[++i];
+        } else if (arg == "--tcp-bind" && i + 1 < argc) {
+            config.tcpBind = argv[++i];
+        } else if ((arg == "--publish-tcp" || arg == "--tcp-subscribers" || arg == "--tcp-wait-ms") && i + 1 < argc) {
+            try {
+                const auto value = std::stoul(argv[++i]);
+                if (arg == "--publish-tcp") {
+                    if (value > 65535) {
+                        throw std::out_of_range{"port"};
+                    }
+                    config.tcpPort = static_cast<std::uint16_t>(value);
+                } else if (arg == "--tcp-subscribers") {
+                    config.tcpSubscribers = static_cast<std::size_t>(value);
+                } else {
+                    config.tcpWaitMs = value;
+                }
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid " << (arg == "--publish-tcp" ? "port" : arg == "--tcp-subscribers" ? "subscriber count" : "wait")
+                          << "\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--bench" && i + 1 < argc) {
+            config.benchmark = argv[++i];
+        } else if (arg == "--perf" && i + 1 < argc) {
+            (config.perfHarness ? *config.perfHarness : config.perfHarness.emplace()).outputPath = argv[++i];
+        } else if ((arg == "--perf-baseline" || arg == "--perf-threshold" || arg == "--perf-runs" ||
+                    arg == "--perf-cpu") && i + 1 < argc) {
+            auto& perf = config.perfHarness ? *config.perfHarness : config.perfHarness.emplace();
+            try {
+                if (arg == "--perf-baseline") {
+                    perf.baselinePath = argv[++i];
+                } else if (arg == "--perf-threshold") {
+                    perf.thresholdPercent = std::stod(argv[++i]);
+                } else if (arg == "--perf-runs") {
+                    perf.runs = std::stoul(argv[++i]);
+                } else {
+                    perf.cpu = std::stoi(argv[++i]);
+                }
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid value for " << arg << "\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--export-stats" && i + 1 < argc) {
+            config.statsSegment = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            try {
+                config.batchMessages = static_cast<std::size_t>(std::stoull(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid batch size\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--huge-pages") {
+            config.hugePages = true;
+        } else if (arg == "--arena" && i + 1 < argc) {
+            try {
+                config.arenaMegabytes = static_cast<std::size_t>(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid arena size\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--subscribe" && i + 1 < argc) {
+            std::istringstream list{argv[++i]};
+            for (std::string item; std::getline(list, item, ',');) {
+                if (const auto token = SymbolRegistry::findToken(item)) {
+                    config.subscriptions.push_back(*token);
+                    continue;
+                }
+                try {
+                    config.subscriptions.push_back(static_cast<std::uint32_t>(std::stoul(item)));
+                } catch (const std::exception&) {
+                    std::cerr << "❌ Error: Unknown symbol: " << item << "\n";
+                    return std::nullopt;
+                }
+            }
+        } else if (arg == "--limits" && i + 1 < argc) {
+            config.limitsPath = argv[++i];
+        } else if (arg == "--input" && i + 1 < argc) {
+            config.inputPath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            config.tracePath = argv[++i];
+        } else if (arg == "--trace-every" && i + 1 < argc) {
+            try {
+                config.traceEvery = std::max<std::uint64_t>(std::stoull(argv[++i]), 1);
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid trace sampling interval\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--trace-events" && i + 1 < argc) {
+            config.traceEventsPath = argv[++i];
+        } else if (arg == "--trace-errors") {
+            config.traceErrorsOnly = true;
+        } else if (arg == "--async-io") {
+            config.asyncIo = true;
+        } else if (arg == "--merge" && i + 1 < argc) {
+            std::istringstream list{argv[++i]};
+            for (std::string item; std::getline(list, item, ',');) {
+                config.mergePaths.push_back(item);
+            }
+        } else if ((arg == "--seek-time" || arg == "--seek-seq") && i + 1 < argc) {
+            try {
+                const auto target = std::stoull(argv[++i]);
+                if (arg == "--seek-time") {
+                    config.seekTimestamp = target;
+                } else {
+                    config.seekSequence = static_cast<std::uint32_t>(target);
+                }
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid seek target\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--max-seq-jump" && i + 1 < argc) {
+            try {
+                config.maxSequenceJump = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid sequence jump window\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--record" && i + 1 < argc) {
+            config.recordPath = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            config.checkpointPath = argv[++i];
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            try {
+                config.checkpointInterval = std::stoull(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "❌ Error: Invalid checkpoint interval\n";
+                return std::nullopt;
+            }
         } else {
             std::cerr << "❌ Error: Unknown argument: " << arg << "\n";
             return std::nullopt;
         }
     }
     
+    // A seek picks its own start, so resuming from a checkpoint would be skipped without a word
+    if (config.checkpointPath && (config.seekTimestamp || config.seekSequence)) {
+        std::cerr << "❌ Error: --checkpoint cannot be combined with --seek-time or --seek-seq\n";
+        return std::nullopt;
+    }
+    
+    // The async reader always streams the whole capture from offset 0
+    if (config.asyncIo && (config.checkpointPath || config.seekTimestamp || config.seekSequence)) {
+        std::cerr << "❌ Error: --checkpoint, --seek-time and --seek-seq cannot be combined with --async-io\n";
+        return std::nullopt;
+    }
+    
+    // The ring and the TCP publisher have a single writer, but stream decoders deliver on their own threads
+    if ((config.ringSegment || config.tcpPort) && config.streamCount > 0) {
+        std::cerr << "❌ Error: --publish-ring and --publish-tcp cannot be combined with --streams\n";
+        return std::nullopt;
+    }
+    
+    // Merge and demux replays run one decoder per input or stream: per-decoder outputs have no single owner
+    if ((!config.mergePaths.empty() || config.streamCount > 0) &&
+        (config.tracePath || config.checkpointPath || config.statsSegment)) {
+        std::cerr << "❌ Error: --trace, --checkpoint and --export-stats cannot be combined with --merge or --streams\n";
+        return std::nullopt;
+    }
+    
     return config.isValid() ? std::optional{config} : std::nullopt;
 }
 
 /**
  * Write CSV output
  */
-[[nodiscard]] bool writeCsvOutput(const std::vector<TradeMessage>& messages, 
+[[nodiscard]] bool writeCsvOutput(const Decoder::MessageBuffer& messages, 
                                  const std::string& outputPath) noexcept {
     using namespace nse::mtbt::utils;
+    MTBT_TRACE_SCOPE("writeCsvOutput");
     
     try {
         std::ofstream csvFile{outputPath};
@@ -151,49 +470,427 @@ int main(int argc, char* argv[]) {
     
     const auto& config = *configOpt;
     
+    if (config.perfHarness) {
+        auto perfOptions = *config.perfHarness;
+        perfOptions.seed = config.randomSeed.value_or(perfOptions.seed);
+        return bench::runPerfHarness(perfOptions);
+    }
+    
+    if (config.benchmark) {
+        bench::BenchmarkOptions benchOptions{};
+        benchOptions.messageCount = config.messageCount;
+        benchOptions.seed = config.randomSeed.value_or(benchOptions.seed);
+        if (config.inputPath) {
+            benchOptions.inputs.push_back(*config.inputPath);
+        }
+        return bench::runBenchmark(*config.benchmark, benchOptions) ? 0 : 1;
+    }
+    
     std::cout << colors::BOLD << colors::CYAN 
               << "🚀 NSE MTBT Feed Decoder" << colors::RESET << "\n"
               << colors::GREEN << "═══════════════════════════════════════════════════════════" 
               << colors::RESET << "\n";
     
-    std::cout << colors::BLUE << "📊 Processing " << config.messageCount << " messages";
-    if (config.testErrors) {
-        std::cout << " (including error simulation)";
-    }
-    if (config.randomSeed) {
-        std::cout << " [seed: " << *config.randomSeed << "]";
+    if (config.traceEventsPath) {
+        if (!EventTracer::compiledIn()) {
+            std::cerr << colors::YELLOW << "⚠️  Event tracing is compiled out; rebuild with -DMTBT_ENABLE_TRACING\n"
+                      << colors::RESET;
+        }
+        EventTracer::enable(true);
     }
-    std::cout << "...\n" << colors::RESET;
-    
-    // Configure and generate feed data
-    FeedSimulator::Config simConfig{};
-    simConfig.messageCount = config.messageCount;
-    simConfig.seed = config.randomSeed.value_or(0);
-    simConfig.malformedCount = config.testErrors ? config.messageCount / 20 : 0;
-    simConfig.validationLevel = config.validationLevel;
     
-    FeedSimulator simulator{simConfig};
-    
-    // Generate feed data with timing
-    const PerformanceMonitor::Timer generationTimer{};
-    const auto feedData = config.testErrors ? 
-        simulator.generateTestFeed() : simulator.generateFeed();
-    const auto generationTime = generationTimer.elapsedMicroseconds();
-    
-    std::cout << colors::GREEN << "✅ Generated " << feedData.size() 
-              << " bytes of feed data in " << generationTime << " μs\n" << colors::RESET;
-    
-    // Decode the feed
+    // Decoder is created up front so a checkpoint can be restored before input is read
     Decoder decoder{};
     decoder.setValidationLevel(config.validationLevel);
+    decoder.setMaxSequenceJump(config.maxSequenceJump);
+    
+    std::vector<std::uint8_t> feedData;
+    std::optional<CaptureFile> capture;
+    const std::uint8_t* input = nullptr;
+    std::size_t inputSize = 0;
+    std::vector<CaptureFile> mergeInputs;
+    
+    if (!config.mergePaths.empty()) {
+        for (const auto& path : config.mergePaths) {
+            auto file = CaptureFile::open(path);
+            if (!file) {
+                std::cerr << colors::RED << "❌ Failed to open capture " << path << "\n" << colors::RESET;
+                return 1;
+            }
+            mergeInputs.push_back(std::move(*file));
+        }
+        std::cout << colors::BLUE << "📊 Merging " << mergeInputs.size() << " captures by timestamp...\n"
+                  << colors::RESET;
+    } else if (config.inputPath && config.asyncIo) {
+        std::cout << colors::BLUE << "📊 Streaming " << *config.inputPath << " through async reads...\n"
+                  << colors::RESET;
+    } else if (config.inputPath) {
+        capture = CaptureFile::open(*config.inputPath);
+        if (!capture) {
+            std::cerr << colors::RED << "❌ Failed to open capture " << *config.inputPath << "\n" << colors::RESET;
+            return 1;
+        }
+        input = capture->data();
+        inputSize = capture->size();
+        
+        // Random access: jump straight to a time or sequence via the sidecar index
+        if (config.seekTimestamp || config.seekSequence) {
+            const PerformanceMonitor::Timer seekTimer{};
+            const auto sidecar = CaptureIndex::sidecarPath(*config.inputPath);
+            auto index = CaptureIndex::load(sidecar, inputSize);
+            if (!index) {
+                index = CaptureIndex::build(input, inputSize);
+                if (index->save(sidecar)) {
+                    std::cout << colors::GREEN << "🗂️  Built seek index " << sidecar << " ("
+                              << index->entries().size() << " entries)\n" << colors::RESET;
+                }
+            }
+            
+            const auto offset = config.seekTimestamp
+                ? decoder.seekToTimestamp(*index, input, inputSize, *config.seekTimestamp)
+                : decoder.seekToSequence(*index, input, inputSize, *config.seekSequence);
+            if (!offset) {
+                std::cerr << colors::RED << "❌ No intact trade at or after the seek target in " << *config.inputPath
+                          << "\n" << colors::RESET;
+                return 1;
+            }
+            input += *offset;
+            inputSize -= *offset;
+            std::cout << colors::GREEN << "⏩ Seeked to offset " << *offset << " in "
+                      << seekTimer.elapsedMicroseconds() << " μs\n" << colors::RESET;
+        } else if (config.checkpointPath) {
+            // Fast restart: skip everything the previous run already decoded
+            const PerformanceMonitor::Timer restoreTimer{};
+            if (const auto snapshot = loadCheckpoint(*config.checkpointPath);
+                snapshot && snapshot->captureOffset <= inputSize) {
+                decoder.restoreSnapshot(*snapshot);
+                input += snapshot->captureOffset;
+                inputSize -= snapshot->captureOffset;
+                std::cout << colors::GREEN << "♻️  Resumed from checkpoint at offset " << snapshot->captureOffset
+                          << " (seq " << snapshot->lastSequence << ") in " << restoreTimer.elapsedMicroseconds()
+                          << " μs\n" << colors::RESET;
+            }
+        }
+        
+        std::cout << colors::BLUE << "📊 Decoding " << inputSize << " bytes from " << *config.inputPath
+                  << "...\n" << colors::RESET;
+    } else {
+        std::cout << colors::BLUE << "📊 Processing " << config.messageCount << " messages";
+        if (config.testErrors) {
+            std::cout << " (including error simulation)";
+        }
+        if (config.randomSeed) {
+            std::cout << " [seed: " << *config.randomSeed << "]";
+        }
+        std::cout << "...\n" << colors::RESET;
+        
+        // Configure and generate feed data
+        FeedSimulator::Config simConfig{};
+        simConfig.messageCount = config.messageCount;
+        simConfig.seed = config.randomSeed.value_or(0);
+        simConfig.malformedCount = config.testErrors ? config.messageCount / 20 : 0;
+        simConfig.validationLevel = config.validationLevel;
+        simConfig.skewedSymbols = config.skewedSymbols;
+        simConfig.streamCount = static_cast<std::uint16_t>(std::max<std::size_t>(config.streamCount, 1));
+        
+        FeedSimulator simulator{simConfig};
+        
+        // Generate feed data with timing
+        const PerformanceMonitor::Timer generationTimer{};
+        feedData = config.testErrors ? 
+            simulator.generateTestFeed() : simulator.generateFeed();
+        const auto generationTime = generationTimer.elapsedMicroseconds();
+        
+        std::cout << colors::GREEN << "✅ Generated " << feedData.size() 
+                  << " bytes of feed data in " << generationTime << " μs\n" << colors::RESET;
+        
+        if (config.recordPath) {
+            if (CaptureFile::write(*config.recordPath, feedData)) {
+                std::cout << colors::GREEN << "💾 Recorded capture to " << *config.recordPath << "\n" << colors::RESET;
+            } else {
+                std::cerr << colors::RED << "❌ Failed to record capture to " << *config.recordPath << "\n" << colors::RESET;
+            }
+        }
+        input = feedData.data();
+        inputSize = feedData.size();
+    }
     
     // Enable debug mode for first few messages to show binary decoding
-    if (config.messageCount <= 10) {
+    if (inputSize > 0 && inputSize <= 10 * ProtocolConstants::MESSAGE_SIZE) {
         decoder.setDebugMode(true);
         std::cout << colors::YELLOW << "\n🔍 Debug mode enabled - showing binary decoding details\n" << colors::RESET;
     }
     
-    const auto messages = decoder.decodeFeed(feedData);
+    // Full-rate tracing: the decode loop only enqueues frames, formatting happens elsewhere
+    std::optional<TraceLogger> traceLogger;
+    if (config.tracePath) {
+        TraceLogger::Config traceConfig{};
+        traceConfig.path = *config.tracePath;
+        traceConfig.sampleEvery = config.traceEvery;
+        traceConfig.errorsOnly = config.traceErrorsOnly;
+        traceLogger.emplace(traceConfig);
+        if (traceLogger->isOpen()) {
+            decoder.setTraceLogger(&*traceLogger);
+        } else {
+            std::cerr << colors::RED << "❌ Failed to open trace file " << *config.tracePath << "\n" << colors::RESET;
+            traceLogger.reset();
+        }
+    }
+    
+    std::optional<SubscriptionFilter> subscriptionFilter;
+    if (!config.subscriptions.empty()) {
+        subscriptionFilter.emplace(config.subscriptions);
+        decoder.setSubscriptionFilter(&*subscriptionFilter);
+    }
+    
+    std::optional<InstrumentLimits> instrumentLimits;
+    if (config.limitsPath) {
+        auto table = InstrumentLimits::loadTable(*config.limitsPath);
+        if (!table) {
+            std::cerr << colors::RED << "❌ Failed to load instrument limits from " << *config.limitsPath
+                      << "\n" << colors::RESET;
+            return 1;
+        }
+        std::cout << colors::GREEN << "🚧 Loaded limits for " << table->instrumentCount() << " instruments\n" << colors::RESET;
+        instrumentLimits.emplace(std::move(*table));
+        instrumentLimits->watch(*config.limitsPath);
+        decoder.setInstrumentLimits(&*instrumentLimits);
+    }
+    
+    std::optional<CheckpointWriter> checkpointWriter;
+    if (config.checkpointPath) {
+        CheckpointWriter::Config checkpointConfig{};
+        checkpointConfig.path = *config.checkpointPath;
+        checkpointConfig.intervalMessages = config.checkpointInterval;
+        checkpointWriter.emplace(checkpointConfig);
+        decoder.setCheckpointWriter(&*checkpointWriter, checkpointConfig.intervalMessages);
+    }
+    
+    // Output storage: a pre-faulted arena when requested, the default heap otherwise
+    std::optional<ArenaResource> arena;
+    if (config.arenaMegabytes > 0) {
+        ArenaResource::Config arenaConfig{};
+        arenaConfig.capacityBytes = config.arenaMegabytes << 20;
+        arenaConfig.hugePages = config.hugePages;
+        arena.emplace(arenaConfig);
+    }
+    Decoder::MessageBuffer messages{arena ? static_cast<std::pmr::memory_resource*>(&*arena)
+                                          : std::pmr::get_default_resource()};
+    
+    std::optional<StatsExporter> statsExporter;
+    if (config.statsSegment) {
+        statsExporter = StatsExporter::create(*config.statsSegment);
+        if (statsExporter) {
+            decoder.setStatsExporter(&*statsExporter);
+        } else {
+            std::cerr << colors::YELLOW << "⚠️  Shared-memory stats unavailable on this platform\n" << colors::RESET;
+        }
+    }
+    
+    // Stream to subscribers on other hosts, batch by batch as the input decodes
+    std::optional<TcpPublisher> publisher;
+    if (config.tcpPort) {
+        TcpPublisher::Config publisherConfig{};
+        publisherConfig.bindAddress = config.tcpBind;
+        publisherConfig.port = *config.tcpPort;
+        publisher.emplace(publisherConfig);
+        if (!publisher->listening()) {
+            std::cerr << colors::RED << "❌ Failed to listen on " << config.tcpBind << ":" << *config.tcpPort
+                      << "\n" << colors::RESET;
+            return 1;
+        }
+        std::cout << colors::BLUE << "📡 Waiting for " << config.tcpSubscribers << " subscriber(s) on "
+                  << config.tcpBind << ":" << publisher->port() << "...\n" << colors::RESET;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{config.tcpWaitMs};
+        while (publisher->clientCount() < config.tcpSubscribers && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        if (publisher->clientCount() < config.tcpSubscribers) {
+            std::cerr << colors::YELLOW << "⚠️  Only " << publisher->clientCount() << " subscriber(s) after "
+                      << config.tcpWaitMs << " ms, publishing anyway\n" << colors::RESET;
+        }
+    }
+    
+    // Broadcast to other processes on this host as each batch is decoded
+    std::optional<TradeRing> ring;
+    if (config.ringSegment) {
+        ring = TradeRing::create(*config.ringSegment, 1 << 20);
+        if (!ring) {
+            std::cerr << colors::RED << "❌ Failed to create trade ring " << *config.ringSegment << "\n" << colors::RESET;
+        }
+    }
+    
+    const auto deliver = [&](const auto& batch) {
+        messages.insert(messages.end(), batch.begin(), batch.end());
+        if (ring) {
+            for (const auto& msg : batch) {
+                ring->publish(msg);
+            }
+        }
+        if (publisher) {
+            publisher->publish(batch);
+            publisher->flush();
+        }
+    };
+    
+    std::optional<Decoder::DecodingStats> mergedStats;
+    if (!mergeInputs.empty()) {
+        MergeReplay::Config mergeConfig{};
+        mergeConfig.validationLevel = config.validationLevel;
+        mergeConfig.instrumentLimits = instrumentLimits ? &*instrumentLimits : nullptr;
+        mergeConfig.subscriptionFilter = subscriptionFilter ? &*subscriptionFilter : nullptr;
+        mergeConfig.maxSequenceJump = config.maxSequenceJump;
+        if (config.batchMessages > 0) {
+            mergeConfig.batchMessages = config.batchMessages;
+        }
+        MergeReplay replay{std::move(mergeInputs), mergeConfig};
+        
+        const PerformanceMonitor::Timer mergeTimer{};
+        replay.run([&](std::size_t, const TradeMessage& message) {
+            messages.push_back(message);
+            if (ring) {
+                ring->publish(message);
+            }
+            if (publisher) {
+                publisher->publish(message);   // Seals itself every batchMessages trades
+            }
+        });
+        
+        // Combine per-input counters; speed is for the merged stream as a whole
+        auto& total = mergedStats.emplace();
+        for (std::size_t i = 0; i < replay.inputCount(); ++i) {
+            const auto& stats = replay.getStats(i);
+            total.decodedMessages += stats.decodedMessages;
+            total.validMessages += stats.validMessages;
+            total.errorCount += stats.errorCount;
+            total.bytesProcessed += stats.bytesProcessed;
+            total.truncatedBytes += stats.truncatedBytes;
+            total.crcErrors += stats.crcErrors;
+            total.protocolErrors += stats.protocolErrors;
+            total.sequenceGaps += stats.sequenceGaps;
+            total.missingMessages += stats.missingMessages;
+            total.suspectSequences += stats.suspectSequences;
+            total.filteredMessages += stats.filteredMessages;
+            total.limitViolations += stats.limitViolations;
+        }
+        total.totalTimeUs = mergeTimer.elapsedMicroseconds();
+        total.processingSpeed = total.totalTimeUs > 0 ? total.validMessages * 1'000'000 / total.totalTimeUs : 0;
+    } else if (config.streamCount > 0) {
+        // One decoder per stream; each stream's output stays in stream order
+        StreamDemux::Config demuxConfig{};
+        demuxConfig.streamCount = config.streamCount;
+        demuxConfig.threadCount = config.streamThreads;
+        demuxConfig.validationLevel = config.validationLevel;
+        demuxConfig.instrumentLimits = instrumentLimits ? &*instrumentLimits : nullptr;
+        demuxConfig.subscriptionFilter = subscriptionFilter ? &*subscriptionFilter : nullptr;
+        demuxConfig.maxSequenceJump = config.maxSequenceJump;
+        if (config.batchMessages > 0) {
+            demuxConfig.batchMessages = config.batchMessages;
+        }
+        std::vector<std::vector<TradeMessage>> streamMessages(config.streamCount);
+        StreamDemux demux{demuxConfig, [&streamMessages](std::uint16_t stream, const TradeMessage& message) {
+            streamMessages[stream].push_back(message);
+        }};
+        
+        const PerformanceMonitor::Timer demuxTimer{};
+        constexpr std::size_t CHUNK_BYTES = 1 << 16;  // Not a multiple of the frame size, like socket reads
+        for (std::size_t position = 0; position < inputSize; position += CHUNK_BYTES) {
+            demux.onSegmentData(input + position, std::min(CHUNK_BYTES, inputSize - position));
+        }
+        demux.flush();
+        
+        auto& total = mergedStats.emplace();
+        for (std::size_t stream = 0; stream < demux.streamCount(); ++stream) {
+            const auto& stats = demux.getStats(static_cast<std::uint16_t>(stream));
+            total.decodedMessages += stats.decodedMessages;
+            total.validMessages += stats.validMessages;
+            total.errorCount += stats.errorCount;
+            total.bytesProcessed += stats.bytesProcessed;
+            total.crcErrors += stats.crcErrors;
+            total.protocolErrors += stats.protocolErrors;
+            total.sequenceGaps += stats.sequenceGaps;
+            total.missingMessages += stats.missingMessages;
+            total.suspectSequences += stats.suspectSequences;
+            total.filteredMessages += stats.filteredMessages;
+            total.limitViolations += stats.limitViolations;
+            messages.insert(messages.end(), streamMessages[stream].begin(), streamMessages[stream].end());
+        }
+        total.truncatedBytes = inputSize % ProtocolConstants::MESSAGE_SIZE;
+        total.errorCount += demux.getDemuxStats().unroutedFrames;
+        total.totalTimeUs = demuxTimer.elapsedMicroseconds();
+        total.processingSpeed = total.totalTimeUs > 0 ? total.validMessages * 1'000'000 / total.totalTimeUs : 0;
+        std::cout << MessageFormatter::formatStreamStats(demux);
+    } else if (config.inputPath && config.asyncIo) {
+        // Completed read buffers go straight to the decoder, in file order
+        AsyncReader reader{};
+        Decoder::MessageBuffer batch{messages.get_allocator().resource()};
+        const bool complete = reader.readFiles({*config.inputPath}, [&](std::size_t, const std::uint8_t* data, std::size_t size) {
+            decoder.decodeFeedInto(data, size, batch);
+            deliver(batch);
+        });
+        std::cout << colors::GREEN << "📥 Read " << reader.getStats().bytesRead << " bytes in "
+                  << reader.getStats().reads << " reads via "
+                  << (reader.backend() == AsyncReader::Backend::IO_URING ? "io_uring" : "blocking pread")
+                  << "\n" << colors::RESET;
+        if (!complete) {
+            std::cerr << colors::RED << "❌ Failed to read " << *config.inputPath << "\n" << colors::RESET;
+            if (ring) {
+                TradeRing::unlink(*config.ringSegment);
+            }
+            return 1;
+        }
+    } else if (config.batchMessages == 0 && !ring && !publisher) {
+        decoder.decodeFeedInto(input, inputSize, messages);
+    } else {
+        // Stream the input through one recycled batch buffer; ring readers and subscribers see each batch as it is decoded
+        constexpr std::size_t PUBLISH_BATCH_MESSAGES = 4096;
+        Decoder::MessageBuffer batch{messages.get_allocator().resource()};
+        const std::size_t batchBytes = (config.batchMessages > 0 ? config.batchMessages : PUBLISH_BATCH_MESSAGES)
+                                     * ProtocolConstants::MESSAGE_SIZE;
+        std::size_t position = 0;
+        while (position < inputSize) {
+            const auto consumedBefore = decoder.getCaptureOffset();
+            decoder.decodeFeedInto(input + position, std::min(batchBytes, inputSize - position), batch);
+            deliver(batch);
+            const auto consumed = decoder.getCaptureOffset() - consumedBefore;
+            if (consumed == 0) {
+                break; // Only a partial frame is left
+            }
+            position += static_cast<std::size_t>(consumed);
+        }
+    }
+    decoder.setStatsExporter(nullptr);
+    
+    // Readers drain what is left after close(); unlinking keeps /dev/shm clean, attached readers keep their mapping
+    if (ring) {
+        ring->close();
+        TradeRing::unlink(*config.ringSegment);
+        std::cout << colors::GREEN << "📡 Published " << ring->published() << " trades to ring "
+                  << *config.ringSegment << "\n" << colors::RESET;
+        ring.reset();
+    }
+    if (publisher) {
+        publisher->flush();
+        const auto stats = publisher->getStats();
+        std::cout << colors::GREEN << "📡 Streamed " << stats.messages << " trades in " << stats.batches
+                  << " batches to " << stats.clients << " subscriber(s)\n" << colors::RESET;
+        publisher.reset();   // Lets the event loop drain, then closes every connection
+    }
+    
+    if (traceLogger) {
+        decoder.setTraceLogger(nullptr);
+        traceLogger.reset(); // Drains the ring and closes the file
+        std::cout << colors::GREEN << "📝 Trace written to " << *config.tracePath << "\n" << colors::RESET;
+    }
+    
+    // Stop the background writer, then persist the final state synchronously
+    if (checkpointWriter) {
+        decoder.setCheckpointWriter(nullptr, 0);
+        checkpointWriter.reset();
+        if (!saveCheckpoint(*config.checkpointPath, decoder.captureSnapshot())) {
+            std::cerr << colors::RED << "❌ Failed to write checkpoint " << *config.checkpointPath << "\n" << colors::RESET;
+        }
+    }
     
     // Display results
     std::cout << colors::BOLD << colors::MAGENTA 
@@ -224,9 +921,117 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // Per-symbol bars
+    if (config.showBars) {
+        std::vector<Bar> bars;
+        BarAggregator aggregator{BarAggregator::Config{}, [&bars](const Bar& bar) { bars.push_back(bar); }};
+        aggregator.onTrades(messages);
+        aggregator.flush();
+        
+        std::cout << colors::BOLD << colors::MAGENTA << "\n📊 Bars (" << bars.size() << " emitted)"
+                  << colors::RESET << "\n";
+        const auto barsToShow = std::min(bars.size(), std::size_t{10});
+        for (std::size_t i = 0; i < barsToShow; ++i) {
+            std::cout << MessageFormatter::formatBar(bars[i]) << "\n";
+        }
+    }
+    
+    // Per-symbol distributions
+    if (config.showQuantiles) {
+        QuantileTracker tracker{};
+        tracker.onTrades(messages);
+        tracker.publish();
+        
+        const auto snapshot = tracker.snapshot();
+        std::cout << colors::BOLD << colors::MAGENTA << "\n📐 Quantiles (" << snapshot->symbolCount() << " symbols, "
+                  << snapshot->memoryBytes() / 1024 << " KB of sketches)" << colors::RESET << "\n";
+        for (std::size_t id = 0; id < snapshot->symbolCount(); ++id) {
+            std::cout << MessageFormatter::formatQuantiles(snapshot->tokenAt(id), snapshot->sketchesAt(id)) << "\n";
+        }
+    }
+    
+    // Latest state per symbol, as a slow consumer would see it
+    if (config.showConflated) {
+        Conflator conflator{};
+        const auto reader = conflator.attachReader();
+        conflator.update(messages);
+        
+        std::cout << colors::BOLD << colors::MAGENTA << "\n🧾 Conflated (" << messages.size() << " trades -> "
+                  << conflator.symbolCount() << " symbol updates)" << colors::RESET << "\n";
+        if (reader) {
+            conflator.drain(*reader, [](const Conflator::SymbolState& state) {
+                std::cout << MessageFormatter::formatConflated(state) << "\n";
+            });
+        }
+    }
+    
+    // Real-time index levels
+    if (config.indicesPath) {
+        if (auto definitions = IndexEngine::loadDefinitions(*config.indicesPath)) {
+            IndexEngine engine{*definitions, nullptr};
+            engine.onTrades(messages);
+            
+            std::cout << colors::BOLD << colors::MAGENTA << "\n📈 Indices (" << engine.ticksPublished()
+                      << " ticks published)" << colors::RESET << "\n";
+            for (std::uint32_t id = 0; id < engine.indexCount(); ++id) {
+                std::cout << MessageFormatter::formatIndexLevel(engine.name(id), engine.level(id)) << "\n";
+            }
+        } else {
+            std::cerr << colors::RED << "❌ Failed to load index definitions from " 
+                      << *config.indicesPath << "\n" << colors::RESET;
+        }
+    }
+    
+    // Fan out to per-symbol workers
+    if (config.shardCount > 0) {
+        ShardDispatcher::Config shardConfig{};
+        shardConfig.shardCount = config.shardCount;
+        shardConfig.rebalanceInterval = config.rebalanceShards ? std::max<std::uint64_t>(messages.size() / 10, 1000) : 0;
+        
+        // Each slot is written only by its own shard's worker; stride 8 keeps slots on separate cache lines
+        std::vector<std::uint64_t> volumeByShard(config.shardCount * 8, 0);
+        {
+            ShardDispatcher dispatcher{shardConfig, [&volumeByShard](std::size_t shard, const TradeMessage& msg) {
+                volumeByShard[shard * 8] += msg.quantity;
+            }};
+            const PerformanceMonitor::Timer dispatchTimer{};
+            for (const auto& msg : messages) {
+                dispatcher.dispatch(msg);
+            }
+            // Queue depth only means something before flush() drains every queue
+            const auto backlog = dispatcher.getShardStats();
+            dispatcher.flush();
+            const auto dispatchTime = dispatchTimer.elapsedMicroseconds();
+            
+            auto shardStats = dispatcher.getShardStats();
+            for (std::size_t shard = 0; shard < shardStats.size(); ++shard) {
+                shardStats[shard].queueDepth = backlog[shard].queueDepth;
+            }
+            std::cout << MessageFormatter::formatShardStats(shardStats);
+            std::cout << colors::GREEN << "✅ Dispatched " << messages.size() << " trades to "
+                      << config.shardCount << " shards in " << dispatchTime << " μs\n" << colors::RESET;
+        }
+    }
+    
     // Display comprehensive statistics
     if (config.showStats) {
-        std::cout << MessageFormatter::formatStats(decoder.getStats());
+        std::cout << MessageFormatter::formatStats(mergedStats ? *mergedStats : decoder.getStats());
+        if (arena) {
+            std::cout << MessageFormatter::formatArenaStats(arena->getStats());
+        }
+    }
+    
+    if (config.traceEventsPath) {
+        EventTracer::enable(false);
+        const auto summary = EventTracer::summary();
+        if (EventTracer::exportChromeTrace(*config.traceEventsPath)) {
+            std::cout << colors::GREEN << "🧭 Wrote " << summary.kept << " trace events (" << summary.recorded
+                      << " recorded, " << summary.threads << " threads) to " << *config.traceEventsPath
+                      << "\n" << colors::RESET;
+        } else {
+            std::cerr << colors::RED << "❌ Failed to write trace events to " << *config.traceEventsPath
+                      << "\n" << colors::RESET;
+        }
     }
     
     std::cout << colors::BOLD << colors::GREEN 
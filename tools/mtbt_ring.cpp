@@ -0,0 +1,98 @@
+// Example same-host consumer of the decoder's shared-memory trade ring.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I src tools/mtbt_ring.cpp src/TradeRing.cpp src/MessageTypes.cpp -o build/mtbt_ring
+// Usage: mtbt_ring [--name /nse_mtbt_trades] [--print N] [--wait-ms 10000]
+//
+// Start it before (or while) the decoder runs with --publish-ring: it waits
+// for the segment to appear, reads trades published from then on, and
+// exits once the decoder closes the ring and everything has been read.
+
+#include "TradeRing.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+using nse::mtbt::TradeMessage;
+using nse::mtbt::TradeRing;
+
+struct RingConfig {
+    std::string name{"/nse_mtbt_trades"};
+    std::uint64_t print{0};        // Trades to print before switching to counting only
+    std::uint64_t waitMs{10'000};  // How long to wait for the writer to create the segment
+};
+
+bool parseArguments(int argc, char* argv[], RingConfig& config) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--name" && i + 1 < argc) {
+                config.name = argv[++i];
+            } else if (arg == "--print" && i + 1 < argc) {
+                config.print = std::stoull(argv[++i]);
+            } else if (arg == "--wait-ms" && i + 1 < argc) {
+                config.waitMs = std::stoull(argv[++i]);
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        return false;   // Non-numeric value
+    }
+    return !config.name.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    RingConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--name SEGMENT] [--print N] [--wait-ms N]\n";
+        return 2;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{config.waitMs};
+    auto ring = TradeRing::attach(config.name);
+    while (!ring && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        ring = TradeRing::attach(config.name);
+    }
+    if (!ring) {
+        std::cerr << "No trade ring " << config.name << " (is the decoder running with --publish-ring?)\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t received = 0;
+    std::uint64_t overruns = 0;
+    TradeMessage message;
+    for (;;) {
+        // Read the flag first: once it is set, an empty poll means the stream has ended
+        const bool closed = ring->closed();
+        const auto status = ring->poll(message);
+        if (status == TradeRing::PollResult::MESSAGE) {
+            if (received < config.print) {
+                std::cout << "#" << message.sequenceNumber << " " << message.getSymbolName() << " "
+                          << nse::mtbt::formatTradeSide(message.side) << " " << message.quantity << " @ "
+                          << message.priceInPaisa / 100 << "." << std::setw(2) << std::setfill('0')
+                          << message.priceInPaisa % 100 << std::setfill(' ') << "\n";
+            }
+            ++received;
+        } else if (status == TradeRing::PollResult::OVERRUN) {
+            ++overruns;
+        } else if (closed) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(0) << received << " trades ("
+              << static_cast<double>(received) / seconds << " msgs/s), " << ring->lostMessages()
+              << " lost in " << overruns << " overruns\n";
+    return 0;
+}
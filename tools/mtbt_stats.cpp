@@ -0,0 +1,174 @@
+// Companion monitor for the decoder's shared-memory stats segment.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I src tools/mtbt_stats.cpp src/StatsExport.cpp -o build/mtbt_stats
+// Usage: mtbt_stats [--name /nse_mtbt_stats] [--interval-ms 1000] [--prometheus] [--once]
+
+#include "StatsExport.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+using nse::mtbt::LatencyHistogram;
+using nse::mtbt::StatsExporter;
+using Counter = StatsExporter::Counter;
+
+struct MonitorConfig {
+    std::string name{StatsExporter::DEFAULT_NAME};
+    std::uint64_t intervalMs{1000};
+    bool prometheus{false};
+    bool once{false};
+};
+
+struct MetricInfo {
+    Counter counter;
+    const char* metric;
+    const char* help;
+};
+
+constexpr MetricInfo METRICS[] = {
+    {Counter::DECODED_MESSAGES, "mtbt_decoded_messages_total", "Frames parsed by the decoder"},
+    {Counter::VALID_MESSAGES, "mtbt_valid_messages_total", "Frames that passed validation"},
+    {Counter::ERROR_COUNT, "mtbt_errors_total", "All decoding errors"},
+    {Counter::CRC_ERRORS, "mtbt_crc_errors_total", "Checksum mismatches"},
+    {Counter::PROTOCOL_ERRORS, "mtbt_protocol_errors_total", "Malformed frames"},
+    {Counter::BYTES_PROCESSED, "mtbt_bytes_processed_total", "Input bytes consumed"},
+    {Counter::SEQUENCE_GAPS, "mtbt_sequence_gaps_total", "Sequence discontinuities"},
+    {Counter::MISSING_MESSAGES, "mtbt_missing_messages_total", "Messages lost inside gaps"},
+    {Counter::FILTERED_MESSAGES, "mtbt_filtered_messages_total", "Frames skipped by subscription filter"},
+    {Counter::LIMIT_VIOLATIONS, "mtbt_limit_violations_total", "Trades outside per-instrument limits"},
+    {Counter::BATCHES, "mtbt_batches_total", "Decoded batches"},
+};
+
+constexpr double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+constexpr int TORN_READ_ATTEMPTS = 10;
+
+void printPrometheus(const StatsExporter::Snapshot& snapshot) {
+    for (const auto& info : METRICS) {
+        std::cout << "# HELP " << info.metric << " " << info.help << "\n"
+                  << "# TYPE " << info.metric << " counter\n"
+                  << info.metric << " " << snapshot.get(info.counter) << "\n";
+    }
+    std::cout << "# HELP mtbt_batch_latency_ns Batch decode latency\n"
+              << "# TYPE mtbt_batch_latency_ns summary\n";
+    for (const double q : QUANTILES) {
+        std::cout << "mtbt_batch_latency_ns{quantile=\"" << q << "\"} "
+                  << LatencyHistogram::percentile(snapshot.latencyBuckets, q) << "\n";
+    }
+    std::cout << "mtbt_batch_latency_ns_sum " << snapshot.latencySumNs << "\n"
+              << "mtbt_batch_latency_ns_count " << snapshot.latencyCount << "\n";
+}
+
+void printRates(const StatsExporter::Snapshot& current, const StatsExporter::Snapshot& previous, double seconds) {
+    // A restarted writer re-initializes the segment, so counters can go backwards
+    const auto rate = [&](Counter counter) {
+        const auto now = current.get(counter);
+        const auto before = previous.get(counter);
+        return static_cast<double>(now >= before ? now - before : now) / seconds;
+    };
+    // The two counters are published separately, so a read can see protocol errors the total lacks
+    const auto errors = current.get(Counter::ERROR_COUNT);
+    const auto protocolErrors = current.get(Counter::PROTOCOL_ERRORS);
+    const auto otherErrors = errors >= protocolErrors ? errors - protocolErrors : 0;
+    std::cout << std::fixed << std::setprecision(0)
+              << "msgs/s " << std::setw(10) << rate(Counter::DECODED_MESSAGES)
+              << " | MB/s " << std::setw(7) << std::setprecision(1) << rate(Counter::BYTES_PROCESSED) / 1e6
+              << std::setprecision(0)
+              << " | total " << current.get(Counter::DECODED_MESSAGES)
+              << " | errors crc=" << current.get(Counter::CRC_ERRORS)
+              << " proto=" << protocolErrors
+              << " other=" << otherErrors
+              << " | gaps " << current.get(Counter::SEQUENCE_GAPS)
+              << " | batch ns p50/p99/p999 "
+              << LatencyHistogram::percentile(current.latencyBuckets, 0.5) << "/"
+              << LatencyHistogram::percentile(current.latencyBuckets, 0.99) << "/"
+              << LatencyHistogram::percentile(current.latencyBuckets, 0.999) << "\n";
+}
+
+bool parseArguments(int argc, char* argv[], MonitorConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) {
+            config.name = argv[++i];
+        } else if (arg == "--interval-ms" && i + 1 < argc) {
+            try {
+                config.intervalMs = std::stoull(argv[++i]);
+            } catch (const std::exception&) {
+                return false;
+            }
+        } else if (arg == "--prometheus") {
+            config.prometheus = true;
+        } else if (arg == "--once") {
+            config.once = true;
+        } else {
+            return false;
+        }
+    }
+    return config.intervalMs > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    MonitorConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--name SEGMENT] [--interval-ms N] [--prometheus] [--once]\n";
+        return 2;
+    }
+    
+    auto segment = StatsExporter::attach(config.name);
+    if (!segment) {
+        std::cerr << "No stats segment " << config.name << " (is the decoder running with --export-stats?)\n";
+        return 1;
+    }
+    
+    // A torn read means the writer was mid-update every time we looked: try again shortly
+    auto readConsistent = [&] {
+        auto snapshot = segment->read();
+        for (int attempt = 0; !snapshot && attempt < TORN_READ_ATTEMPTS; ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            snapshot = segment->read();
+        }
+        return snapshot;
+    };
+    
+    auto first = readConsistent();
+    if (!first) {
+        std::cerr << "Could not read a consistent snapshot from " << config.name << "\n";
+        return 1;
+    }
+    auto previous = *first;
+    auto previousTime = std::chrono::steady_clock::now();
+    if (config.once) {
+        if (config.prometheus) {
+            printPrometheus(previous);
+        } else {
+            printRates(previous, StatsExporter::Snapshot{}, 1.0);
+        }
+        return 0;
+    }
+    
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{config.intervalMs});
+        const auto snapshot = readConsistent();
+        if (!snapshot) {
+            continue;   // Skip this interval; rates cover the longer span next time
+        }
+        const auto& current = *snapshot;
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - previousTime).count();
+        
+        if (config.prometheus) {
+            printPrometheus(current);
+        } else {
+            printRates(current, previous, seconds);
+        }
+        std::cout.flush();
+        previous = current;
+        previousTime = now;
+    }
+}
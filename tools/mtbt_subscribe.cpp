@@ -0,0 +1,83 @@
+// Example downstream consumer of the decoder's TCP trade stream.
+//
+// Build: g++ -std=c++17 -O2 -pthread -I src tools/mtbt_subscribe.cpp src/TcpSubscriber.cpp src/MessageTypes.cpp -o build/mtbt_subscribe
+// Usage: mtbt_subscribe [--host 127.0.0.1] [--port 9100] [--print N]
+
+#include "TcpSubscriber.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using nse::mtbt::TcpSubscriber;
+using nse::mtbt::TradeMessage;
+
+struct SubscribeConfig {
+    std::string host{"127.0.0.1"};
+    std::uint16_t port{9100};
+    std::uint64_t print{0};   // Trades to print before switching to counting only
+};
+
+bool parseArguments(int argc, char* argv[], SubscribeConfig& config) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--host" && i + 1 < argc) {
+                config.host = argv[++i];
+            } else if (arg == "--port" && i + 1 < argc) {
+                const auto port = std::stoul(argv[++i]);
+                if (port > 65535) {
+                    return false;
+                }
+                config.port = static_cast<std::uint16_t>(port);
+            } else if (arg == "--print" && i + 1 < argc) {
+                config.print = std::stoull(argv[++i]);
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        return false;   // Non-numeric value
+    }
+    return config.port > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SubscribeConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--host HOST] [--port N] [--print N]\n";
+        return 2;
+    }
+
+    auto subscriber = TcpSubscriber::connect(config.host, config.port);
+    if (!subscriber) {
+        std::cerr << "Could not connect to " << config.host << ":" << config.port
+                  << " (is the decoder running with --publish-tcp?)\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t printed = 0;
+    while (subscriber->connected()) {
+        subscriber->receive([&](const TradeMessage& message) {
+            if (printed < config.print) {
+                std::cout << "#" << message.sequenceNumber << " " << message.getSymbolName() << " "
+                          << nse::mtbt::formatTradeSide(message.side) << " " << message.quantity << " @ "
+                          << message.priceInPaisa / 100 << "." << std::setw(2) << std::setfill('0')
+                          << message.priceInPaisa % 100 << std::setfill(' ') << "\n";
+                ++printed;
+            }
+        });
+    }
+
+    const auto& stats = subscriber->getStats();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(0) << stats.messages << " trades in " << stats.batches << " batches ("
+              << static_cast<double>(stats.messages) / seconds << " msgs/s), batch gaps " << stats.batchGaps
+              << ", protocol errors " << stats.protocolErrors << "\n";
+    return stats.protocolErrors == 0 ? 0 : 1;
+}